@@ -246,3 +246,73 @@ void hisstools_rifft(FFT_SETUP_F setup, FFT_SPLIT_COMPLEX_F *input, float *outpu
     hisstools_rifft(setup, input, log2n);
     hisstools_zip(input, output, log2n);
 }
+
+// Arbitrary Length Transforms (these use the HISSTools code on all platforms)
+
+void hisstools_create_arbitrary_setup(FFT_ARBITRARY_SETUP_D *setup, uintptr_t length)
+{
+    *setup = static_cast<FFT_ARBITRARY_SETUP_D>(hisstools_fft_impl::create_arbitrary_setup<double>(length));
+}
+
+void hisstools_create_arbitrary_setup(FFT_ARBITRARY_SETUP_F *setup, uintptr_t length)
+{
+    *setup = static_cast<FFT_ARBITRARY_SETUP_F>(hisstools_fft_impl::create_arbitrary_setup<float>(length));
+}
+
+void hisstools_destroy_arbitrary_setup(FFT_ARBITRARY_SETUP_D setup)
+{
+    hisstools_fft_impl::destroy_arbitrary_setup(setup);
+}
+
+void hisstools_destroy_arbitrary_setup(FFT_ARBITRARY_SETUP_F setup)
+{
+    hisstools_fft_impl::destroy_arbitrary_setup(setup);
+}
+
+void hisstools_fft(FFT_ARBITRARY_SETUP_D setup, FFT_SPLIT_COMPLEX_D *input)
+{
+    Split<double> io(input->realp, input->imagp);
+    hisstools_fft_impl::hisstools_fft(&io, setup);
+}
+
+void hisstools_fft(FFT_ARBITRARY_SETUP_F setup, FFT_SPLIT_COMPLEX_F *input)
+{
+    Split<float> io(input->realp, input->imagp);
+    hisstools_fft_impl::hisstools_fft(&io, setup);
+}
+
+void hisstools_ifft(FFT_ARBITRARY_SETUP_D setup, FFT_SPLIT_COMPLEX_D *input)
+{
+    Split<double> io(input->realp, input->imagp);
+    hisstools_fft_impl::hisstools_ifft(&io, setup);
+}
+
+void hisstools_ifft(FFT_ARBITRARY_SETUP_F setup, FFT_SPLIT_COMPLEX_F *input)
+{
+    Split<float> io(input->realp, input->imagp);
+    hisstools_fft_impl::hisstools_ifft(&io, setup);
+}
+
+void hisstools_rfft(FFT_ARBITRARY_SETUP_D setup, const double *input, FFT_SPLIT_COMPLEX_D *output, uintptr_t in_length)
+{
+    Split<double> out(output->realp, output->imagp);
+    hisstools_fft_impl::hisstools_rfft(input, &out, setup, in_length);
+}
+
+void hisstools_rfft(FFT_ARBITRARY_SETUP_F setup, const float *input, FFT_SPLIT_COMPLEX_F *output, uintptr_t in_length)
+{
+    Split<float> out(output->realp, output->imagp);
+    hisstools_fft_impl::hisstools_rfft(input, &out, setup, in_length);
+}
+
+void hisstools_rifft(FFT_ARBITRARY_SETUP_D setup, FFT_SPLIT_COMPLEX_D *input, double *output)
+{
+    Split<double> in(input->realp, input->imagp);
+    hisstools_fft_impl::hisstools_rifft(&in, output, setup);
+}
+
+void hisstools_rifft(FFT_ARBITRARY_SETUP_F setup, FFT_SPLIT_COMPLEX_F *input, float *output)
+{
+    Split<float> in(input->realp, input->imagp);
+    hisstools_fft_impl::hisstools_rifft(&in, output, setup);
+}
@@ -75,6 +75,18 @@ typedef FloatSplit FFT_SPLIT_COMPLEX_F;
 
 #endif
 
+/**
+    FFT_ARBITRARY_SETUP_D is an opaque setup structure for a double-precision FFT of a specific (arbitrary) length.
+ */
+
+typedef struct DoubleArbitrarySetup *FFT_ARBITRARY_SETUP_D;
+
+/**
+    FFT_ARBITRARY_SETUP_F is an opaque setup structure for a single-precision FFT of a specific (arbitrary) length.
+ */
+
+typedef struct FloatArbitrarySetup *FFT_ARBITRARY_SETUP_F;
+
 /**
     hisstools_create_setup() creates an FFT setup suitable for double-precision FFTs and iFFTs up to a maximum specified size.
  
@@ -368,5 +380,125 @@ void hisstools_zip(const FFT_SPLIT_COMPLEX_D *input, double *output, uintptr_t l
 
 void hisstools_zip(const FFT_SPLIT_COMPLEX_F *input, float *output, uintptr_t log2n);
 
+/**
+    hisstools_create_arbitrary_setup() creates a setup for double-precision FFTs and iFFTs of a specific length.
+
+	@param	setup           A pointer to an uninitialised FFT_ARBITRARY_SETUP_D.
+	@param	length          The length of complex transforms (real transforms are of twice this length).
+
+	@remark             Lengths of the form 2^a 3^b 5^c use mixed radix transforms. Other lengths use Bluestein's algorithm, which is several times slower. The setup contains working memory and so should only be used by one thread at a time. If allocation fails the setup is set to null.
+ */
+
+void hisstools_create_arbitrary_setup(FFT_ARBITRARY_SETUP_D *setup, uintptr_t length);
+
+/**
+    hisstools_create_arbitrary_setup() creates a setup for single-precision FFTs and iFFTs of a specific length.
+
+	@param	setup           A pointer to an uninitialised FFT_ARBITRARY_SETUP_F.
+	@param	length          The length of complex transforms (real transforms are of twice this length).
+
+	@remark             Lengths of the form 2^a 3^b 5^c use mixed radix transforms. Other lengths use Bluestein's algorithm, which is several times slower. The setup contains working memory and so should only be used by one thread at a time. If allocation fails the setup is set to null.
+ */
+
+void hisstools_create_arbitrary_setup(FFT_ARBITRARY_SETUP_F *setup, uintptr_t length);
+
+/**
+    hisstools_destroy_arbitrary_setup() destroys a double-precision arbitrary length setup.
+
+	@param	setup		A FFT_ARBITRARY_SETUP_D.
+ */
+
+void hisstools_destroy_arbitrary_setup(FFT_ARBITRARY_SETUP_D setup);
+
+/**
+    hisstools_destroy_arbitrary_setup() destroys a single-precision arbitrary length setup.
+
+	@param	setup		A FFT_ARBITRARY_SETUP_F.
+ */
+
+void hisstools_destroy_arbitrary_setup(FFT_ARBITRARY_SETUP_F setup);
+
+/**
+    hisstools_fft() performs an in-place complex Fast Fourier Transform of the length of the setup.
+
+	@param	setup		A FFT_ARBITRARY_SETUP_D.
+	@param	input		A pointer to a FFT_SPLIT_COMPLEX_D structure containing the complex input.
+ */
+
+void hisstools_fft(FFT_ARBITRARY_SETUP_D setup, FFT_SPLIT_COMPLEX_D *input);
+
+/**
+    hisstools_fft() performs an in-place complex Fast Fourier Transform of the length of the setup.
+
+	@param	setup		A FFT_ARBITRARY_SETUP_F.
+	@param	input		A pointer to a FFT_SPLIT_COMPLEX_F structure containing the complex input.
+ */
+
+void hisstools_fft(FFT_ARBITRARY_SETUP_F setup, FFT_SPLIT_COMPLEX_F *input);
+
+/**
+    hisstools_ifft() performs an in-place complex inverse Fast Fourier Transform of the length of the setup (without scaling).
+
+	@param	setup		A FFT_ARBITRARY_SETUP_D.
+	@param	input		A pointer to a FFT_SPLIT_COMPLEX_D structure containing the complex input.
+ */
+
+void hisstools_ifft(FFT_ARBITRARY_SETUP_D setup, FFT_SPLIT_COMPLEX_D *input);
+
+/**
+    hisstools_ifft() performs an in-place complex inverse Fast Fourier Transform of the length of the setup (without scaling).
+
+	@param	setup		A FFT_ARBITRARY_SETUP_F.
+	@param	input		A pointer to a FFT_SPLIT_COMPLEX_F structure containing the complex input.
+ */
+
+void hisstools_ifft(FFT_ARBITRARY_SETUP_F setup, FFT_SPLIT_COMPLEX_F *input);
+
+/**
+    hisstools_rfft() performs an out-of-place real Fast Fourier Transform of twice the length of the setup.
+
+	@param	setup		A FFT_ARBITRARY_SETUP_D.
+	@param	input		A pointer to the real double-precision input.
+	@param	output		A pointer to a FFT_SPLIT_COMPLEX_D structure which will hold the length + 1 output bins.
+	@param	in_length	The length of the input (which is zero-padded to twice the length of the setup).
+
+	@remark             Unlike the power of two real FFT the output is not packed and is not scaled by two.
+ */
+
+void hisstools_rfft(FFT_ARBITRARY_SETUP_D setup, const double *input, FFT_SPLIT_COMPLEX_D *output, uintptr_t in_length);
+
+/**
+    hisstools_rfft() performs an out-of-place real Fast Fourier Transform of twice the length of the setup.
+
+	@param	setup		A FFT_ARBITRARY_SETUP_F.
+	@param	input		A pointer to the real single-precision input.
+	@param	output		A pointer to a FFT_SPLIT_COMPLEX_F structure which will hold the length + 1 output bins.
+	@param	in_length	The length of the input (which is zero-padded to twice the length of the setup).
+
+	@remark             Unlike the power of two real FFT the output is not packed and is not scaled by two.
+ */
+
+void hisstools_rfft(FFT_ARBITRARY_SETUP_F setup, const float *input, FFT_SPLIT_COMPLEX_F *output, uintptr_t in_length);
+
+/**
+    hisstools_rifft() performs an out-of-place inverse real Fast Fourier Transform of twice the length of the setup (without scaling).
+
+	@param	setup		A FFT_ARBITRARY_SETUP_D.
+	@param	input		A pointer to a FFT_SPLIT_COMPLEX_D structure holding length + 1 input bins (which is used as working memory).
+	@param	output		A pointer to the real double-precision output.
+ */
+
+void hisstools_rifft(FFT_ARBITRARY_SETUP_D setup, FFT_SPLIT_COMPLEX_D *input, double *output);
+
+/**
+    hisstools_rifft() performs an out-of-place inverse real Fast Fourier Transform of twice the length of the setup (without scaling).
+
+	@param	setup		A FFT_ARBITRARY_SETUP_F.
+	@param	input		A pointer to a FFT_SPLIT_COMPLEX_F structure holding length + 1 input bins (which is used as working memory).
+	@param	output		A pointer to the real single-precision output.
+ */
+
+void hisstools_rifft(FFT_ARBITRARY_SETUP_F setup, FFT_SPLIT_COMPLEX_F *input, float *output);
+
 #endif
 
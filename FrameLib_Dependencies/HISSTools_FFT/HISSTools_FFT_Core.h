@@ -35,6 +35,32 @@ struct Setup
 struct DoubleSetup : public Setup<double> {};
 struct FloatSetup : public Setup<float> {};
 
+// Arbitrary length setups (these include working memory, so must only be used by one thread at a time)
+
+template <class T>
+struct ArbitrarySetup
+{
+    uintptr_t length;
+    uintptr_t num_factors;
+    uintptr_t factors[64];
+    Split<T> twiddles;
+    Split<T> real_twiddles;
+    Split<T> scratch;
+    
+    // A power of two setup (used directly for power of two lengths or for Bluestein's algorithm)
+    
+    Setup<T> *fft_setup;
+    uintptr_t fft_log2;
+    
+    // Bluestein's algorithm (for lengths with prime factors other than 2, 3 and 5)
+    
+    Split<T> chirp;
+    Split<T> chirp_spectrum;
+};
+
+struct DoubleArbitrarySetup : public ArbitrarySetup<double> {};
+struct FloatArbitrarySetup : public ArbitrarySetup<float> {};
+
 namespace hisstools_fft_impl{
     
     template<class T> struct SIMDLimits     { static const int max_size = 1;};
@@ -60,6 +86,10 @@ namespace hisstools_fft_impl{
 
 #endif
     
+    // Alignment required for the widest vectors in use (at least 16 bytes)
+    
+    static const size_t alignment_size = SIMDLimits<float>::max_size * sizeof(float) > 16 ? SIMDLimits<float>::max_size * sizeof(float) : 16;
+    
 // Aligned Allocation
 
 #if defined(__APPLE__)
@@ -67,7 +97,17 @@ namespace hisstools_fft_impl{
     template <class T>
     T *allocate_aligned(size_t size)
     {
-        return static_cast<T *>(malloc(size * sizeof(T)));
+        // N.B. malloc only guarantees 16 byte alignment which is insufficient for wider vectors
+        
+        if (alignment_size <= 16)
+            return static_cast<T *>(malloc(size * sizeof(T)));
+        
+        void *mem = nullptr;
+        
+        if (posix_memalign(&mem, alignment_size, size * sizeof(T)))
+            return nullptr;
+        
+        return static_cast<T *>(mem);
     }
     
 #elif defined(__linux__)
@@ -75,8 +115,13 @@ namespace hisstools_fft_impl{
     template <class T>
     T *allocate_aligned(size_t size)
     {
-        void *mem;
-        posix_memalign(&mem, SIMDLimits<T>::max_size * sizeof(T), size * sizeof(T));
+        // N.B. the alignment must be a power of two (and a multiple of the pointer size) even for the setup structures
+        
+        void *mem = nullptr;
+        
+        if (posix_memalign(&mem, std::max(sizeof(void *), alignment_size), size * sizeof(T)))
+            return nullptr;
+        
         return static_cast<T *>(mem);
     }
     
@@ -93,7 +138,7 @@ namespace hisstools_fft_impl{
     template <class T>
     T *allocate_aligned(size_t size)
     {
-        return static_cast<T *>(_aligned_malloc(size * sizeof(T), 16));
+        return static_cast<T *>(_aligned_malloc(size * sizeof(T), alignment_size));
     }
     
 #endif
@@ -113,7 +158,7 @@ namespace hisstools_fft_impl{
 #endif
     
     template <class T>
-    bool is_aligned(const T *ptr) { return !(reinterpret_cast<uintptr_t>(ptr) % 16); }
+    bool is_aligned(const T *ptr) { return !(reinterpret_cast<uintptr_t>(ptr) % alignment_size); }
     
     // Offset for Table
     
@@ -195,8 +240,8 @@ namespace hisstools_fft_impl{
         
         static void deinterleave(const SIMDVector *input, SIMDVector *outReal, SIMDVector *outImag)
         {
-            *outReal = _mm_unpacklo_ps(input[0].mVal, input[1].mVal);
-            *outImag = _mm_unpackhi_ps(input[0].mVal, input[1].mVal);
+            *outReal = _mm_shuffle_ps(input[0].mVal, input[1].mVal, _MM_SHUFFLE(2, 0, 2, 0));
+            *outImag = _mm_shuffle_ps(input[0].mVal, input[1].mVal, _MM_SHUFFLE(3, 1, 3, 1));
         }
         
         static void interleave(const SIMDVector *inReal, const SIMDVector *inImag, SIMDVector *output)
@@ -249,14 +294,20 @@ namespace hisstools_fft_impl{
         
         static void deinterleave(const SIMDVector *input, SIMDVector *outReal, SIMDVector *outImag)
         {
-            *outReal = _mm256_unpacklo_ps(input[0].mVal, input[1].mVal);
-            *outImag = _mm256_unpackhi_ps(input[0].mVal, input[1].mVal);
+            const __m256 v1 = _mm256_permute2f128_ps(input[0].mVal, input[1].mVal, 0x20);
+            const __m256 v2 = _mm256_permute2f128_ps(input[0].mVal, input[1].mVal, 0x31);
+            
+            *outReal = _mm256_shuffle_ps(v1, v2, _MM_SHUFFLE(2, 0, 2, 0));
+            *outImag = _mm256_shuffle_ps(v1, v2, _MM_SHUFFLE(3, 1, 3, 1));
         }
         
         static void interleave(const SIMDVector *inReal, const SIMDVector *inImag, SIMDVector *output)
         {
-            output[0] = _mm256_unpacklo_ps(inReal->mVal, inImag->mVal);
-            output[1] = _mm256_unpackhi_ps(inReal->mVal, inImag->mVal);
+            const __m256 v1 = _mm256_unpacklo_ps(inReal->mVal, inImag->mVal);
+            const __m256 v2 = _mm256_unpackhi_ps(inReal->mVal, inImag->mVal);
+            
+            output[0] = _mm256_permute2f128_ps(v1, v2, 0x20);
+            output[1] = _mm256_permute2f128_ps(v1, v2, 0x31);
         }
     };
     
@@ -275,14 +326,14 @@ namespace hisstools_fft_impl{
         
         static void deinterleave(const SIMDVector *input, SIMDVector *outReal, SIMDVector *outImag)
         {
-            *outReal = _mm512_unpacklo_pd(input[0].mVal, input[1].mVal);
-            *outImag = _mm512_unpackhi_pd(input[0].mVal, input[1].mVal);
+            *outReal = _mm512_permutex2var_pd(input[0].mVal, _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0), input[1].mVal);
+            *outImag = _mm512_permutex2var_pd(input[0].mVal, _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1), input[1].mVal);
         }
         
         static void interleave(const SIMDVector *inReal, const SIMDVector *inImag, SIMDVector *output)
         {
-            output[0] = _mm512_unpacklo_pd(inReal->mVal, inImag->mVal);
-            output[1] = _mm512_unpackhi_pd(inReal->mVal, inImag->mVal);
+            output[0] = _mm512_permutex2var_pd(inReal->mVal, _mm512_set_epi64(11, 3, 10, 2, 9, 1, 8, 0), inImag->mVal);
+            output[1] = _mm512_permutex2var_pd(inReal->mVal, _mm512_set_epi64(15, 7, 14, 6, 13, 5, 12, 4), inImag->mVal);
         }
     };
     
@@ -297,14 +348,14 @@ namespace hisstools_fft_impl{
         
         static void deinterleave(const SIMDVector *input, SIMDVector *outReal, SIMDVector *outImag)
         {
-            *outReal = _mm512_unpacklo_ps(input[0].mVal, input[1].mVal);
-            *outImag = _mm512_unpackhi_ps(input[0].mVal, input[1].mVal);
+            *outReal = _mm512_permutex2var_ps(input[0].mVal, _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16, 14, 12, 10, 8, 6, 4, 2, 0), input[1].mVal);
+            *outImag = _mm512_permutex2var_ps(input[0].mVal, _mm512_set_epi32(31, 29, 27, 25, 23, 21, 19, 17, 15, 13, 11, 9, 7, 5, 3, 1), input[1].mVal);
         }
         
         static void interleave(const SIMDVector *inReal, const SIMDVector *inImag, SIMDVector *output)
         {
-            output[0] = _mm512_unpacklo_ps(inReal->mVal, inImag->mVal);
-            output[1] = _mm512_unpackhi_ps(inReal->mVal, inImag->mVal);
+            output[0] = _mm512_permutex2var_ps(inReal->mVal, _mm512_set_epi32(23, 7, 22, 6, 21, 5, 20, 4, 19, 3, 18, 2, 17, 1, 16, 0), inImag->mVal);
+            output[1] = _mm512_permutex2var_ps(inReal->mVal, _mm512_set_epi32(31, 15, 30, 14, 29, 13, 28, 12, 27, 11, 26, 10, 25, 9, 24, 8), inImag->mVal);
         }
     };
     
@@ -405,6 +456,11 @@ namespace hisstools_fft_impl{
     
     // ******************** Setup Creation and Destruction ******************** //
     
+    // Destruction is declared first so that creation can clean up after allocation failures
+    
+    template <class T>
+    void destroy_setup(Setup<T> *setup);
+    
     // Creation
     
     template <class T>
@@ -412,6 +468,9 @@ namespace hisstools_fft_impl{
     {
         Setup<T> *setup = allocate_aligned<Setup<T>>(1);
         
+        if (!setup)
+            return nullptr;
+        
         // Set Max FFT Size
         
         setup->max_fft_log2 = max_fft_log2;
@@ -423,6 +482,16 @@ namespace hisstools_fft_impl{
             uintptr_t length = static_cast<uintptr_t>(1u) << (i - 1u);
             
             setup->tables[i - trig_table_offset].realp = allocate_aligned<T>(2 * length);
+            
+            // On failure only the tables already allocated are freed
+            
+            if (!setup->tables[i - trig_table_offset].realp)
+            {
+                setup->max_fft_log2 = i - 1;
+                destroy_setup(setup);
+                return nullptr;
+            }
+            
             setup->tables[i - trig_table_offset].imagp = setup->tables[i - trig_table_offset].realp + length;
             
             // Fill the Table
@@ -1369,4 +1438,526 @@ namespace hisstools_fft_impl{
             small_real_fft<true>(input, fft_log2);
     }
     
+    // ******************** Arbitrary Length Transforms ******************** //
+    
+    // Lengths of the form 2^a 3^b 5^c use mixed radix Stockham passes (which require no reordering)
+    // Lengths with other prime factors use Bluestein's algorithm via a power of two FFT
+    
+    // Split Allocation
+    
+    template <class T>
+    Split<T> allocate_split(uintptr_t length)
+    {
+        T *ptr = allocate_aligned<T>(2 * length);
+        return ptr ? Split<T>(ptr, ptr + length) : Split<T>(nullptr, nullptr);
+    }
+    
+    template <class T>
+    void deallocate_split(Split<T>& split)
+    {
+        if (split.realp)
+            deallocate_aligned(split.realp);
+    }
+    
+    // Butterflies (forward direction)
+    
+    template <class T, int P>
+    struct arbitrary_butterfly {};
+    
+    template <class T>
+    struct arbitrary_butterfly<T, 2>
+    {
+        static void apply(T *r, T *i)
+        {
+            const T r0 = r[0], i0 = i[0];
+            
+            r[0] = r0 + r[1];
+            i[0] = i0 + i[1];
+            r[1] = r0 - r[1];
+            i[1] = i0 - i[1];
+        }
+    };
+    
+    template <class T>
+    struct arbitrary_butterfly<T, 3>
+    {
+        static void apply(T *r, T *i)
+        {
+            const T c = static_cast<T>(0.86602540378443864676372317075293618);
+            
+            const T r1 = r[1] + r[2];
+            const T i1 = i[1] + i[2];
+            const T r2 = r[0] - static_cast<T>(0.5) * r1;
+            const T i2 = i[0] - static_cast<T>(0.5) * i1;
+            const T r3 = c * (i[1] - i[2]);
+            const T i3 = c * (r[2] - r[1]);
+            
+            r[0] = r[0] + r1;
+            i[0] = i[0] + i1;
+            r[1] = r2 + r3;
+            i[1] = i2 + i3;
+            r[2] = r2 - r3;
+            i[2] = i2 - i3;
+        }
+    };
+    
+    template <class T>
+    struct arbitrary_butterfly<T, 4>
+    {
+        static void apply(T *r, T *i)
+        {
+            const T r0 = r[0] + r[2];
+            const T i0 = i[0] + i[2];
+            const T r1 = r[0] - r[2];
+            const T i1 = i[0] - i[2];
+            const T r2 = r[1] + r[3];
+            const T i2 = i[1] + i[3];
+            const T r3 = i[1] - i[3];
+            const T i3 = r[3] - r[1];
+            
+            r[0] = r0 + r2;
+            i[0] = i0 + i2;
+            r[1] = r1 + r3;
+            i[1] = i1 + i3;
+            r[2] = r0 - r2;
+            i[2] = i0 - i2;
+            r[3] = r1 - r3;
+            i[3] = i1 - i3;
+        }
+    };
+    
+    template <class T>
+    struct arbitrary_butterfly<T, 5>
+    {
+        static void apply(T *r, T *i)
+        {
+            const T c1 = static_cast<T>(0.30901699437494742410229341718281906);
+            const T c2 = static_cast<T>(-0.80901699437494742410229341718281906);
+            const T s1 = static_cast<T>(0.95105651629515357211643933337938214);
+            const T s2 = static_cast<T>(0.58778525229247312916870595463907277);
+            
+            const T r1 = r[1] + r[4];
+            const T i1 = i[1] + i[4];
+            const T r2 = r[2] + r[3];
+            const T i2 = i[2] + i[3];
+            const T r3 = r[1] - r[4];
+            const T i3 = i[1] - i[4];
+            const T r4 = r[2] - r[3];
+            const T i4 = i[2] - i[3];
+            
+            const T m1r = r[0] + c1 * r1 + c2 * r2;
+            const T m1i = i[0] + c1 * i1 + c2 * i2;
+            const T m2r = r[0] + c2 * r1 + c1 * r2;
+            const T m2i = i[0] + c2 * i1 + c1 * i2;
+            const T n1r = s1 * r3 + s2 * r4;
+            const T n1i = s1 * i3 + s2 * i4;
+            const T n2r = s2 * r3 - s1 * r4;
+            const T n2i = s2 * i3 - s1 * i4;
+            
+            r[0] = r[0] + r1 + r2;
+            i[0] = i[0] + i1 + i2;
+            r[1] = m1r + n1i;
+            i[1] = m1i - n1r;
+            r[2] = m2r + n2i;
+            i[2] = m2i - n2r;
+            r[3] = m2r - n2i;
+            i[3] = m2i + n2r;
+            r[4] = m1r - n1i;
+            i[4] = m1i + n1r;
+        }
+    };
+    
+    // A Single Stockham Pass (the twiddle for output j of sub-transform q is at index q * j * stride)
+    
+    template <class T, int P>
+    void arbitrary_pass(const Split<T>& input, const Split<T>& output, const Split<T>& twiddles, uintptr_t m, uintptr_t stride)
+    {
+        T r[P], i[P], w_r[P], w_i[P];
+        
+        for (uintptr_t q = 0; q < m; q++)
+        {
+            for (int j = 1; j < P; j++)
+            {
+                w_r[j] = twiddles.realp[q * j * stride];
+                w_i[j] = twiddles.imagp[q * j * stride];
+            }
+            
+            for (uintptr_t k = 0; k < stride; k++)
+            {
+                for (int j = 0; j < P; j++)
+                {
+                    r[j] = input.realp[k + stride * (q + m * j)];
+                    i[j] = input.imagp[k + stride * (q + m * j)];
+                }
+                
+                arbitrary_butterfly<T, P>::apply(r, i);
+                
+                output.realp[k + stride * P * q] = r[0];
+                output.imagp[k + stride * P * q] = i[0];
+                
+                for (int j = 1; j < P; j++)
+                {
+                    output.realp[k + stride * (P * q + j)] = r[j] * w_r[j] - i[j] * w_i[j];
+                    output.imagp[k + stride * (P * q + j)] = r[j] * w_i[j] + i[j] * w_r[j];
+                }
+            }
+        }
+    }
+    
+    // Mixed Radix FFT
+    
+    template <class T>
+    void mixed_radix_fft(Split<T> *io, ArbitrarySetup<T> *setup)
+    {
+        Split<T> input = *io;
+        Split<T> output = setup->scratch;
+        uintptr_t m = setup->length;
+        uintptr_t stride = 1;
+        
+        for (uintptr_t i = 0; i < setup->num_factors; i++)
+        {
+            const uintptr_t p = setup->factors[i];
+            
+            m /= p;
+            
+            switch (p)
+            {
+                case 2:     arbitrary_pass<T, 2>(input, output, setup->twiddles, m, stride);    break;
+                case 3:     arbitrary_pass<T, 3>(input, output, setup->twiddles, m, stride);    break;
+                case 4:     arbitrary_pass<T, 4>(input, output, setup->twiddles, m, stride);    break;
+                case 5:     arbitrary_pass<T, 5>(input, output, setup->twiddles, m, stride);    break;
+            }
+            
+            stride *= p;
+            std::swap(input, output);
+        }
+        
+        if (input.realp != io->realp)
+        {
+            std::copy(input.realp, input.realp + setup->length, io->realp);
+            std::copy(input.imagp, input.imagp + setup->length, io->imagp);
+        }
+    }
+    
+    // Bluestein FFT (the chirp spectrum is pre-scaled to account for the unnormalised inverse)
+    
+    template <class T>
+    void bluestein_fft(Split<T> *io, ArbitrarySetup<T> *setup)
+    {
+        const uintptr_t length = setup->length;
+        const uintptr_t fft_size = static_cast<uintptr_t>(1u) << setup->fft_log2;
+        
+        Split<T> &a = setup->scratch;
+        const Split<T> &c = setup->chirp;
+        const Split<T> &b = setup->chirp_spectrum;
+        
+        for (uintptr_t i = 0; i < length; i++)
+        {
+            const T r = io->realp[i];
+            
+            a.realp[i] = r * c.realp[i] - io->imagp[i] * c.imagp[i];
+            a.imagp[i] = r * c.imagp[i] + io->imagp[i] * c.realp[i];
+        }
+        
+        std::fill_n(a.realp + length, fft_size - length, static_cast<T>(0));
+        std::fill_n(a.imagp + length, fft_size - length, static_cast<T>(0));
+        
+        hisstools_fft(&a, setup->fft_setup, setup->fft_log2);
+        
+        for (uintptr_t i = 0; i < fft_size; i++)
+        {
+            const T r = a.realp[i];
+            
+            a.realp[i] = r * b.realp[i] - a.imagp[i] * b.imagp[i];
+            a.imagp[i] = r * b.imagp[i] + a.imagp[i] * b.realp[i];
+        }
+        
+        hisstools_ifft(&a, setup->fft_setup, setup->fft_log2);
+        
+        for (uintptr_t i = 0; i < length; i++)
+        {
+            io->realp[i] = a.realp[i] * c.realp[i] - a.imagp[i] * c.imagp[i];
+            io->imagp[i] = a.realp[i] * c.imagp[i] + a.imagp[i] * c.realp[i];
+        }
+    }
+    
+    template <class T>
+    void destroy_arbitrary_setup(ArbitrarySetup<T> *setup);
+    
+    // Setup Creation
+    
+    template <class T>
+    ArbitrarySetup<T> *create_arbitrary_setup(uintptr_t length)
+    {
+        static const double pi = 3.14159265358979323846264338327950288;
+        
+        ArbitrarySetup<T> *setup = allocate_aligned<ArbitrarySetup<T>>(1);
+        
+        if (!setup)
+            return nullptr;
+        
+        uintptr_t remainder = length = std::max(length, static_cast<uintptr_t>(1u));
+        
+        setup->length = length;
+        setup->num_factors = 0;
+        setup->real_twiddles = Split<T>(nullptr, nullptr);
+        setup->twiddles = Split<T>(nullptr, nullptr);
+        setup->scratch = Split<T>(nullptr, nullptr);
+        setup->fft_setup = nullptr;
+        setup->fft_log2 = 0;
+        setup->chirp = Split<T>(nullptr, nullptr);
+        setup->chirp_spectrum = Split<T>(nullptr, nullptr);
+        
+        // Factorise (largest radix first)
+        
+        const uintptr_t radices[] = { 4, 2, 3, 5 };
+        
+        for (uintptr_t i = 0; i < 4; i++)
+        {
+            while (!(remainder % radices[i]))
+            {
+                setup->factors[setup->num_factors++] = radices[i];
+                remainder /= radices[i];
+            }
+        }
+        
+        // Real twiddles for transforms of twice the length
+        
+        setup->real_twiddles = allocate_split<T>(length);
+        
+        if (!setup->real_twiddles.realp)
+        {
+            destroy_arbitrary_setup(setup);
+            return nullptr;
+        }
+        
+        for (uintptr_t i = 0; i < length; i++)
+        {
+            double angle = -(static_cast<double>(i)) * pi / static_cast<double>(length);
+            
+            setup->real_twiddles.realp[i] = static_cast<T>(cos(angle));
+            setup->real_twiddles.imagp[i] = static_cast<T>(sin(angle));
+        }
+        
+        if (!(length & (length - 1)))
+        {
+            // Power of two lengths use the standard FFT
+            
+            while ((static_cast<uintptr_t>(1u) << setup->fft_log2) < length)
+                setup->fft_log2++;
+            
+            setup->fft_setup = create_setup<T>(setup->fft_log2);
+            
+            if (!setup->fft_setup)
+            {
+                destroy_arbitrary_setup(setup);
+                return nullptr;
+            }
+        }
+        else if (remainder == 1)
+        {
+            setup->twiddles = allocate_split<T>(length);
+            setup->scratch = allocate_split<T>(length);
+            
+            if (!setup->twiddles.realp || !setup->scratch.realp)
+            {
+                destroy_arbitrary_setup(setup);
+                return nullptr;
+            }
+            
+            for (uintptr_t i = 0; i < length; i++)
+            {
+                double angle = -(static_cast<double>(i)) * 2.0 * pi / static_cast<double>(length);
+                
+                setup->twiddles.realp[i] = static_cast<T>(cos(angle));
+                setup->twiddles.imagp[i] = static_cast<T>(sin(angle));
+            }
+        }
+        else
+        {
+            // Bluestein's algorithm (the chirp is exp(-i * pi * n^2 / length) with n^2 reduced to avoid loss of precision)
+            
+            while ((static_cast<uintptr_t>(1u) << setup->fft_log2) < (2 * length - 1))
+                setup->fft_log2++;
+            
+            const uintptr_t fft_size = static_cast<uintptr_t>(1u) << setup->fft_log2;
+            
+            setup->fft_setup = create_setup<T>(setup->fft_log2);
+            setup->scratch = allocate_split<T>(fft_size);
+            setup->chirp = allocate_split<T>(length);
+            setup->chirp_spectrum = allocate_split<T>(fft_size);
+            
+            if (!setup->fft_setup || !setup->scratch.realp || !setup->chirp.realp || !setup->chirp_spectrum.realp)
+            {
+                destroy_arbitrary_setup(setup);
+                return nullptr;
+            }
+            
+            Split<T> &b = setup->chirp_spectrum;
+            
+            std::fill_n(b.realp, fft_size, static_cast<T>(0));
+            std::fill_n(b.imagp, fft_size, static_cast<T>(0));
+            
+            for (uintptr_t i = 0; i < length; i++)
+            {
+                unsigned long long square = (static_cast<unsigned long long>(i) * i) % (2ULL * length);
+                double angle = -(static_cast<double>(square)) * pi / static_cast<double>(length);
+                
+                setup->chirp.realp[i] = static_cast<T>(cos(angle));
+                setup->chirp.imagp[i] = static_cast<T>(sin(angle));
+                
+                // The filter is the conjugate chirp (symmetrical around zero)
+                
+                b.realp[i] = static_cast<T>(cos(angle));
+                b.imagp[i] = static_cast<T>(-sin(angle));
+                
+                if (i)
+                {
+                    b.realp[fft_size - i] = b.realp[i];
+                    b.imagp[fft_size - i] = b.imagp[i];
+                }
+            }
+            
+            hisstools_fft(&b, setup->fft_setup, setup->fft_log2);
+            
+            const T scale = static_cast<T>(1.0 / static_cast<double>(fft_size));
+            
+            for (uintptr_t i = 0; i < fft_size; i++)
+            {
+                b.realp[i] *= scale;
+                b.imagp[i] *= scale;
+            }
+        }
+        
+        return setup;
+    }
+    
+    // Setup Destruction
+    
+    template <class T>
+    void destroy_arbitrary_setup(ArbitrarySetup<T> *setup)
+    {
+        if (setup)
+        {
+            deallocate_split(setup->twiddles);
+            deallocate_split(setup->real_twiddles);
+            deallocate_split(setup->scratch);
+            deallocate_split(setup->chirp);
+            deallocate_split(setup->chirp_spectrum);
+            destroy_setup(setup->fft_setup);
+            deallocate_aligned(setup);
+        }
+    }
+    
+    // A Complex FFT of Arbitrary Length
+    
+    template <class T>
+    void hisstools_fft(Split<T> *input, ArbitrarySetup<T> *setup)
+    {
+        if (setup->chirp.realp)
+            bluestein_fft(input, setup);
+        else if (setup->fft_setup)
+            hisstools_fft(input, setup->fft_setup, setup->fft_log2);
+        else
+            mixed_radix_fft(input, setup);
+    }
+    
+    // A Complex iFFT of Arbitrary Length
+    
+    template <class T>
+    void hisstools_ifft(Split<T> *input, ArbitrarySetup<T> *setup)
+    {
+        Split<T> swap(input->imagp, input->realp);
+        hisstools_fft(&swap, setup);
+    }
+    
+    // A Real FFT of twice the setup length (the output holds length + 1 bins with no packing)
+    
+    template <class T, class U>
+    void hisstools_rfft(const U *input, Split<T> *output, ArbitrarySetup<T> *setup, uintptr_t in_length)
+    {
+        const uintptr_t length = setup->length;
+        const Split<T> &w = setup->real_twiddles;
+        
+        // Unzip with zero padding
+        
+        for (uintptr_t i = 0; i < length; i++)
+        {
+            output->realp[i] = (2 * i) < in_length ? static_cast<T>(input[2 * i]) : static_cast<T>(0);
+            output->imagp[i] = (2 * i + 1) < in_length ? static_cast<T>(input[2 * i + 1]) : static_cast<T>(0);
+        }
+        
+        hisstools_fft(output, setup);
+        
+        // Separate the even and odd spectra and combine
+        
+        const T dc = output->realp[0];
+        
+        output->realp[0] = dc + output->imagp[0];
+        output->realp[length] = dc - output->imagp[0];
+        output->imagp[0] = static_cast<T>(0);
+        output->imagp[length] = static_cast<T>(0);
+        
+        for (uintptr_t i = 1, j = length - 1; i <= j; i++, j--)
+        {
+            const T e_r = static_cast<T>(0.5) * (output->realp[i] + output->realp[j]);
+            const T e_i = static_cast<T>(0.5) * (output->imagp[i] - output->imagp[j]);
+            const T o_r = static_cast<T>(0.5) * (output->imagp[i] + output->imagp[j]);
+            const T o_i = static_cast<T>(0.5) * (output->realp[j] - output->realp[i]);
+            
+            const T t_r = w.realp[i] * o_r - w.imagp[i] * o_i;
+            const T t_i = w.realp[i] * o_i + w.imagp[i] * o_r;
+            
+            output->realp[i] = e_r + t_r;
+            output->imagp[i] = e_i + t_i;
+            output->realp[j] = e_r - t_r;
+            output->imagp[j] = t_i - e_i;
+        }
+    }
+    
+    // A Real iFFT of twice the setup length (the input holds length + 1 bins and is used as working memory)
+    
+    template <class T>
+    void hisstools_rifft(Split<T> *input, T *output, ArbitrarySetup<T> *setup)
+    {
+        const uintptr_t length = setup->length;
+        const Split<T> &w = setup->real_twiddles;
+        
+        // Recombine into the spectrum of the even and odd samples as a complex signal
+        
+        const T dc = input->realp[0];
+        const T nyquist = input->realp[length];
+        
+        input->realp[0] = dc + nyquist;
+        input->imagp[0] = dc - nyquist;
+        
+        for (uintptr_t i = 1, j = length - 1; i <= j; i++, j--)
+        {
+            const T e_r = input->realp[i] + input->realp[j];
+            const T e_i = input->imagp[i] - input->imagp[j];
+            const T d_r = input->realp[i] - input->realp[j];
+            const T d_i = input->imagp[i] + input->imagp[j];
+            
+            // Multiply the difference by the conjugate twiddle
+            
+            const T o_r = d_r * w.realp[i] + d_i * w.imagp[i];
+            const T o_i = d_i * w.realp[i] - d_r * w.imagp[i];
+            
+            input->realp[i] = e_r - o_i;
+            input->imagp[i] = e_i + o_r;
+            input->realp[j] = e_r + o_i;
+            input->imagp[j] = o_r - e_i;
+        }
+        
+        hisstools_ifft(input, setup);
+        
+        // Zip
+        
+        for (uintptr_t i = 0; i < length; i++)
+        {
+            output[2 * i] = input->realp[i];
+            output[2 * i + 1] = input->imagp[i];
+        }
+    }
+    
 } /* hisstools_fft_impl */
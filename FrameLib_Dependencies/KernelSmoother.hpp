@@ -31,24 +31,27 @@ public:
     enum SmoothMode { kSmoothZeroPad, kSmoothWrap, kSmoothFold };
     
     template <typename U = Allocator, typename = enable_if_t<std::is_default_constructible<U>::value>>
-    kernel_smoother()
-    {
-        set_max_fft_size(1 << 18);
-    }
+    kernel_smoother(uintptr_t max_fft_size = 1 << 18) : spectral_processor<T, Allocator>(max_fft_size)
+    {}
     
     template <typename U = Allocator, typename = enable_if_t<std::is_copy_constructible<U>::value>>
-    kernel_smoother(const Allocator& allocator) : spectral_processor<T, Allocator>(allocator)
-    {
-        set_max_fft_size(1 << 18);
-    }
+    kernel_smoother(const Allocator& allocator, uintptr_t max_fft_size = 1 << 18) : spectral_processor<T, Allocator>(allocator, max_fft_size)
+    {}
     
     template <typename U = Allocator, typename = enable_if_t<std::is_move_constructible<U>::value>>
-    kernel_smoother(Allocator&& allocator) : spectral_processor<T, Allocator>(allocator)
+    kernel_smoother(Allocator&& allocator, uintptr_t max_fft_size = 1 << 18) : spectral_processor<T, Allocator>(allocator, max_fft_size)
+    {}
+    
+    ~kernel_smoother()
     {
-        set_max_fft_size(1 << 18);
+        release_cache();
     }
+    
+    kernel_smoother(const kernel_smoother&) = delete;
+    kernel_smoother& operator=(const kernel_smoother&) = delete;
 
     void set_max_fft_size(uintptr_t size) { processor::set_max_fft_size(size); }
+    void set_fft_setup(typename FFTTypes<T>::Setup setup, uintptr_t max_fft_size_log2) { processor::set_fft_setup(setup, max_fft_size_log2); }
     
     void smooth(T *out, const T *in, const T *kernel, uintptr_t length, uintptr_t kernel_length, double width_lo, double width_hi, SmoothMode mode)
     {
@@ -68,7 +71,7 @@ public:
         
         uintptr_t filter_size = std::ceil(std::max(width_lo, width_hi) * 0.5);
         uintptr_t filter_full = filter_size * 2 - 1;
-        uintptr_t max_per_filter = width_mul ? (2.0 / width_mul) + 1.0 : length;
+        uintptr_t max_per_filter = width_mul ? (2.0 / std::abs(width_mul)) + 1.0 : length;
         uintptr_t data_width = max_per_filter + (filter_size - 1) * 2;
         
         binary_sizes sizes(filter_full, data_width);
@@ -84,17 +87,11 @@ public:
         T *filter = ptr + (fft_size << 1) + filter_size - 1;
         T *temp = filter + filter_size;
         
-        bool non_zero_end = true;
+        const bool non_zero_end = calc_non_zero_end(kernel, kernel_length);
         
-        if (kernel_length)
-        {
-            const T max_value = *std::max_element(kernel, kernel + kernel_length);
-            const T test_value = kernel[kernel_length - 1] / max_value;
-            const T epsilon = std::numeric_limits<T>::epsilon();
-            
-            if (test_value < epsilon)
-                non_zero_end = false;
-        }
+        // Reuse the filters (and their spectra) from the last call if the kernel, length and widths are unchanged
+        
+        const filter_segment *segment = update_cache(kernel, kernel_length, length, width_lo, width_hi, fft_size);
         
         // Copy data
         
@@ -119,12 +116,11 @@ public:
                 break;
         }
         
-        const double *data = temp + filter_size;
+        const T *data = temp + filter_size;
         
         for (uintptr_t i = 0, j = 0; i < length; i = j)
         {
             uintptr_t half_width = static_cast<uintptr_t>(half_width_calc(i));
-            const T filter_normalise = make_filter(filter, kernel, kernel_length, half_width, non_zero_end);
             
             for (j = i; (j < length) && half_width == half_width_calc(j); j++);
             
@@ -134,15 +130,34 @@ public:
             uintptr_t m = n;//std::min(optimal_fft / 2, n);
                 
             m = use_fft(n, half_width, fft_size) ? m : 0;
-
+            
+            const T *segment_filter = filter;
+            const Split *spectrum = &st;
+            T filter_normalise;
+            
+            if (segment)
+            {
+                segment_filter = segment->m_filter;
+                spectrum = &segment->m_spectrum;
+                filter_normalise = segment->m_gain;
+                segment++;
+            }
+            else
+            {
+                filter_normalise = make_filter(filter, kernel, kernel_length, half_width, non_zero_end);
+                
+                if (m)
+                    transform_filter(st, filter, half_width, m);
+            }
+            
             for (; k + (m - 1) < n; k += m)
-                apply_filter_fft(out + i + k, data + i + k, filter, io, st, half_width, m, filter_normalise);
+                apply_filter_fft(out + i + k, data + i + k, *spectrum, io, half_width, m, filter_normalise);
                 
             for (; k + (N - 1) < n; k += N)
-                apply_filter<N>(out + i + k, data + i + k, filter, half_width, filter_normalise);
+                apply_filter<N>(out + i + k, data + i + k, segment_filter, half_width, filter_normalise);
             
             for (; k < n; k++)
-                apply_filter<1>(out + i + k, data + i + k, filter, half_width, filter_normalise);
+                apply_filter<1>(out + i + k, data + i + k, segment_filter, half_width, filter_normalise);
         }
         /*
          for (uintptr_t i = 0; i < length; i++)
@@ -170,6 +185,150 @@ public:
     
 private:
     
+    /**
+     
+     @struct filter_segment
+     
+     @brief a cached filter (and its spectrum if the segment uses the FFT) for a run of samples with the same width.
+     
+     */
+    
+    struct filter_segment
+    {
+        T *m_filter;
+        Split m_spectrum;
+        T m_gain;
+    };
+    
+    // The cache is limited in size (in values) as filters with widely varying widths can be large
+    
+    static uintptr_t max_cache_size() { return 1 << 20; }
+    
+    // Return the cached segments for the given arguments (or nullptr if they can't be cached)
+    
+    const filter_segment *update_cache(const T *kernel, uintptr_t kernel_length, uintptr_t length, double width_lo, double width_hi, uintptr_t fft_size)
+    {
+        if (m_segments && kernel_length == m_kernel_length && length == m_length && width_lo == m_width_lo && width_hi == m_width_hi && fft_size == m_fft_size)
+        {
+            if (std::equal(kernel, kernel + kernel_length, m_kernel))
+                return m_segments;
+        }
+        
+        release_cache();
+        
+        if (!kernel_length)
+            return nullptr;
+        
+        Allocator& allocator = processor::m_allocator;
+        
+        const double width_mul = (width_hi - width_lo) / (length - 1);
+        const bool non_zero_end = calc_non_zero_end(kernel, kernel_length);
+        
+        auto half_width_calc = [&](uintptr_t a)
+        {
+            return static_cast<uintptr_t>(std::round((width_lo + a * width_mul) * 0.5));
+        };
+        
+        // Calculate the memory required (N.B. spectra are placed first to keep them aligned)
+        
+        uintptr_t num_segments = 0;
+        uintptr_t spectra_size = 0;
+        uintptr_t filters_size = 0;
+        
+        for (uintptr_t i = 0, j = 0; i < length; i = j)
+        {
+            uintptr_t half_width = half_width_calc(i);
+            
+            for (j = i; (j < length) && half_width == half_width_calc(j); j++);
+            
+            if (use_fft(j - i, half_width, fft_size))
+                spectra_size += filter_fft_size(half_width, j - i);
+            
+            filters_size += half_width * 2 - 1;
+            num_segments++;
+        }
+        
+        if (spectra_size + filters_size + kernel_length > max_cache_size())
+            return nullptr;
+        
+        m_memory = allocator.template allocate<T>(spectra_size + filters_size + kernel_length);
+        m_segments = allocator.template allocate<filter_segment>(num_segments);
+        
+        if (!m_memory || !m_segments)
+        {
+            release_cache();
+            return nullptr;
+        }
+        
+        // Make the filters and spectra
+        
+        T *spectra = m_memory;
+        T *filters = m_memory + spectra_size;
+        filter_segment *segment = m_segments;
+        
+        for (uintptr_t i = 0, j = 0; i < length; i = j, segment++)
+        {
+            uintptr_t half_width = half_width_calc(i);
+            
+            for (j = i; (j < length) && half_width == half_width_calc(j); j++);
+            
+            segment->m_filter = filters + half_width - 1;
+            segment->m_gain = make_filter(segment->m_filter, kernel, kernel_length, half_width, non_zero_end);
+            segment->m_spectrum = { nullptr, nullptr };
+            
+            if (use_fft(j - i, half_width, fft_size))
+            {
+                uintptr_t size = filter_fft_size(half_width, j - i);
+                
+                segment->m_spectrum = { spectra, spectra + (size >> 1) };
+                transform_filter(segment->m_spectrum, segment->m_filter, half_width, j - i);
+                spectra += size;
+            }
+            
+            filters += half_width * 2 - 1;
+        }
+        
+        m_kernel = filters;
+        std::copy_n(kernel, kernel_length, m_kernel);
+        
+        m_kernel_length = kernel_length;
+        m_length = length;
+        m_width_lo = width_lo;
+        m_width_hi = width_hi;
+        m_fft_size = fft_size;
+        
+        return m_segments;
+    }
+    
+    void release_cache()
+    {
+        Allocator& allocator = processor::m_allocator;
+        
+        if (m_memory)
+            allocator.deallocate(m_memory);
+        if (m_segments)
+            allocator.deallocate(m_segments);
+        
+        m_memory = nullptr;
+        m_segments = nullptr;
+        m_kernel = nullptr;
+    }
+    
+    bool calc_non_zero_end(const T *kernel, uintptr_t kernel_length)
+    {
+        if (kernel_length)
+        {
+            const T max_value = *std::max_element(kernel, kernel + kernel_length);
+            const T test_value = kernel[kernel_length - 1] / max_value;
+            const T epsilon = std::numeric_limits<T>::epsilon();
+            
+            if (test_value < epsilon)
+                return false;
+        }
+        
+        return true;
+    }
+    
     bool use_fft(uintptr_t n, uintptr_t half_width, uintptr_t fft_size)
     {
         return fft_size && n > 2 && half_width > 2 && (32 * n > half_width);
@@ -210,9 +369,9 @@ private:
     template <int N>
     void apply_filter(T *out, const T *data, const T *filter, uintptr_t half_width, T gain)
     {
-        using VecType = SIMDType<double, N>;
+        using VecType = SIMDType<T, N>;
         
-        VecType filter_val = SIMDType<double, N>(data) * filter[0];
+        VecType filter_val = VecType(data) * filter[0];
         
         for (uintptr_t j = 1; j < half_width; j++)
             filter_val += filter[j] * (VecType(data - j) + VecType(data + j));
@@ -221,22 +380,36 @@ private:
         filter_val.store(out);
     }
     
-    void apply_filter_fft(T *out, const T *data, T *filter, Split& io, Split& temp, uintptr_t half_width, uintptr_t n, T gain)
+    uintptr_t filter_fft_size(uintptr_t half_width, uintptr_t n)
+    {
+        return binary_sizes(n + (half_width - 1) * 2, half_width * 2 - 1).fft();
+    }
+    
+    // Mirror the filter and transform it for a segment of n samples
+    
+    void transform_filter(Split& spectrum, T *filter, uintptr_t half_width, uintptr_t n)
     {
         uintptr_t filter_width = half_width * 2 - 1;
-        uintptr_t data_width = n + (half_width - 1) * 2;
-        binary_sizes sizes(data_width, filter_width);
-        in_ptr data_in(data - (half_width - 1), data_width);
-        in_ptr filter_in(filter - (half_width - 1), filter_width);
-        
-        // Mirror the filter
+        binary_sizes sizes(n + (half_width - 1) * 2, filter_width);
         
         for (intptr_t i = 1; i < (intptr_t) half_width; i++)
             filter[-i] = filter[i];
         
+        processor::rfft(spectrum, filter - (half_width - 1), filter_width, sizes.fft_log2());
+    }
+    
+    void apply_filter_fft(T *out, const T *data, const Split& filter_spectrum, Split& io, uintptr_t half_width, uintptr_t n, T gain)
+    {
+        uintptr_t filter_width = half_width * 2 - 1;
+        uintptr_t data_width = n + (half_width - 1) * 2;
+        binary_sizes sizes(data_width, filter_width);
+        Split spectrum = filter_spectrum;
+        
         // Process
         
-        processor::template binary_op<ir_convolve_real>(io, temp, sizes, data_in, filter_in);
+        processor::rfft(io, data - (half_width - 1), data_width, sizes.fft_log2());
+        ir_convolve_real(&io, &io, &spectrum, sizes.fft(), T(0.25) / (T) sizes.fft());
+        processor::rifft(io, sizes.fft_log2());
         
         // Copy output with scaling
         
@@ -245,6 +418,17 @@ private:
         for (uintptr_t i = 0; i < n; i++)
             out[i] = *p++ * gain;
     }
+    
+    // Cache
+    
+    T *m_memory = nullptr;
+    T *m_kernel = nullptr;
+    filter_segment *m_segments = nullptr;
+    uintptr_t m_kernel_length = 0;
+    uintptr_t m_length = 0;
+    uintptr_t m_fft_size = 0;
+    double m_width_lo = 0.0;
+    double m_width_hi = 0.0;
 };
     
     
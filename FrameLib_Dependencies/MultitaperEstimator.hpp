@@ -0,0 +1,332 @@
+
+#ifndef MULTITAPERESTIMATOR_HPP
+#define MULTITAPERESTIMATOR_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "SpectralProcessor.hpp"
+#include "SIMDSupport.hpp"
+
+// A spectral processor that adds multitaper power spectrum estimation using sine tapers
+// The tapers are applied as differences between bins of a single transform of twice the size
+
+template <typename T, typename Allocator = aligned_allocator>
+class multitaper_estimator : public spectral_processor<T, Allocator>
+{
+    using Base = spectral_processor<T, Allocator>;
+    using Split = typename FFTTypes<T>::Split;
+    
+    static const int vec_size = SIMDLimits<T>::max_size;
+    
+    using VecType = SIMDType<T, vec_size>;
+    using ScalarType = SIMDType<T, 1>;
+
+public:
+    
+    // Parabolic weights are fixed (decreasing with the taper order)
+    // Adaptive weights are calculated per bin to reduce broadband leakage (after Thomson)
+    
+    enum Weighting { kWeightingParabolic, kWeightingAdaptive };
+    
+    // Constructors
+    
+    using Base::Base;
+    
+    ~multitaper_estimator()
+    {
+        release_concentrations();
+    }
+    
+    multitaper_estimator(const multitaper_estimator&) = delete;
+    multitaper_estimator& operator=(const multitaper_estimator&) = delete;
+    
+    // Power Spectrum (the output is (N / 2) + 1 in length where N is the input size rounded up to a power of two)
+    
+    // N.B. returns false if the transform is too large or memory could not be allocated (in which case the output is not written)
+    
+    bool power_spectrum(T *output, const T *input, uintptr_t size, uintptr_t num_tapers, Weighting weighting)
+    {
+        uintptr_t fft_size_log2 = Base::calc_fft_size_log2(size);
+        uintptr_t fft_size = uintptr_t(1) << fft_size_log2;
+        uintptr_t output_size = (fft_size >> 1) + 1;
+        
+        if (!size || !num_tapers || (fft_size << 1) > Base::max_fft_size())
+            return false;
+        
+        // Adaptive weighting requires the noise power of the input (an input with no variance has no broadband leakage)
+        
+        T noise = weighting == kWeightingAdaptive ? calc_noise_power(input, size) : T(0);
+        
+        if (!(noise > T(0)))
+            weighting = kWeightingParabolic;
+        
+        if (weighting == kWeightingAdaptive && !update_concentrations(fft_size, num_tapers))
+            return false;
+        
+        // The unwrapped bins are padded by an even number of bins (of at least the number of tapers) at either end
+        
+        uintptr_t padding = num_tapers + (num_tapers & 1U);
+        uintptr_t unwrapped_size = (fft_size >> 1) + padding + 1;
+        uintptr_t spectrum_size = align_size(fft_size + 1);
+        uintptr_t bins_size = align_size(unwrapped_size);
+        uintptr_t eigen_size = weighting == kWeightingAdaptive ? num_tapers * align_size(output_size) : 0;
+        
+        T *memory = this->m_allocator.template allocate<T>((spectrum_size << 1) + (bins_size << 2) + eigen_size);
+        
+        if (!memory)
+            return false;
+        
+        Split spectrum { memory, memory + spectrum_size };
+        Split even { spectrum.imagp + spectrum_size, spectrum.imagp + spectrum_size + bins_size };
+        Split odd { even.imagp + bins_size, even.imagp + (bins_size << 1) };
+        T *eigen = odd.imagp + bins_size;
+        
+        // Take the real fft (at twice the size) and move the Nyquist bin
+        
+        Base::rfft(spectrum, input, size, fft_size_log2 + 1);
+        
+        spectrum.realp[fft_size] = spectrum.imagp[0];
+        spectrum.imagp[fft_size] = T(0);
+        spectrum.imagp[0] = T(0);
+        
+        // Unwrap the spectrum once (separating even and odd bins so that the bins used by each taper are contiguous)
+        
+        unwrap(even, spectrum, fft_size, padding, 0, unwrapped_size);
+        unwrap(odd, spectrum, fft_size, padding, 1, unwrapped_size);
+        
+        if (weighting == kWeightingAdaptive)
+        {
+            uintptr_t stride = align_size(output_size);
+            
+            for (uintptr_t i = 1; i <= num_tapers; i++)
+                apply_taper<false>(eigen + (i - 1) * stride, (i & 1U) ? odd : even, output_size, padding, i, T(0.25));
+            
+            combine_adaptive(output, eigen, output_size, stride, num_tapers, noise);
+        }
+        else
+        {
+            // N.B. the weights sum to weight_sum, and each taper spectrum is four times the power of the tapered input
+            
+            double weight_sum = num_tapers - (((1.0 / (double) num_tapers) - 3.0 + 2.0 * num_tapers) / 6.0);
+            double norm_factor = 1.0 / (4.0 * weight_sum);
+            
+            std::fill_n(output, output_size, T(0));
+            
+            for (uintptr_t i = 1; i <= num_tapers; i++)
+            {
+                double weight = (1.0 - ((i - 1) * (i - 1)) / (double) (num_tapers * num_tapers));
+                apply_taper<true>(output, (i & 1U) ? odd : even, output_size, padding, i, static_cast<T>(weight * norm_factor));
+            }
+        }
+        
+        this->m_allocator.deallocate(memory);
+        
+        return true;
+    }
+
+private:
+    
+    // Sizes are rounded so that each array is aligned for SIMD processing
+    
+    static uintptr_t align_size(uintptr_t size)
+    {
+        const uintptr_t alignment = 16;
+        
+        return (size + (alignment - 1)) & ~(alignment - 1);
+    }
+    
+    // The expected power of each taper spectrum for white noise with the variance of the input (the tapers have an energy of N / 2)
+    
+    static T calc_noise_power(const T *input, uintptr_t size)
+    {
+        double mean = 0.0;
+        double sum = 0.0;
+        
+        for (uintptr_t i = 0; i < size; i++)
+            mean += input[i];
+        
+        mean /= static_cast<double>(size);
+        
+        for (uintptr_t i = 0; i < size; i++)
+            sum += (input[i] - mean) * (input[i] - mean);
+        
+        return static_cast<T>(sum * 0.5);
+    }
+    
+    // Copy bins (scaled to correct for the real transform) such that bins[i] is bin (2 * i + offset - padding) of the full spectrum
+    
+    static void unwrap(Split& bins, const Split& spectrum, uintptr_t fft_size, uintptr_t padding, uintptr_t offset, uintptr_t size)
+    {
+        const uintptr_t mask = (fft_size << 1) - 1;
+        
+        for (uintptr_t i = 0; i < size; i++)
+        {
+            uintptr_t pos = ((i << 1) + offset - padding) & mask;
+            
+            if (pos <= fft_size)
+            {
+                bins.realp[i] = spectrum.realp[pos] * T(0.5);
+                bins.imagp[i] = spectrum.imagp[pos] * T(0.5);
+            }
+            else
+            {
+                pos = (fft_size << 1) - pos;
+                bins.realp[i] = spectrum.realp[pos] * T(0.5);
+                bins.imagp[i] = -spectrum.imagp[pos] * T(0.5);
+            }
+        }
+    }
+    
+    // Taper i is the difference between bins (2 * j + i) and (2 * j - i) for output bin j
+    
+    template <bool Accumulate>
+    static void apply_taper(T *output, const Split& bins, uintptr_t size, uintptr_t padding, uintptr_t taper, T scale)
+    {
+        const T *r_hi = bins.realp + (padding >> 1) + (taper >> 1);
+        const T *i_hi = bins.imagp + (padding >> 1) + (taper >> 1);
+        const T *r_lo = bins.realp + (padding >> 1) - ((taper + 1) >> 1);
+        const T *i_lo = bins.imagp + (padding >> 1) - ((taper + 1) >> 1);
+        
+        uintptr_t j = 0;
+        
+        for (; j + vec_size <= size; j += vec_size)
+            taper_op<Accumulate, VecType>(output + j, r_hi + j, i_hi + j, r_lo + j, i_lo + j, scale);
+        
+        for (; j < size; j++)
+            taper_op<Accumulate, ScalarType>(output + j, r_hi + j, i_hi + j, r_lo + j, i_lo + j, scale);
+    }
+    
+    template <bool Accumulate, class V>
+    static void taper_op(T *output, const T *r_hi, const T *i_hi, const T *r_lo, const T *i_lo, T scale)
+    {
+        const V r = V(i_hi) - V(i_lo);
+        const V i = V(r_lo) - V(r_hi);
+        const V power = ((r * r) + (i * i)) * V(scale);
+        
+        if (Accumulate)
+            (V(output) + power).store(output);
+        else
+            power.store(output);
+    }
+    
+    // Adaptive weighting (iterating from the mean of the first two taper spectra)
+    
+    void combine_adaptive(T *output, const T *eigen, uintptr_t size, uintptr_t stride, uintptr_t num_tapers, T noise) const
+    {
+        uintptr_t j = 0;
+        
+        for (; j + vec_size <= size; j += vec_size)
+            adaptive_op<VecType>(output + j, eigen + j, stride, num_tapers, noise);
+        
+        for (; j < size; j++)
+            adaptive_op<ScalarType>(output + j, eigen + j, stride, num_tapers, noise);
+    }
+    
+    template <class V>
+    void adaptive_op(T *output, const T *eigen, uintptr_t stride, uintptr_t num_tapers, T noise_power) const
+    {
+        const int iterations = 3;
+        const V tiny(std::numeric_limits<T>::min());
+        const V noise(noise_power);
+        
+        V estimate = num_tapers > 1 ? (V(eigen) + V(eigen + stride)) * V(T(0.5)) : V(eigen);
+        
+        for (int k = 0; k < iterations; k++)
+        {
+            V sum(T(0));
+            V weight_sum(T(0));
+            
+            for (uintptr_t i = 0; i < num_tapers; i++)
+            {
+                const V lambda(m_concentrations[i]);
+                const V b = estimate / max(lambda * estimate + (V(T(1)) - lambda) * noise, tiny);
+                const V weight = b * b * lambda;
+                
+                sum += weight * V(eigen + i * stride);
+                weight_sum += weight;
+            }
+            
+            estimate = sum / max(weight_sum, tiny);
+        }
+        
+        estimate.store(output);
+    }
+    
+    // The proportion of the energy of each taper within the bandwidth of the estimate (the equivalent of the eigenvalues for DPSS tapers)
+    
+    bool update_concentrations(uintptr_t fft_size, uintptr_t num_tapers)
+    {
+        if (m_concentrations && fft_size == m_concentrations_fft_size && num_tapers == m_concentrations_num_tapers)
+            return true;
+        
+        release_concentrations();
+        
+        m_concentrations = this->m_allocator.template allocate<T>(num_tapers);
+        
+        if (!m_concentrations)
+            return false;
+        
+        m_concentrations_fft_size = fft_size;
+        m_concentrations_num_tapers = num_tapers;
+        
+        // The spectrum of taper i is the difference of two Dirichlet kernels (at +/- i / 2N) integrated over +/- W with Simpson's rule
+        
+        const double pi = 3.14159265358979323846;
+        const double N = static_cast<double>(fft_size);
+        const double W = (num_tapers + 1) / (2.0 * N);
+        const uintptr_t steps = 16 * (num_tapers + 1);
+        const double h = W / steps;
+        
+        auto dirichlet = [&](double x)
+        {
+            double s = sin(pi * x);
+            return std::fabs(s) < 1e-12 ? N : sin(pi * x * N) / s;
+        };
+        
+        for (uintptr_t i = 1; i <= num_tapers; i++)
+        {
+            const double a = i / (2.0 * N);
+            const double c = cos(pi * i * (N - 1.0) / N);
+            
+            auto power = [&](double f)
+            {
+                double d1 = dirichlet(f - a);
+                double d2 = dirichlet(f + a);
+                return (d1 * d1 + d2 * d2 - 2.0 * c * d1 * d2) * 0.25;
+            };
+            
+            double sum = power(0.0) + power(W);
+            
+            for (uintptr_t k = 1; k < steps; k++)
+                sum += power(k * h) * ((k & 1U) ? 4.0 : 2.0);
+            
+            // N.B. the integral is doubled for negative frequencies and normalised by the taper energy (N / 2)
+            
+            double concentration = (2.0 * sum * h / 3.0) / (N * 0.5);
+            
+            m_concentrations[i - 1] = static_cast<T>(std::min(1.0, std::max(0.0, concentration)));
+        }
+        
+        return true;
+    }
+    
+    void release_concentrations()
+    {
+        if (m_concentrations)
+            this->m_allocator.deallocate(m_concentrations);
+        
+        m_concentrations = nullptr;
+        m_concentrations_fft_size = 0;
+        m_concentrations_num_tapers = 0;
+    }
+    
+    // Data
+    
+    T *m_concentrations = nullptr;
+    uintptr_t m_concentrations_fft_size = 0;
+    uintptr_t m_concentrations_num_tapers = 0;
+};
+
+#endif
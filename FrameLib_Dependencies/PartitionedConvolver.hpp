@@ -0,0 +1,212 @@
+
+#ifndef PARTITIONEDCONVOLVER_HPP
+#define PARTITIONEDCONVOLVER_HPP
+
+#include <algorithm>
+
+#include "SpectralProcessor.hpp"
+
+// A spectral processor that adds partitioned linear convolution with a cached kernel
+// The spectra of the kernel partitions are kept until the kernel (or the partitioning) changes
+
+template <typename T, typename Allocator = aligned_allocator>
+class partitioned_convolver : public spectral_processor<T, Allocator>
+{
+    using Base = spectral_processor<T, Allocator>;
+    using Split = typename FFTTypes<T>::Split;
+    using in_ptr = typename Base::in_ptr;
+    
+    template <int N>
+    using temporary_buffers = typename Base::template temporary_buffers<N>;
+
+public:
+    
+    // Uniform partitions are all sized to the input, whereas non-uniform partitions double in size along the kernel
+    // N.B. as the whole output is calculated at once larger transforms only reduce the number of partitions, so growth is limited
+    
+    enum PartitionMode { kPartitionUniform, kPartitionNonUniform };
+    
+    // Constructors
+    
+    using Base::Base;
+    
+    ~partitioned_convolver()
+    {
+        release_kernel();
+    }
+    
+    partitioned_convolver(const partitioned_convolver&) = delete;
+    partitioned_convolver& operator=(const partitioned_convolver&) = delete;
+    
+    // Partitioned Convolution (with linear edges so the output size is in.m_size + kernel.m_size - 1)
+    
+    // N.B. returns false if memory could not be allocated (in which case the output is not written)
+    
+    bool convolve_partitioned(T *output, in_ptr in, in_ptr kernel, PartitionMode mode)
+    {
+        if (!Base::convolved_size(in.m_size, kernel.m_size, Base::kEdgeLinear))
+            return true;
+        
+        uintptr_t partition_size = calc_partition_size(in.m_size);
+        
+        // If the partitions would be too large use a single transform
+        
+        if ((partition_size << 1) > Base::max_fft_size())
+        {
+            Base::convolve(output, in, kernel, Base::kEdgeLinear);
+            return true;
+        }
+        
+        if (!update_kernel(kernel, partition_size, mode))
+            return false;
+        
+        temporary_buffers<2> buffers(this->m_allocator, m_max_partition_size);
+        
+        if (!buffers)
+            return false;
+        
+        Split& in_spectrum = buffers.m_spectra[0];
+        Split& spectrum = buffers.m_spectra[1];
+        Split partition;
+        
+        std::fill_n(output, in.m_size + kernel.m_size - 1, T(0));
+        
+        // Multiply the input with each partition and overlap-add the results (the input is transformed once per size)
+        
+        uintptr_t transformed_size = 0;
+        T *spectra = m_spectra;
+        
+        for (uintptr_t offset = 0, size; offset < kernel.m_size; offset += size)
+        {
+            size = partition_length(offset, kernel.m_size - offset);
+            
+            uintptr_t fft_size_log2 = Base::calc_fft_size_log2(size << 1);
+            uintptr_t result_size = in.m_size + std::min(size, kernel.m_size - offset) - 1;
+            
+            partition.realp = spectra;
+            partition.imagp = spectra + size;
+            
+            if (size != transformed_size)
+            {
+                Base::rfft(in_spectrum, in.m_ptr, in.m_size, fft_size_log2);
+                transformed_size = size;
+            }
+            
+            ir_convolve_real(&spectrum, &in_spectrum, &partition, size << 1, T(1));
+            Base::rifft(spectrum, fft_size_log2);
+            Base::wrap(output, spectrum, offset, 0, result_size);
+            
+            spectra += size << 1;
+        }
+        
+        return true;
+    }
+
+private:
+    
+    // Partitions are sized to the input (with a minimum size that keeps each partition spectrum aligned for SIMD processing)
+    
+    static uintptr_t calc_partition_size(uintptr_t size)
+    {
+        return std::max(uintptr_t(64), uintptr_t(1) << Base::calc_fft_size_log2(size));
+    }
+    
+    // The size of the partition at a given offset into the kernel
+    
+    uintptr_t partition_length(uintptr_t offset, uintptr_t remaining) const
+    {
+        if (m_mode == kPartitionUniform || !offset)
+            return m_partition_size;
+        
+        // N.B. offsets double along with the partitions so that each partition is the size of all those before it
+        
+        uintptr_t limit = std::min(std::max(m_partition_size, uintptr_t(1024)), Base::max_fft_size() >> 1);
+        uintptr_t size = std::min(offset, limit);
+        uintptr_t remaining_size = uintptr_t(1) << Base::calc_fft_size_log2(remaining);
+        
+        return std::max(m_partition_size, std::min(size, remaining_size));
+    }
+    
+    // Recalculate the partition spectra only if the kernel or the partitioning has changed
+    
+    bool update_kernel(in_ptr kernel, uintptr_t partition_size, PartitionMode mode)
+    {
+        if (m_kernel && kernel.m_size == m_kernel_size && partition_size == m_partition_size && mode == m_mode)
+        {
+            if (std::equal(kernel.m_ptr, kernel.m_ptr + kernel.m_size, m_kernel))
+                return true;
+        }
+        
+        release_kernel();
+        
+        m_partition_size = partition_size;
+        m_mode = mode;
+        
+        // Calculate the memory needed for the spectra
+        
+        uintptr_t spectra_size = 0;
+        
+        for (uintptr_t offset = 0, size; offset < kernel.m_size; offset += size)
+        {
+            size = partition_length(offset, kernel.m_size - offset);
+            m_max_partition_size = std::max(m_max_partition_size, size);
+            spectra_size += size << 1;
+        }
+        
+        m_kernel = this->m_allocator.template allocate<T>(kernel.m_size);
+        m_spectra = this->m_allocator.template allocate<T>(spectra_size);
+        
+        if (!m_kernel || !m_spectra)
+        {
+            release_kernel();
+            return false;
+        }
+        
+        std::copy_n(kernel.m_ptr, kernel.m_size, m_kernel);
+        m_kernel_size = kernel.m_size;
+        
+        // Transform the partitions (with the scaling for the real transforms applied in advance)
+        
+        T *spectra = m_spectra;
+        
+        for (uintptr_t offset = 0, size; offset < kernel.m_size; offset += size)
+        {
+            size = partition_length(offset, kernel.m_size - offset);
+            
+            Split partition { spectra, spectra + size };
+            
+            uintptr_t fft_size_log2 = Base::calc_fft_size_log2(size << 1);
+            
+            Base::rfft(partition, kernel.m_ptr + offset, std::min(size, kernel.m_size - offset), fft_size_log2);
+            Base::scale_spectrum(partition, size, T(0.25) / static_cast<T>(size << 1));
+            
+            spectra += size << 1;
+        }
+        
+        return true;
+    }
+    
+    void release_kernel()
+    {
+        if (m_kernel)
+            this->m_allocator.deallocate(m_kernel);
+        if (m_spectra)
+            this->m_allocator.deallocate(m_spectra);
+        
+        m_kernel = nullptr;
+        m_spectra = nullptr;
+        m_kernel_size = 0;
+        m_max_partition_size = 0;
+    }
+    
+    // Data
+    
+    T *m_kernel = nullptr;
+    T *m_spectra = nullptr;
+    uintptr_t m_kernel_size = 0;
+    uintptr_t m_partition_size = 0;
+    uintptr_t m_max_partition_size = 0;
+    PartitionMode m_mode = kPartitionUniform;
+};
+
+#endif
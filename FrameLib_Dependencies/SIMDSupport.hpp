@@ -252,6 +252,8 @@ struct SIMDType<double, 1>
     
     friend SIMDType round(const SIMDType& a) { return round(a.mVal); }
     friend SIMDType trunc(const SIMDType& a) { return trunc(a.mVal); }
+    friend SIMDType floor(const SIMDType& a) { return floor(a.mVal); }
+    friend SIMDType ceil(const SIMDType& a) { return ceil(a.mVal); }
     
     friend SIMDType min(const SIMDType& a, const SIMDType& b) { return std::min(a.mVal, b.mVal); }
     friend SIMDType max(const SIMDType& a, const SIMDType& b) { return std::max(a.mVal, b.mVal); }
@@ -295,6 +297,8 @@ struct SIMDType<float, 1>
     
     friend SIMDType round(const SIMDType& a) { return roundf(a.mVal); }
     friend SIMDType trunc(const SIMDType& a) { return truncf(a.mVal); }
+    friend SIMDType floor(const SIMDType& a) { return floorf(a.mVal); }
+    friend SIMDType ceil(const SIMDType& a) { return ceilf(a.mVal); }
     
     friend SIMDType min(const SIMDType& a, const SIMDType& b) { return std::min(a.mVal, b.mVal); }
     friend SIMDType max(const SIMDType& a, const SIMDType& b) { return std::max(a.mVal, b.mVal); }
@@ -344,12 +348,22 @@ struct SIMDType<float, 2>
         a[1] = mVals[1];
     }
     
-    // N.B. - no ops
+    // N.B. - arithmetic only (performed as scalars)
+    
+    friend SIMDType operator + (const SIMDType& a, const SIMDType& b) { return SIMDType(a.mVals[0] + b.mVals[0], a.mVals[1] + b.mVals[1]); }
+    friend SIMDType operator - (const SIMDType& a, const SIMDType& b) { return SIMDType(a.mVals[0] - b.mVals[0], a.mVals[1] - b.mVals[1]); }
+    friend SIMDType operator * (const SIMDType& a, const SIMDType& b) { return SIMDType(a.mVals[0] * b.mVals[0], a.mVals[1] * b.mVals[1]); }
+    friend SIMDType operator / (const SIMDType& a, const SIMDType& b) { return SIMDType(a.mVals[0] / b.mVals[0], a.mVals[1] / b.mVals[1]); }
+    
+    SIMDType& operator += (const SIMDType& b)   { return (*this = *this + b); }
+    SIMDType& operator -= (const SIMDType& b)   { return (*this = *this - b); }
+    SIMDType& operator *= (const SIMDType& b)   { return (*this = *this * b); }
+    SIMDType& operator /= (const SIMDType& b)   { return (*this = *this / b); }
     
     float mVals[2];
 };
 
-#if (SIMD_COMPILER_SUPPORT_LEVEL >= SIMD_COMPILER_SUPPORT_SSE)
+#if (SIMD_COMPILER_SUPPORT_LEVEL >= SIMD_COMPILER_SUPPORT_SSE128)
 
 template<>
 struct SIMDType<double, 2> : public SIMDVector<double, __m128d, 2>
@@ -385,6 +399,8 @@ struct SIMDType<double, 2> : public SIMDVector<double, __m128d, 2>
     
     friend SIMDType round(const SIMDType& a) { return _mm_round_pd(a.mVal, _MM_FROUND_TO_NEAREST_INT |_MM_FROUND_NO_EXC); }
     friend SIMDType trunc(const SIMDType& a) { return _mm_round_pd(a.mVal, _MM_FROUND_TO_ZERO |_MM_FROUND_NO_EXC); }
+    friend SIMDType floor(const SIMDType& a) { return _mm_floor_pd(a.mVal); }
+    friend SIMDType ceil(const SIMDType& a) { return _mm_ceil_pd(a.mVal); }
     
     friend SIMDType min(const SIMDType& a, const SIMDType& b) { return _mm_min_pd(a.mVal, b.mVal); }
     friend SIMDType max(const SIMDType& a, const SIMDType& b) { return _mm_max_pd(a.mVal, b.mVal); }
@@ -397,10 +413,10 @@ struct SIMDType<double, 2> : public SIMDVector<double, __m128d, 2>
     
     friend SIMDType operator == (const SIMDType& a, const SIMDType& b) { return _mm_cmpeq_pd(a.mVal, b.mVal); }
     friend SIMDType operator != (const SIMDType& a, const SIMDType& b) { return _mm_cmpneq_pd(a.mVal, b.mVal); }
-    friend SIMDType operator > (const SIMDType& a, const SIMDType& b) { return _mm_cmplt_pd(a.mVal, b.mVal); }
-    friend SIMDType operator < (const SIMDType& a, const SIMDType& b) { return _mm_cmpgt_pd(a.mVal, b.mVal); }
-    friend SIMDType operator >= (const SIMDType& a, const SIMDType& b) { return _mm_cmple_pd(a.mVal, b.mVal); }
-    friend SIMDType operator <= (const SIMDType& a, const SIMDType& b) { return _mm_cmpge_pd(a.mVal, b.mVal); }
+    friend SIMDType operator > (const SIMDType& a, const SIMDType& b) { return _mm_cmpgt_pd(a.mVal, b.mVal); }
+    friend SIMDType operator < (const SIMDType& a, const SIMDType& b) { return _mm_cmplt_pd(a.mVal, b.mVal); }
+    friend SIMDType operator >= (const SIMDType& a, const SIMDType& b) { return _mm_cmpge_pd(a.mVal, b.mVal); }
+    friend SIMDType operator <= (const SIMDType& a, const SIMDType& b) { return _mm_cmple_pd(a.mVal, b.mVal); }
     
     template <int y, int x> static SIMDType shuffle(const SIMDType& a, const SIMDType& b)
     {
@@ -441,6 +457,8 @@ struct SIMDType<float, 4> : public SIMDVector<float, __m128, 4>
     
     friend SIMDType round(const SIMDType& a) { return _mm_round_ps(a.mVal, _MM_FROUND_TO_NEAREST_INT |_MM_FROUND_NO_EXC); }
     friend SIMDType trunc(const SIMDType& a) { return _mm_round_ps(a.mVal, _MM_FROUND_TO_ZERO |_MM_FROUND_NO_EXC); }
+    friend SIMDType floor(const SIMDType& a) { return _mm_floor_ps(a.mVal); }
+    friend SIMDType ceil(const SIMDType& a) { return _mm_ceil_ps(a.mVal); }
     
     friend SIMDType min(const SIMDType& a, const SIMDType& b) { return _mm_min_ps(a.mVal, b.mVal); }
     friend SIMDType max(const SIMDType& a, const SIMDType& b) { return _mm_max_ps(a.mVal, b.mVal); }
@@ -453,10 +471,10 @@ struct SIMDType<float, 4> : public SIMDVector<float, __m128, 4>
     
     friend SIMDType operator == (const SIMDType& a, const SIMDType& b) { return _mm_cmpeq_ps(a.mVal, b.mVal); }
     friend SIMDType operator != (const SIMDType& a, const SIMDType& b) { return _mm_cmpneq_ps(a.mVal, b.mVal); }
-    friend SIMDType operator > (const SIMDType& a, const SIMDType& b) { return _mm_cmplt_ps(a.mVal, b.mVal); }
-    friend SIMDType operator < (const SIMDType& a, const SIMDType& b) { return _mm_cmpgt_ps(a.mVal, b.mVal); }
-    friend SIMDType operator >= (const SIMDType& a, const SIMDType& b) { return _mm_cmple_ps(a.mVal, b.mVal); }
-    friend SIMDType operator <= (const SIMDType& a, const SIMDType& b) { return _mm_cmpge_ps(a.mVal, b.mVal); }
+    friend SIMDType operator > (const SIMDType& a, const SIMDType& b) { return _mm_cmpgt_ps(a.mVal, b.mVal); }
+    friend SIMDType operator < (const SIMDType& a, const SIMDType& b) { return _mm_cmplt_ps(a.mVal, b.mVal); }
+    friend SIMDType operator >= (const SIMDType& a, const SIMDType& b) { return _mm_cmpge_ps(a.mVal, b.mVal); }
+    friend SIMDType operator <= (const SIMDType& a, const SIMDType& b) { return _mm_cmple_ps(a.mVal, b.mVal); }
     
     template <int z, int y, int x, int w> static SIMDType shuffle(const SIMDType& a, const SIMDType& b)
     {
@@ -539,6 +557,8 @@ struct SIMDType<double, 4> : public SIMDVector<double, __m256d, 4>
     
     friend SIMDType round(const SIMDType& a) { return _mm256_round_pd(a.mVal, _MM_FROUND_TO_NEAREST_INT |_MM_FROUND_NO_EXC); }
     friend SIMDType trunc(const SIMDType& a) { return _mm256_round_pd(a.mVal, _MM_FROUND_TO_ZERO |_MM_FROUND_NO_EXC); }
+    friend SIMDType floor(const SIMDType& a) { return _mm256_floor_pd(a.mVal); }
+    friend SIMDType ceil(const SIMDType& a) { return _mm256_ceil_pd(a.mVal); }
     
     friend SIMDType min(const SIMDType& a, const SIMDType& b) { return _mm256_min_pd(a.mVal, b.mVal); }
     friend SIMDType max(const SIMDType& a, const SIMDType& b) { return _mm256_max_pd(a.mVal, b.mVal); }
@@ -584,6 +604,8 @@ struct SIMDType<float, 8> : public SIMDVector<float, __m256, 8>
     
     friend SIMDType round(const SIMDType& a) { return _mm256_round_ps(a.mVal, _MM_FROUND_TO_NEAREST_INT |_MM_FROUND_NO_EXC); }
     friend SIMDType trunc(const SIMDType& a) { return _mm256_round_ps(a.mVal, _MM_FROUND_TO_ZERO |_MM_FROUND_NO_EXC); }
+    friend SIMDType floor(const SIMDType& a) { return _mm256_floor_ps(a.mVal); }
+    friend SIMDType ceil(const SIMDType& a) { return _mm256_ceil_ps(a.mVal); }
     
     friend SIMDType min(const SIMDType& a, const SIMDType& b) { return _mm256_min_ps(a.mVal, b.mVal); }
     friend SIMDType max(const SIMDType& a, const SIMDType& b) { return _mm256_max_ps(a.mVal, b.mVal); }
@@ -640,6 +662,11 @@ struct SIMDType<double, 8> : public SIMDVector<double, __m512d, 8>
     
     friend SIMDType sqrt(const SIMDType& a) { return _mm512_sqrt_pd(a.mVal); }
     
+    friend SIMDType round(const SIMDType& a) { return _mm512_roundscale_pd(a.mVal, _MM_FROUND_TO_NEAREST_INT |_MM_FROUND_NO_EXC); }
+    friend SIMDType trunc(const SIMDType& a) { return _mm512_roundscale_pd(a.mVal, _MM_FROUND_TO_ZERO |_MM_FROUND_NO_EXC); }
+    friend SIMDType floor(const SIMDType& a) { return _mm512_roundscale_pd(a.mVal, _MM_FROUND_TO_NEG_INF |_MM_FROUND_NO_EXC); }
+    friend SIMDType ceil(const SIMDType& a) { return _mm512_roundscale_pd(a.mVal, _MM_FROUND_TO_POS_INF |_MM_FROUND_NO_EXC); }
+    
     friend SIMDType min(const SIMDType& a, const SIMDType& b) { return _mm512_min_pd(a.mVal, b.mVal); }
     friend SIMDType max(const SIMDType& a, const SIMDType& b) { return _mm512_max_pd(a.mVal, b.mVal); }
     friend SIMDType sel(const SIMDType& a, const SIMDType& b, const SIMDType& c) { return and_not(c, a) | (b & c); }
@@ -649,12 +676,16 @@ struct SIMDType<double, 8> : public SIMDVector<double, __m512d, 8>
     friend SIMDType operator | (const SIMDType& a, const SIMDType& b) { return _mm512_or_pd(a.mVal, b.mVal); }
     friend SIMDType operator ^ (const SIMDType& a, const SIMDType& b) { return _mm512_xor_pd(a.mVal, b.mVal); }
     
-    friend SIMDType operator == (const SIMDType& a, const SIMDType& b) { return _mm512_cmp_pd_mask(a.mVal, b.mVal, _CMP_EQ_OQ); }
-    friend SIMDType operator != (const SIMDType& a, const SIMDType& b) { return _mm512_cmp_pd_mask(a.mVal, b.mVal, _CMP_NEQ_UQ); }
-    friend SIMDType operator > (const SIMDType& a, const SIMDType& b) { return _mm512_cmp_pd_mask(a.mVal, b.mVal, _CMP_GT_OQ); }
-    friend SIMDType operator < (const SIMDType& a, const SIMDType& b) { return _mm512_cmp_pd_mask(a.mVal, b.mVal, _CMP_LT_OQ); }
-    friend SIMDType operator >= (const SIMDType& a, const SIMDType& b) { return _mm512_cmp_pd_mask(a.mVal, b.mVal, _CMP_GE_OQ); }
-    friend SIMDType operator <= (const SIMDType& a, const SIMDType& b) { return _mm512_cmp_pd_mask(a.mVal, b.mVal, _CMP_LE_OQ); }
+    // N.B. comparisons return a vector mask (as for other vector sizes) so that they can be used with sel()
+    
+    static SIMDType mask(__mmask8 m) { return _mm512_castsi512_pd(_mm512_maskz_set1_epi64(m, -1)); }
+    
+    friend SIMDType operator == (const SIMDType& a, const SIMDType& b) { return mask(_mm512_cmp_pd_mask(a.mVal, b.mVal, _CMP_EQ_OQ)); }
+    friend SIMDType operator != (const SIMDType& a, const SIMDType& b) { return mask(_mm512_cmp_pd_mask(a.mVal, b.mVal, _CMP_NEQ_UQ)); }
+    friend SIMDType operator > (const SIMDType& a, const SIMDType& b) { return mask(_mm512_cmp_pd_mask(a.mVal, b.mVal, _CMP_GT_OQ)); }
+    friend SIMDType operator < (const SIMDType& a, const SIMDType& b) { return mask(_mm512_cmp_pd_mask(a.mVal, b.mVal, _CMP_LT_OQ)); }
+    friend SIMDType operator >= (const SIMDType& a, const SIMDType& b) { return mask(_mm512_cmp_pd_mask(a.mVal, b.mVal, _CMP_GE_OQ)); }
+    friend SIMDType operator <= (const SIMDType& a, const SIMDType& b) { return mask(_mm512_cmp_pd_mask(a.mVal, b.mVal, _CMP_LE_OQ)); }
     
     operator SIMDType<float, 8>() { return _mm512_cvtpd_ps(mVal); }
 };
@@ -681,6 +712,11 @@ struct SIMDType<float, 16> : public SIMDVector<float, __m512, 16>
     
     friend SIMDType sqrt(const SIMDType& a) { return _mm512_sqrt_ps(a.mVal); }
     
+    friend SIMDType round(const SIMDType& a) { return _mm512_roundscale_ps(a.mVal, _MM_FROUND_TO_NEAREST_INT |_MM_FROUND_NO_EXC); }
+    friend SIMDType trunc(const SIMDType& a) { return _mm512_roundscale_ps(a.mVal, _MM_FROUND_TO_ZERO |_MM_FROUND_NO_EXC); }
+    friend SIMDType floor(const SIMDType& a) { return _mm512_roundscale_ps(a.mVal, _MM_FROUND_TO_NEG_INF |_MM_FROUND_NO_EXC); }
+    friend SIMDType ceil(const SIMDType& a) { return _mm512_roundscale_ps(a.mVal, _MM_FROUND_TO_POS_INF |_MM_FROUND_NO_EXC); }
+    
     friend SIMDType min(const SIMDType& a, const SIMDType& b) { return _mm512_min_ps(a.mVal, b.mVal); }
     friend SIMDType max(const SIMDType& a, const SIMDType& b) { return _mm512_max_ps(a.mVal, b.mVal); }
     friend SIMDType sel(const SIMDType& a, const SIMDType& b, const SIMDType& c) { return and_not(c, a) | (b & c); }
@@ -690,12 +726,16 @@ struct SIMDType<float, 16> : public SIMDVector<float, __m512, 16>
     friend SIMDType operator | (const SIMDType& a, const SIMDType& b) { return _mm512_or_ps(a.mVal, b.mVal); }
     friend SIMDType operator ^ (const SIMDType& a, const SIMDType& b) { return _mm512_xor_ps(a.mVal, b.mVal); }
     
-    friend SIMDType operator == (const SIMDType& a, const SIMDType& b) { return _mm512_cmp_ps_mask(a.mVal, b.mVal, _CMP_EQ_OQ); }
-    friend SIMDType operator != (const SIMDType& a, const SIMDType& b) { return _mm512_cmp_ps_mask(a.mVal, b.mVal, _CMP_NEQ_UQ); }
-    friend SIMDType operator > (const SIMDType& a, const SIMDType& b) { return _mm512_cmp_ps_mask(a.mVal, b.mVal, _CMP_GT_OQ); }
-    friend SIMDType operator < (const SIMDType& a, const SIMDType& b) { return _mm512_cmp_ps_mask(a.mVal, b.mVal, _CMP_LT_OQ); }
-    friend SIMDType operator >= (const SIMDType& a, const SIMDType& b) { return _mm512_cmp_ps_mask(a.mVal, b.mVal, _CMP_GE_OQ); }
-    friend SIMDType operator <= (const SIMDType& a, const SIMDType& b) { return _mm512_cmp_ps_mask(a.mVal, b.mVal, _CMP_LE_OQ); }
+    // N.B. comparisons return a vector mask (as for other vector sizes) so that they can be used with sel()
+    
+    static SIMDType mask(__mmask16 m) { return _mm512_castsi512_ps(_mm512_maskz_set1_epi32(m, -1)); }
+    
+    friend SIMDType operator == (const SIMDType& a, const SIMDType& b) { return mask(_mm512_cmp_ps_mask(a.mVal, b.mVal, _CMP_EQ_OQ)); }
+    friend SIMDType operator != (const SIMDType& a, const SIMDType& b) { return mask(_mm512_cmp_ps_mask(a.mVal, b.mVal, _CMP_NEQ_UQ)); }
+    friend SIMDType operator > (const SIMDType& a, const SIMDType& b) { return mask(_mm512_cmp_ps_mask(a.mVal, b.mVal, _CMP_GT_OQ)); }
+    friend SIMDType operator < (const SIMDType& a, const SIMDType& b) { return mask(_mm512_cmp_ps_mask(a.mVal, b.mVal, _CMP_LT_OQ)); }
+    friend SIMDType operator >= (const SIMDType& a, const SIMDType& b) { return mask(_mm512_cmp_ps_mask(a.mVal, b.mVal, _CMP_GE_OQ)); }
+    friend SIMDType operator <= (const SIMDType& a, const SIMDType& b) { return mask(_mm512_cmp_ps_mask(a.mVal, b.mVal, _CMP_LE_OQ)); }
 };
 
 #endif
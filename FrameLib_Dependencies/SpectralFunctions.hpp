@@ -267,8 +267,7 @@ namespace impl
         template<class T>
         void operator()(T& r_out, T& i_out, const T& a, const T& b, const T& c, const T& d, const T& scale, uintptr_t i)
         {
-            r_out = scale * (a * c + b * d);
-            i_out = scale * (b * c - a * d);
+            store(r_out, i_out, scale * (a * c + b * d), scale * (b * c - a * d));
         }
     };
     
@@ -277,8 +276,7 @@ namespace impl
         template<class T>
         void operator()(T& r_out, T& i_out, const T& a, const T& b, const T& c, const T& d, const T& scale, uintptr_t i)
         {
-            r_out = scale * (a * c - b * d);
-            i_out = scale * (a * d + b * c);
+            store(r_out, i_out, scale * (a * c - b * d), scale * (a * d + b * c));
         }
     };
     
@@ -345,6 +343,7 @@ struct FFTTypes
 {
     using Split = void;
     using Setup = void;
+    using ArbitrarySetup = void;
 };
 
 template<>
@@ -352,6 +351,7 @@ struct FFTTypes<float>
 {
     using Split = FFT_SPLIT_COMPLEX_F;
     using Setup = FFT_SETUP_F;
+    using ArbitrarySetup = FFT_ARBITRARY_SETUP_F;
 };
 
 template<>
@@ -359,6 +359,7 @@ struct FFTTypes<double>
 {
     using Split = FFT_SPLIT_COMPLEX_D;
     using Setup = FFT_SETUP_D;
+    using ArbitrarySetup = FFT_ARBITRARY_SETUP_D;
 };
 
 // Function calls
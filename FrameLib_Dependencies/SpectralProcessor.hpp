@@ -14,6 +14,7 @@ class spectral_processor
 {
     using Split = typename FFTTypes<T>::Split;
     using Setup = typename FFTTypes<T>::Setup;
+    using ArbitrarySetup = typename FFTTypes<T>::ArbitrarySetup;
     
     template <bool B>
     using enable_if_t = typename std::enable_if<B>::type;
@@ -32,44 +33,57 @@ public:
     
     // Constructor
     
+    // N.B. a max_fft_size of zero creates no setup (for use with set_fft_setup())
+    
     template <typename U = Allocator, typename = enable_if_t<std::is_default_constructible<U>::value>>
-    spectral_processor() :  m_max_fft_size_log2(0)
+    spectral_processor(uintptr_t max_fft_size = 32768) :  m_max_fft_size_log2(0), m_owns_setup(false), m_arbitrary_setup(nullptr), m_arbitrary_length(0)
     {
-        set_max_fft_size(32768);
+        set_max_fft_size(max_fft_size);
     }
     
     template <typename U = Allocator, typename = enable_if_t<std::is_copy_constructible<U>::value>>
-    spectral_processor(const Allocator& allocator) : m_allocator(allocator), m_max_fft_size_log2(0)
+    spectral_processor(const Allocator& allocator, uintptr_t max_fft_size = 32768) : m_allocator(allocator), m_max_fft_size_log2(0), m_owns_setup(false), m_arbitrary_setup(nullptr), m_arbitrary_length(0)
     {
-        set_max_fft_size(32768);
+        set_max_fft_size(max_fft_size);
     }
     
     template <typename U = Allocator, typename = enable_if_t<std::is_move_constructible<U>::value>>
-    spectral_processor(Allocator&& allocator) : m_allocator(allocator), m_max_fft_size_log2(0)
+    spectral_processor(Allocator&& allocator, uintptr_t max_fft_size = 32768) : m_allocator(allocator), m_max_fft_size_log2(0), m_owns_setup(false), m_arbitrary_setup(nullptr), m_arbitrary_length(0)
     {
-        set_max_fft_size(32768);
+        set_max_fft_size(max_fft_size);
     }
     
     ~spectral_processor()
     {
-        if (m_max_fft_size_log2)
-            hisstools_destroy_setup(m_fft_setup);
+        destroy_setup();
+        hisstools_destroy_arbitrary_setup(m_arbitrary_setup);
+        m_cached_spectra[0].release(m_allocator);
+        m_cached_spectra[1].release(m_allocator);
     }
     
     void set_max_fft_size(uintptr_t size)
     {
         uintptr_t fft_size_log2 = calc_fft_size_log2(size);
         
-        if (fft_size_log2 != m_max_fft_size_log2)
+        if (fft_size_log2 != m_max_fft_size_log2 || !m_owns_setup)
         {
-            if (m_max_fft_size_log2)
-                hisstools_destroy_setup(m_fft_setup);
+            destroy_setup();
             if (fft_size_log2)
                 hisstools_create_setup(&m_fft_setup, fft_size_log2);
             m_max_fft_size_log2 = fft_size_log2;
+            m_owns_setup = fft_size_log2 != 0;
         }
     }
     
+    // Use a setup that is owned elsewhere (it must support sizes up to 2^max_fft_size_log2 and outlive its use here)
+    
+    void set_fft_setup(Setup setup, uintptr_t max_fft_size_log2)
+    {
+        destroy_setup();
+        m_fft_setup = setup;
+        m_max_fft_size_log2 = max_fft_size_log2;
+    }
+    
     uintptr_t max_fft_size() const { return 1 << m_max_fft_size_log2; }
     
     // Transforms
@@ -104,6 +118,120 @@ public:
         hisstools_rifft(m_fft_setup, &input, output, fft_size_log2);
     }
     
+    // Arbitrary Length Transforms
+    
+    // N.B. the setup for the most recent length is kept (and is recreated whenever the length changes)
+    
+    void fft_arbitrary(Split& io, uintptr_t length)
+    {
+        if (ArbitrarySetup setup = arbitrary_setup(length))
+            hisstools_fft(setup, &io);
+    }
+    
+    void ifft_arbitrary(Split& io, uintptr_t length)
+    {
+        if (ArbitrarySetup setup = arbitrary_setup(length))
+            hisstools_ifft(setup, &io);
+    }
+    
+    // Real transforms output the (length >> 1) + 1 unique bins unpacked and unscaled
+    
+    void rfft_arbitrary(Split& output, const T *input, uintptr_t size, uintptr_t length)
+    {
+        if (!(length & 1U))
+        {
+            if (ArbitrarySetup setup = arbitrary_setup(length >> 1))
+                hisstools_rfft(setup, input, &output, size);
+            return;
+        }
+        
+        // Odd lengths use a complex transform with a zero imaginary input
+        
+        temporary_buffers<1> buffer(m_allocator, length);
+        
+        if (!buffer)
+            return;
+        
+        Split& spectrum = buffer.m_spectra[0];
+        
+        size = std::min(size, length);
+        std::copy(input, input + size, spectrum.realp);
+        std::fill_n(spectrum.realp + size, length - size, T(0));
+        std::fill_n(spectrum.imagp, length, T(0));
+        
+        fft_arbitrary(spectrum, length);
+        
+        std::copy(spectrum.realp, spectrum.realp + (length >> 1) + 1, output.realp);
+        std::copy(spectrum.imagp, spectrum.imagp + (length >> 1) + 1, output.imagp);
+    }
+    
+    // Real inverse transforms take (length >> 1) + 1 unpacked bins (for even lengths the input is used as working memory)
+    
+    void rifft_arbitrary(T *output, Split& input, uintptr_t length)
+    {
+        if (!(length & 1U))
+        {
+            if (ArbitrarySetup setup = arbitrary_setup(length >> 1))
+                hisstools_rifft(setup, &input, output);
+            return;
+        }
+        
+        // Odd lengths use a complex transform of the conjugate symmetric spectrum
+        
+        temporary_buffers<1> buffer(m_allocator, length);
+        
+        if (!buffer)
+            return;
+        
+        Split& spectrum = buffer.m_spectra[0];
+        
+        uintptr_t bins = (length >> 1) + 1;
+        
+        std::copy(input.realp, input.realp + bins, spectrum.realp);
+        std::copy(input.imagp, input.imagp + bins, spectrum.imagp);
+        
+        mirror_spectrum(spectrum, length);
+        
+        ifft_arbitrary(spectrum, length);
+        
+        std::copy(spectrum.realp, spectrum.realp + length, output);
+    }
+    
+    // Conjugate Symmetry
+    
+    // Fill the upper bins of a full spectrum from the (length >> 1) + 1 unique bins of a real signal
+    
+    static void mirror_spectrum(Split& io, uintptr_t length)
+    {
+        if (length < 3)
+            return;
+        
+        const T *r_in = io.realp + ((length - 1) >> 1);
+        const T *i_in = io.imagp + ((length - 1) >> 1);
+        T *r_out = io.realp + (length >> 1) + 1;
+        T *i_out = io.imagp + (length >> 1) + 1;
+        
+        for (uintptr_t i = 0; i < ((length - 1) >> 1); i++)
+        {
+            r_out[i] = r_in[-static_cast<intptr_t>(i)];
+            i_out[i] = -i_in[-static_cast<intptr_t>(i)];
+        }
+    }
+    
+    // Test whether a full spectrum is exactly that of a real signal (in which case the real inverse transform may be used)
+    
+    static bool is_conjugate_symmetric(const Split& io, uintptr_t length)
+    {
+        if (!length || io.imagp[0] != T(0) || (!(length & 1U) && io.imagp[length >> 1] != T(0)))
+            return false;
+        
+        for (uintptr_t i = 1; i < ((length + 1) >> 1); i++)
+            if (io.realp[i] != io.realp[length - i] || io.imagp[i] != -io.imagp[length - i])
+                return false;
+        
+        return true;
+    }
+    
     // Convolution
     
     void convolve(T *r_out, T *i_out, in_ptr r_in1, in_ptr i_in1, in_ptr r_in2, in_ptr i_in2, EdgeMode mode)
@@ -128,6 +256,15 @@ public:
         binary_op<&ir_correlate_real, &arrange_correlate<T*>>(output, in1, in2, mode);
     }
     
+    // Correlation with cached spectra (each input is only transformed when it or the FFT size changes)
+    
+    // N.B. a copy and spectrum of each input is kept, which suits inputs that are often unchanged (such as a fixed template)
+    
+    void correlate_cached(T *output, in_ptr in1, in_ptr in2, EdgeMode mode)
+    {
+        binary_op_cached<&ir_correlate_real, &arrange_correlate<T*>>(output, in1, in2, mode);
+    }
+    
     // Phase
     
     void change_phase(T *output, const T *input, uintptr_t size, double phase)
@@ -280,8 +417,71 @@ protected:
         uintptr_t m_size1, m_size2, m_fft_size_log2;
     };
     
+    // A cached real spectrum of an input
+    
+    struct cached_spectrum
+    {
+        // Return the spectrum (or nullptr if memory cannot be allocated) transforming only if needed
+        
+        Split *get(spectral_processor& processor, in_ptr in, uintptr_t fft_size_log2)
+        {
+            if (m_memory && in.m_size == m_size && fft_size_log2 == m_fft_size_log2)
+            {
+                if (std::equal(in.m_ptr, in.m_ptr + in.m_size, m_data))
+                    return &m_spectrum;
+            }
+            
+            uintptr_t fft_size = uintptr_t(1) << fft_size_log2;
+            uintptr_t required = fft_size + in.m_size;
+            
+            if (required > m_capacity)
+            {
+                release(processor.m_allocator);
+                m_memory = processor.m_allocator.template allocate<T>(required);
+                m_capacity = m_memory ? required : 0;
+            }
+            
+            if (!m_memory)
+                return nullptr;
+            
+            // N.B. the spectrum is placed first to keep it aligned
+            
+            m_spectrum = { m_memory, m_memory + (fft_size >> 1) };
+            m_data = m_memory + fft_size;
+            m_size = in.m_size;
+            m_fft_size_log2 = fft_size_log2;
+            
+            std::copy_n(in.m_ptr, in.m_size, m_data);
+            processor.rfft(m_spectrum, in.m_ptr, in.m_size, fft_size_log2);
+            
+            return &m_spectrum;
+        }
+        
+        void release(Allocator& allocator)
+        {
+            if (m_memory)
+                allocator.deallocate(m_memory);
+            
+            m_memory = nullptr;
+            m_capacity = 0;
+        }
+        
+        T *m_memory = nullptr;
+        T *m_data = nullptr;
+        Split m_spectrum;
+        uintptr_t m_capacity = 0;
+        uintptr_t m_size = 0;
+        uintptr_t m_fft_size_log2 = 0;
+    };
+    
     // Memory manipulation (complex)
     
+    static T first(in_ptr in)
+    {
+        return in.m_size ? in.m_ptr[0] : T(0);
+    }
+    
+    
     static void copy_zero(T* output, in_ptr in, uintptr_t size)
     {
         std::copy_n(in.m_ptr, in.m_size, output);
@@ -457,8 +657,10 @@ protected:
 
         if (size1 == 1 && size2 == 1)
         {
-            r_out[0] = r_in1.m_ptr[0] * r_in2.m_ptr[0] + i_in1.m_ptr[0] * i_in2.m_ptr[0];
-            i_out[0] = r_in1.m_ptr[0] * i_in2.m_ptr[0] - i_in1.m_ptr[0] * i_in1.m_ptr[0];
+            T r1 = first(r_in1), i1 = first(i_in1), r2 = first(r_in2), i2 = first(i_in2);
+            Split in1 {&r1, &i1}, in2 {&r2, &i2}, out {r_out, i_out};
+            
+            Op(&out, &in1, &in2, 1, T(1));
             return;
         }
         
@@ -516,11 +718,69 @@ protected:
         }
     }
     
+    template<SpectralOp Op, RealArrange arrange>
+    void binary_op_cached(T *output, in_ptr in1, in_ptr in2, EdgeMode mode)
+    {
+        if (!calc_conv_corr_size(in1.m_size, in2.m_size, mode))
+            return;
+        
+        // Special case for single sample inputs
+        
+        if (in1.m_size == 1 && in2.m_size == 1)
+        {
+            output[0] = in1.m_ptr[0] * in2.m_ptr[0];
+            return;
+        }
+        
+        // Assign temporary memory and get the spectra
+        
+        binary_sizes sizes(in1.m_size, in2.m_size);
+        temporary_buffers<1> buffers(m_allocator, sizes.fft() >> 1);
+        Split *spectrum1 = m_cached_spectra[0].get(*this, in1, sizes.fft_log2());
+        Split *spectrum2 = m_cached_spectra[1].get(*this, in2, sizes.fft_log2());
+        
+        // Process
+        
+        if (buffers && spectrum1 && spectrum2)
+        {
+            Op(&buffers.m_spectra[0], spectrum1, spectrum2, sizes.fft(), 0.25 / (T) sizes.fft());
+            rifft(buffers.m_spectra[0], sizes.fft_log2());
+            arrange(output, buffers.m_spectra[0], sizes, mode);
+        }
+    }
+    
+    // Setup Destruction (only for setups owned by the processor)
+    
+    void destroy_setup()
+    {
+        if (m_owns_setup)
+            hisstools_destroy_setup(m_fft_setup);
+        m_owns_setup = false;
+    }
+    
+    // Arbitrary Setup (created on demand for a given complex length)
+    
+    ArbitrarySetup arbitrary_setup(uintptr_t length)
+    {
+        if (length != m_arbitrary_length || !m_arbitrary_setup)
+        {
+            hisstools_destroy_arbitrary_setup(m_arbitrary_setup);
+            hisstools_create_arbitrary_setup(&m_arbitrary_setup, length);
+            m_arbitrary_length = length;
+        }
+        
+        return m_arbitrary_setup;
+    }
+    
     // Data
     
     Allocator m_allocator;
     Setup m_fft_setup;
     uintptr_t m_max_fft_size_log2;
+    bool m_owns_setup;
+    ArbitrarySetup m_arbitrary_setup;
+    uintptr_t m_arbitrary_length;
+    cached_spectrum m_cached_spectra[2];
 };
 
 #endif
@@ -73,6 +73,8 @@
 
 #include "FrameLib_FFT.h"
 #include "FrameLib_iFFT.h"
+#include "FrameLib_STFT.h"
+#include "FrameLib_ISTFT.h"
 #include "FrameLib_Correlate.h"
 #include "FrameLib_Convolve.h"
 #include "FrameLib_Multitaper.h"
@@ -111,6 +113,7 @@
 
 #include "FrameLib_AccumPoint.h"
 #include "FrameLib_Chop.h"
+#include "FrameLib_Descriptors.h"
 #include "FrameLib_Join.h"
 #include "FrameLib_MedianFilter.h"
 #include "FrameLib_NanFilter.h"
@@ -85,6 +85,8 @@ FrameLib_Spatial,
 
 FrameLib_FFT,
 FrameLib_iFFT,
+FrameLib_STFT,
+FrameLib_ISTFT,
 FrameLib_Correlate,
 FrameLib_Convolve,
 FrameLib_Multitaper,
@@ -121,6 +123,7 @@ FrameLib_Timer,
 
 FrameLib_AccumPoint,
 FrameLib_Chop,
+FrameLib_Descriptors,
 FrameLib_Join,
 FrameLib_MedianFilter,
 FrameLib_NonZero,
@@ -72,6 +72,136 @@ class FrameLib_Context
 
 public:
     
+    /**
+     
+     @class FFTSetup
+     
+     @brief a reference to an FFT setup shared between all contexts of the global object.
+     
+     This is a non-copyable class that uses RAII to release the setup. The template parameter is the setup type (FFT_SETUP_D or FFT_SETUP_F).
+     
+     */
+    
+    template <class T>
+    class FFTSetup
+    {
+    
+    public:
+        
+        // Constructor / Destructor
+        
+        FFTSetup(const FrameLib_Context &context) : mSetups(context.mGlobal->mFFTSetups), mSetup(nullptr), mMaxLog2(0) {}
+        ~FFTSetup() { release(); }
+        
+        // Non-copyable
+        
+        FFTSetup(const FFTSetup&) = delete;
+        FFTSetup& operator=(const FFTSetup&) = delete;
+        
+        // Acquire a setup for sizes up to 2^maxLog2 (replacing any current setup)
+        
+        void acquire(uintptr_t maxLog2)
+        {
+            T previous = mSetup;
+            
+            mSetup = nullptr;
+            
+            if (maxLog2)
+                mSetups.acquire(&mSetup, maxLog2);
+            if (previous)
+                mSetups.release(previous);
+            
+            mMaxLog2 = maxLog2;
+        }
+        
+        void release()
+        {
+            if (mSetup)
+                mSetups.release(mSetup);
+            
+            mSetup = nullptr;
+            mMaxLog2 = 0;
+        }
+        
+        // Getters
+        
+        T get() const                   { return mSetup; }
+        uintptr_t getMaxLog2() const    { return mMaxLog2; }
+    
+    private:
+        
+        // Member Variables
+        
+        FrameLib_FFTSetups& mSetups;
+        T mSetup;
+        uintptr_t mMaxLog2;
+    };
+    
+    /**
+     
+     @class WindowTable
+     
+     @brief a reference to an immutable window table shared between all contexts of the global object.
+     
+     This is a non-copyable class that uses RAII to release the table. Acquiring a table with the current settings does not access the cache.
+     
+     */
+    
+    class WindowTable
+    {
+    
+    public:
+        
+        using Table = FrameLib_WindowCache::Table;
+        using WindowTypes = FrameLib_WindowCache::WindowTypes;
+        
+        // Constructor / Destructor
+        
+        WindowTable(const FrameLib_Context &context) : mCache(context.mGlobal->mWindowCache), mTable(nullptr) {}
+        ~WindowTable() { release(); }
+        
+        // Non-copyable
+        
+        WindowTable(const WindowTable&) = delete;
+        WindowTable& operator=(const WindowTable&) = delete;
+        
+        // Acquire a table (replacing any current table) - returns a nullptr if memory cannot be allocated
+        
+        const Table *acquire(WindowTypes type, uint32_t size, uint32_t generateSize, bool sqrtWindow)
+        {
+            if (mTable && mTable->mType == type && mTable->mSize == size && mTable->mGenerateSize == generateSize && mTable->mSqrt == sqrtWindow)
+                return mTable;
+            
+            const Table *previous = mTable;
+            
+            mTable = mCache.acquire(type, size, generateSize, sqrtWindow);
+            
+            if (previous)
+                mCache.release(previous);
+            
+            return mTable;
+        }
+        
+        void release()
+        {
+            if (mTable)
+                mCache.release(mTable);
+            
+            mTable = nullptr;
+        }
+        
+        // Getter
+        
+        const Table *get() const    { return mTable; }
+    
+    private:
+        
+        // Member Variables
+        
+        FrameLib_WindowCache& mCache;
+        const Table *mTable;
+    };
+    
     // Constructor - the reference should be a suitable reference address in the host environment
     
     FrameLib_Context(FrameLib_Global *global, void *reference) : mGlobal(global), mReference(reference) {}
@@ -92,6 +222,7 @@ public:
     
     using Allocator = ManagedPointer<FrameLib_LocalAllocator, &FrameLib_Global::mLocalAllocators>;
     using ProcessingQueue = ManagedPointer<FrameLib_ProcessingQueue, &FrameLib_Global::mProcessingQueues>;
+    using Profiler = ManagedPointer<FrameLib_Profiler, &FrameLib_Global::mProfilers>;
 
     // Get the global as a FrameLib_ErrorReporter from the context
     
@@ -4,17 +4,35 @@
 // Constructor / Destructor
 
 FrameLib_DSP::FrameLib_DSP(ObjectType type, FrameLib_Context context, FrameLib_Proxy *proxy, FrameLib_Parameters::Info *info, unsigned long nIns, unsigned long nOuts, unsigned long nAudioChans)
-: FrameLib_Block(type, context, proxy), mSamplingRate(44100.0), mMaxBlockSize(4096), mParameters(context, proxy, info), mProcessingQueue(context), mNext(nullptr), mNoLiveInputs(true), mInUpdate(false)
+: FrameLib_Block(type, context, proxy), mSamplingRate(44100.0), mMaxBlockSize(4096), mParameters(context, proxy, info), mProcessingQueue(context), mNext(nullptr)
+#ifdef FRAMELIB_PROFILING
+, mProfiler(context)
+#endif
+, mScheduleRoot(nullptr), mScheduleGeneration(0), mScheduleIndex(0), mNoLiveInputs(true), mInUpdate(false), mOutputMemoryStolen(false), mLowPriority(false), mDropped(false)
 {
     // Set IO
     
     setIO(nIns, nOuts, nAudioChans);
+    mLockOrder.push_back(this);
+
+#ifdef FRAMELIB_PROFILING
+    mProfiler->addEntry(&mProfileEntry, proxy);
+#endif
 }
 
 // Destructor
 
 FrameLib_DSP::~FrameLib_DSP()
 {
+    // Remove from any compiled schedule
+    
+    clearSchedule();
+    mProcessingQueue->invalidateSchedules();
+    
+#ifdef FRAMELIB_PROFILING
+    mProfiler->removeEntry(&mProfileEntry);
+#endif
+    
     // Free output
     
     freeOutputMemory();
@@ -57,8 +75,9 @@ const double *FrameLib_DSP::getFixedInput(unsigned long idx, unsigned long *size
 
 void FrameLib_DSP::blockUpdate(const double * const *ins, double **outs, unsigned long blockSize)
 {
-    // Update block time and process the block
+    // Notify the queue of the block start (before updating the block time) then update block time and process the block
     
+    mProcessingQueue->blockStart(mBlockEndTime);
     mBlockStartTime = mBlockEndTime;
     mBlockEndTime += blockSize;
     blockProcess(ins, outs, blockSize);
@@ -66,7 +85,7 @@ void FrameLib_DSP::blockUpdate(const double * const *ins, double **outs, unsigne
     // If the object is handling audio updates (but is not an output object) then notify
     
     if (requiresAudioNotification())
-        dependencyNotify(false, true);
+        dependencyNotify(false, true, true);
 }
 
 // Reset
@@ -80,6 +99,11 @@ void FrameLib_DSP::reset(double samplingRate, unsigned long maxBlockSize)
     
     LocalQueue(this, &FrameLib_DSP::reset);
     
+    // Compile the schedule for the connected network if it is out of date
+    
+    if (mScheduleGeneration != mProcessingQueue->getScheduleGeneration())
+        compileSchedule();
+    
     mProcessingQueue->reset();
 }
 
@@ -87,6 +111,10 @@ void FrameLib_DSP::reset(LocalQueue *queue)
 {
     bool prevNoLiveInputs = mNoLiveInputs;
 
+#ifdef FRAMELIB_PROFILING
+    mProfileEntry.setType(typeid(*this));
+#endif
+    
     // Object specific reset
     
     objectReset();
@@ -112,6 +140,7 @@ void FrameLib_DSP::reset(LocalQueue *queue)
     
     freeOutputMemory();
     mOutputDone = false;
+    mDropped = false;
 
     // Reset times (Note that the first sample is 1 so that we can start the frames *before* this with non-negative values)
 
@@ -241,6 +270,10 @@ bool FrameLib_DSP::allocateOutputs()
     
     if (pointer)
     {
+#ifdef FRAMELIB_PROFILING
+        mProfileEntry.addBytesAllocated(allocationSize);
+#endif
+        
         // Store pointers and create tagged outputs
         
         for (auto outs = mOutputs.begin(); outs != mOutputs.end(); outs++)
@@ -265,6 +298,42 @@ bool FrameLib_DSP::allocateOutputs()
     return false;
 }
 
+// In-place Output Allocation
+
+// The memory can be taken when this object is the only consumer of the input frame and will release it directly after processing
+
+bool FrameLib_DSP::allocateOutputsInPlace(unsigned long inIdx)
+{
+    FrameLib_DSP *object = mInputs[inIdx].mObject;
+    Output& output = mOutputs[0];
+    
+    bool canSteal = object && getNumOuts() == 1 && getType() != kScheduler && mInputDependencies.size() == 1;
+    
+    canSteal = canSteal && output.mRequestedType == kFrameNormal && output.mCurrentType == kFrameNormal && output.mRequestedSize;
+    
+    if (canSteal)
+    {
+        Output& input = object->mOutputs[0];
+        
+        canSteal = object->getNumOuts() == 1 && object->getNumOuputDependencies() == 1 && !object->mOutputMemoryStolen;
+        canSteal = canSteal && input.mMemory && input.mCurrentType == kFrameNormal && input.mCurrentSize == output.mRequestedSize;
+    }
+    
+    if (!canSteal)
+        return allocateOutputs();
+    
+    // Take the memory (the input object will not free it on release)
+    
+    freeOutputMemory();
+    
+    output.mCurrentSize = output.mRequestedSize;
+    output.mPointerOffset = 0;
+    output.mMemory = object->mOutputs[0].mMemory;
+    object->mOutputMemoryStolen = true;
+    
+    return true;
+}
+
 // Get Inputs and Outputs
 
 const double *FrameLib_DSP::getInput(unsigned long idx, unsigned long *size) const
@@ -341,29 +410,106 @@ void FrameLib_DSP::copyInputToOutput(unsigned long inIdx, unsigned long outIdx)
     }
 }
 
+// Frame Processing
+
+inline void FrameLib_DSP::processFrame()
+{
+    if (mProcessingQueue->hasDroppedFrames() && isTriggeredByDroppedFrames())
+    {
+        dropFrame();
+        return;
+    }
+    
+    mDropped = false;
+
+#ifdef FRAMELIB_PROFILING
+    FrameLib_Profiler::TimePoint start = FrameLib_Profiler::now();
+    process();
+    mProfiler->processed(mProfileEntry, start);
+#else
+    process();
+#endif
+    
+    mProcessingQueue->frameProcessed();
+}
+
+bool FrameLib_DSP::isTriggeredByDroppedFrames() const
+{
+    bool triggered = false;
+    
+    for (auto ins = mInputs.begin(); ins != mInputs.end(); ins++)
+    {
+        if (ins->mObject && ins->mTrigger && ins->mObject->mFrameTime == mFrameTime)
+        {
+            if (!ins->mObject->mDropped)
+                return false;
+            
+            triggered = true;
+        }
+    }
+    
+    return triggered;
+}
+
+void FrameLib_DSP::dropFrame()
+{
+    // Output empty frames in place of processing
+    
+    for (auto outs = mOutputs.begin(); outs != mOutputs.end(); outs++)
+        outs->mRequestedSize = 0;
+    
+    allocateOutputs();
+    
+    mDropped = true;
+    mProcessingQueue->frameDropped();
+}
+
+// Count Adjustment
+
+inline long FrameLib_DSP::adjustCount(std::atomic<long>& count, long amount)
+{
+    // Atomic read-modify-write is only required when the queue is processing with more than one thread
+    
+    if (mProcessingQueue->isParallel())
+        return count.fetch_add(amount) + amount;
+    
+    long value = count.load(std::memory_order_relaxed) + amount;
+    count.store(value, std::memory_order_relaxed);
+    
+    return value;
+}
+
 // Dependency Notification
 
-inline void FrameLib_DSP::dependencyNotify(bool releaseMemory, bool fromInput)
+inline void FrameLib_DSP::dependencyNotify(bool releaseMemory, bool fromInput, bool lock)
 {
     if (mProcessingQueue->isTimedOut())
         return;
     
-    assert(((mDependencyCount > 0) || (mUpdatingInputs && (mInputCount > 0))) && "Dependency count is already zero");
+    bool ready = false;
     
-    if (releaseMemory)
-        releaseOutputMemory();
+    // When processing in parallel the lock must be held unless the caller already holds it (but not whilst adding to the queue)
     
-    // If ready add to queue
-    
-    if (fromInput && mUpdatingInputs)
     {
-        if (--mInputCount == 0)
-           mProcessingQueue->add(this);
+        FrameLib_SpinLockHolder holder(lock && mProcessingQueue->isParallel() ? &mProcessingLock : nullptr);
+        
+        assert(((mDependencyCount > 0) || (mUpdatingInputs && (mInputCount > 0))) && "Dependency count is already zero");
+        
+        if (releaseMemory)
+            releaseOutputMemory();
+        
+        if (fromInput && mUpdatingInputs)
+            ready = adjustCount(mInputCount, -1) == 0;
+        else
+            ready = adjustCount(mDependencyCount, -1) == 0 && !mUpdatingInputs;
     }
-    else if (--mDependencyCount == 0 && !mUpdatingInputs)
+    
+    // If ready add to queue
+    
+    if (ready)
         mProcessingQueue->add(this);
     
-    // N.B. For multithreading re-entrancy needs to be avoided by increasing the dependency count before adding to the queue (with matching notification)
+    // N.B. Re-entrancy from other processing threads is avoided as dependenciesReady() holds an extra dependency count whilst processing (with matching notification)
 }
 
 // For updating the correct input count
@@ -371,9 +517,9 @@ inline void FrameLib_DSP::dependencyNotify(bool releaseMemory, bool fromInput)
 void FrameLib_DSP::incrementInputDependency()
 {
     if (mUpdatingInputs)
-        mInputCount++;
+        adjustCount(mInputCount, 1);
     else
-        mDependencyCount++;
+        adjustCount(mDependencyCount, 1);
 }
 
 // Main code to control time flow (called when all input/output dependencies are ready)
@@ -385,20 +531,36 @@ void FrameLib_DSP::dependenciesReady()
     FrameLib_TimeFormat prevInputTime = mInputTime;
 #endif
     
-    mDependencyCount++;
+    adjustCount(mDependencyCount, 1);
+    
+#ifdef FRAMELIB_PROFILING
+    mProfileEntry.addCall();
+#endif
+    
+    // When processing in parallel input objects may otherwise advance whilst their state and outputs are being read
+    
+    bool parallel = mProcessingQueue->isParallel();
+    
+    if (parallel)
+        for (auto it = mLockOrder.begin(); it != mLockOrder.end(); it++)
+            (*it)->mProcessingLock.acquire();
     
     bool timeUpdated = false;
     bool callUpdate = false;
     
     // Check for inputs at the current frame time that update (update parameters if requested)
     
+#ifdef FRAMELIB_PROFILING
+    FrameLib_Profiler::TimePoint updateStart = FrameLib_Profiler::now();
+#endif
+    
     for (auto ins = mInputs.begin(); ins != mInputs.end(); ins++)
     {
         if (ins->mObject && ins->mUpdate && mInputTime == ins->mObject->mFrameTime)
         {
             callUpdate = true;
             if (ins->mParameters)
-                mParameters.set(ins->mObject->getOutput(ins->mIndex));
+                mParameters.set(ins->mObject->getOutput(ins->mIndex), ins->mBinding);
         }
     }
     
@@ -409,6 +571,10 @@ void FrameLib_DSP::dependenciesReady()
         mInUpdate = true;
         update();
         mInUpdate = false;
+
+#ifdef FRAMELIB_PROFILING
+        mProfiler->updated(mProfileEntry, updateStart);
+#endif
     }
     
     if (getType() == kScheduler)
@@ -424,7 +590,14 @@ void FrameLib_DSP::dependenciesReady()
         // Schedule
         
         bool upToDate = (mValidTime >= mBlockEndTime) || mUpdatingInputs;
+#ifdef FRAMELIB_PROFILING
+        FrameLib_Profiler::TimePoint scheduleStart = FrameLib_Profiler::now();
+#endif
         SchedulerInfo scheduleInfo = schedule(mOutputDone && !upToDate, upToDate);
+#ifdef FRAMELIB_PROFILING
+        bool newFrame = !upToDate && scheduleInfo.mTimeAdvance.greaterThanZero() && (scheduleInfo.mNewFrame || mOutputDone);
+        mProfiler->processed(mProfileEntry, scheduleStart, newFrame);
+#endif
 
         // Check if time has been updated (limiting to positive advances only), and if so set output times
                 
@@ -434,6 +607,11 @@ void FrameLib_DSP::dependenciesReady()
             {
                 resetOutputDependencyCount();
                 mFrameTime = mValidTime;
+                
+                // Frames of low priority schedulers are dropped when over budget (objects triggered only by them are not processed)
+                
+                if ((mDropped = mLowPriority && mProcessingQueue->isDropping()))
+                    mProcessingQueue->frameDropped();
             }
             
             mValidTime += scheduleInfo.mTimeAdvance;
@@ -469,7 +647,7 @@ void FrameLib_DSP::dependenciesReady()
         if (trigger)
         {
             mFrameTime = prevValidTime;
-            process();
+            processFrame();
             resetOutputDependencyCount();
             if (mInputDependencies.size() == 1)
                 (*mInputDependencies.begin())->releaseOutputMemory();
@@ -513,7 +691,7 @@ void FrameLib_DSP::dependenciesReady()
 
     // Update dependency count for outputs and updating input state starting
     
-    mDependencyCount += ((timeUpdated ? getNumOuputDependencies() : 0)) + ((mUpdatingInputs > prevUpdatingInputs) ? 1 : 0);
+    adjustCount(mDependencyCount, ((timeUpdated ? getNumOuputDependencies() : 0)) + ((mUpdatingInputs > prevUpdatingInputs) ? 1 : 0));
     
     // Notify input dependencies that can be released as they are up to date (releasing memory where relevant for objects with more than one input dependency)
     
@@ -531,11 +709,18 @@ void FrameLib_DSP::dependenciesReady()
         }
     }
     
-    // If time has updated then notify output dependencies (of updates to their inputs)
+    // If time has updated then notify output dependencies (of updates to their inputs) and process any compiled schedule
     
     if (timeUpdated)
-        for (auto it = mOutputDependencies.begin(); it != mOutputDependencies.end(); it++)
-            (*it)->dependencyNotify(false, true);
+    {
+        if (!parallel)
+            for (auto it = mOutputDependencies.begin(); it != mOutputDependencies.end(); it++)
+                if ((*it)->mScheduleRoot != this)
+                    (*it)->dependencyNotify(false, true);
+        
+        for (auto it = mSchedule.begin(); it != mSchedule.end() && !mProcessingQueue->isTimedOut(); it++)
+            (*it)->scheduledUpdate();
+    }
     
     // See if the updating input status has expired (must be done after resolving all other dependencies)
     
@@ -554,17 +739,275 @@ void FrameLib_DSP::dependenciesReady()
     assert(mInputTime > prevInputTime && "Failed to move time forward");
     assert(mInputTime <= mValidTime && "Inputs are ahead of output");
     assert(mFrameTime <= mInputTime && "Output is ahead of input dependencies");
+    
+    // When processing in parallel release the locks before notifying outputs (which lock the output object)
+    
+    if (parallel)
+    {
+        for (auto it = mLockOrder.rbegin(); it != mLockOrder.rend(); it++)
+            (*it)->mProcessingLock.release();
+        
+        if (timeUpdated)
+            for (auto it = mOutputDependencies.begin(); it != mOutputDependencies.end(); it++)
+                (*it)->dependencyNotify(false, true, true);
+    }
 }
 
 void FrameLib_DSP::resetOutputDependencyCount()
 {
-    mOutputMemoryCount = getNumOuputDependencies();
+    mOutputMemoryCount.store(getNumOuputDependencies(), std::memory_order_relaxed);
+}
+
+// Compiled Schedule
+
+// Objects can be scheduled if they are not driven by audio and have only plain triggering inputs (so that input and valid times are always equal)
+
+bool FrameLib_DSP::isSchedulable()
+{
+    if (requiresAudioNotification() || mInputDependencies.empty())
+        return false;
+    
+    for (auto ins = mInputs.begin(); ins != mInputs.end(); ins++)
+        if (ins->mObject && (!ins->mTrigger || ins->mSwitchable || ins->mUpdate))
+            return false;
+    
+    return true;
+}
+
+// A reduced version of dependenciesReady() called by the root object once per advance of its time
+
+void FrameLib_DSP::scheduledUpdate()
+{
+    // N.B. all inputs advance with the root, so there is no need to count dependencies, notify outputs or self-notify
+    
+#ifdef FRAMELIB_PROFILING
+    mProfileEntry.addCall();
+#endif
+    
+    FrameLib_TimeFormat prevValidTime = mValidTime;
+    bool trigger = false;
+    mValidTime = FrameLib_TimeFormat::largest();
+    
+    for (auto it = mScheduledInputs.begin(); it != mScheduledInputs.end(); it++)
+    {
+        if ((*it)->mValidTime < mValidTime)
+            mValidTime = (*it)->mValidTime;
+        trigger |= prevValidTime == (*it)->mFrameTime;
+    }
+    
+    mInputTime = mValidTime;
+    
+    // If triggered update the frame time, process and release the inputs if we only have one dependency
+    
+    if (trigger)
+    {
+        mFrameTime = prevValidTime;
+        processFrame();
+        resetOutputDependencyCount();
+        if (mInputDependencies.size() == 1)
+            (*mInputDependencies.begin())->releaseOutputMemory();
+    }
+    
+    // Check for completion of the frame
+    
+    if (mValidTime != prevValidTime)
+    {
+        mOutputDone = true;
+        
+        for (auto it = mScheduledInputs.begin(); it != mScheduledInputs.end(); it++)
+        {
+            if (mValidTime == (*it)->mValidTime)
+            {
+                if ((mOutputDone = (*it)->mOutputDone))
+                    break;
+            }
+        }
+    }
+    
+    // Release input memory (notifying the root which counts dependencies as normal)
+    
+    if (mInputTime != FrameLib_TimeFormat::largest())
+    {
+        bool releaseMemory = mInputDependencies.size() != 1;
+        
+        for (auto it = mInputDependencies.begin(); it != mInputDependencies.end(); it++)
+        {
+            if (mInputTime == (*it)->mValidTime)
+            {
+                if (!(*it)->mScheduleRoot)
+                    (*it)->dependencyNotify(releaseMemory && (*it)->mOutputDone, false);
+                else if (releaseMemory && (*it)->mOutputDone)
+                    (*it)->releaseOutputMemory();
+            }
+        }
+    }
+    
+    assert(mInputTime > prevValidTime && "Failed to move time forward");
+    assert(mFrameTime <= mInputTime && "Output is ahead of input dependencies");
+}
+
+void FrameLib_DSP::compileSchedule()
+{
+    unsigned long generation = mProcessingQueue->getScheduleGeneration();
+    
+    // Gather the connected network, removing any previous schedules
+    
+    std::vector<FrameLib_DSP *> network(1, this);
+    std::vector<FrameLib_DSP *> order;
+    
+    mScheduleGeneration = generation;
+    
+    for (size_t i = 0; i < network.size(); i++)
+    {
+        FrameLib_DSP *object = network[i];
+        
+        object->clearSchedule();
+        object->mScheduleIndex = object->mInputDependencies.size();
+        
+        for (int j = 0; j < 2; j++)
+        {
+            std::vector<FrameLib_DSP *>& connected = j ? object->mOutputDependencies : object->mInputDependencies;
+            
+            for (auto it = connected.begin(); it != connected.end(); it++)
+            {
+                if ((*it)->mScheduleGeneration != generation)
+                {
+                    (*it)->mScheduleGeneration = generation;
+                    network.push_back(*it);
+                }
+            }
+        }
+    }
+    
+    // Schedules are only used with a serial queue (parallel queues benefit from processing objects independently)
+    
+    if (mProcessingQueue->getNumThreads() > 1)
+        return;
+    
+    // Sort topologically (connections are acyclic) and store the position of each object
+    
+    for (auto it = network.begin(); it != network.end(); it++)
+        if (!(*it)->mScheduleIndex)
+            order.push_back(*it);
+    
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        for (auto it = order[i]->mOutputDependencies.begin(); it != order[i]->mOutputDependencies.end(); it++)
+            if (!--(*it)->mScheduleIndex)
+                order.push_back(*it);
+    }
+    
+    assert(order.size() == network.size() && "Network is not acyclic");
+    
+    for (size_t i = 0; i < order.size(); i++)
+        order[i]->mScheduleIndex = static_cast<unsigned long>(i);
+    
+    // Find schedulable objects with a single root and which only have schedulable outputs (repeating until stable)
+    
+    std::vector<FrameLib_DSP *> roots(order.size(), nullptr);
+    std::vector<bool> scheduled(order.size());
+    bool changed = true;
+    
+    for (size_t i = 0; i < order.size(); i++)
+        scheduled[i] = order[i]->isSchedulable();
+    
+    while (changed)
+    {
+        changed = false;
+        
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            if (!scheduled[i])
+                continue;
+            
+            FrameLib_DSP *root = nullptr;
+            
+            for (auto it = order[i]->mInputDependencies.begin(); it != order[i]->mInputDependencies.end(); it++)
+            {
+                unsigned long idx = (*it)->mScheduleIndex;
+                FrameLib_DSP *inputRoot = scheduled[idx] ? roots[idx] : *it;
+                
+                if (root && root != inputRoot)
+                {
+                    root = nullptr;
+                    break;
+                }
+                
+                root = inputRoot;
+            }
+            
+            roots[i] = root;
+            
+            if (!root)
+            {
+                scheduled[i] = false;
+                changed = true;
+            }
+        }
+        
+        for (size_t i = order.size(); i-- > 0; )
+        {
+            if (!scheduled[i])
+                continue;
+            
+            for (auto it = order[i]->mOutputDependencies.begin(); it != order[i]->mOutputDependencies.end(); it++)
+            {
+                if (!scheduled[(*it)->mScheduleIndex])
+                {
+                    scheduled[i] = false;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+    
+    // Build the schedules and the input tables for each scheduled object
+    
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        if (!scheduled[i])
+            continue;
+        
+        FrameLib_DSP *object = order[i];
+        
+        object->mScheduleRoot = roots[i];
+        roots[i]->mSchedule.push_back(object);
+        
+        for (auto ins = object->mInputs.begin(); ins != object->mInputs.end(); ins++)
+            if (ins->mObject)
+                object->mScheduledInputs.push_back(ins->mObject);
+    }
+}
+
+void FrameLib_DSP::clearSchedule()
+{
+    // Remove the whole schedule that this object is part of (either as the root or as a scheduled object)
+    
+    FrameLib_DSP *root = mScheduleRoot ? mScheduleRoot : this;
+    
+    for (auto it = root->mSchedule.begin(); it != root->mSchedule.end(); it++)
+    {
+        (*it)->mScheduleRoot = nullptr;
+        (*it)->mScheduledInputs.clear();
+    }
+    
+    root->mSchedule.clear();
 }
 
 // Manage Output Memory
 
 inline void FrameLib_DSP::freeOutputMemory()
 {
+    // If the memory has been taken by an in-place output then only forget the pointer
+    
+    if (mOutputMemoryStolen)
+    {
+        mOutputs[0].mMemory = nullptr;
+        mOutputMemoryStolen = false;
+        return;
+    }
+    
     if (getNumOuts() && mOutputs[0].mMemory)
     {        
         // Call the destructor for any serial outputs
@@ -581,7 +1024,7 @@ inline void FrameLib_DSP::freeOutputMemory()
 
 inline void FrameLib_DSP::releaseOutputMemory()
 {
-    if (--mOutputMemoryCount == 0)
+    if (adjustCount(mOutputMemoryCount, -1) == 0)
         freeOutputMemory();
 }
 
@@ -591,6 +1034,11 @@ void FrameLib_DSP::connectionUpdate(Queue *queue)
 {
     std::vector<FrameLib_DSP *>::iterator it;
     
+    // Remove any compiled schedule (the network will be recompiled on reset)
+    
+    clearSchedule();
+    mProcessingQueue->invalidateSchedules();
+    
     // Clear dependencies
     
     mInputDependencies.clear();
@@ -623,6 +1071,12 @@ void FrameLib_DSP::connectionUpdate(Queue *queue)
     // Build the output dependency list
     
     addOutputDependencies(mOutputDependencies);
+    
+    // Build the lock order (a consistent order across objects avoids deadlock)
+    
+    mLockOrder = mInputDependencies;
+    mLockOrder.push_back(this);
+    std::sort(mLockOrder.begin(), mLockOrder.end());
 }
 
 void FrameLib_DSP::autoOrderingConnections()
@@ -8,6 +8,7 @@
 #include "FrameLib_ProcessingQueue.h"
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
 #include <memory>
 #include <vector>
@@ -20,6 +21,8 @@
 
  @brief an abstract class containing the core of the DSP processing system, which handles single-stream scheduling.
  
+ Objects are normally processed via dependency counting and the processing queue. On reset the connected network is compiled so that synchronous objects (those with only triggering inputs that are all driven by a single root object, and which only feed other such objects) are instead processed directly by their root, in topological order, whenever the root's time advances.
+ 
  */
 
 class FrameLib_DSP : public FrameLib_Block, public FrameLib_Queueable<FrameLib_DSP>
@@ -87,6 +90,10 @@ private:
         bool mParameters;
         bool mTrigger;
         bool mSwitchable;
+        
+        // Parameter indices resolved for the last tagged frame (for parameter inputs)
+        
+        FrameLib_Parameters::Binding mBinding;
     };
    
     /**
@@ -136,6 +143,10 @@ public:
     void blockUpdate(const double * const *ins, double **outs, unsigned long blockSize) final;
     void reset(double samplingRate, unsigned long maxBlockSize) final;
     
+    // Priority (frames from low priority schedulers may be dropped when the context exceeds its processing budget)
+    
+    void setLowPriority(bool lowPriority) final { mLowPriority = lowPriority; }
+    
     // Info (individual objects should override other methods to provide info)
     
     const FrameLib_Parameters *getParameters() const final { return &mParameters;  }
@@ -164,6 +175,10 @@ protected:
     
     bool isTimedOut() { return mProcessingQueue->isTimedOut(); }
     
+    // Test to see if cheaper processing should be used (when the context has exceeded its processing budget)
+    
+    bool isDegraded() { return mProcessingQueue->isDegraded(); }
+    
     // You should only call this from your process method (it is unsafe anywhere else)
 
     void setCurrentOutputType(unsigned long idx, FrameType type);
@@ -196,6 +211,10 @@ protected:
     void requestAddedOutputSize(unsigned long idx, unsigned long size)      { mOutputs[idx].mRequestedSize += size; }
     bool allocateOutputs();
     
+    // Allocate a single normal output reusing the memory of an input frame where possible (the input pointer remains valid)
+    
+    bool allocateOutputsInPlace(unsigned long inIdx);
+    
     // Get Inputs and Outputs
     
     FrameType getInputCurrentType(unsigned long idx) const                          { return mInputs[idx].getCurrentType(); }
@@ -292,14 +311,31 @@ private:
     inline void freeOutputMemory();
     inline void releaseOutputMemory();
 
+    // Frame Processing (with profiling if enabled, and dropping frames triggered only by dropped frames)
+    
+    inline void processFrame();
+    bool isTriggeredByDroppedFrames() const;
+    void dropFrame();
+    
+    // Count Adjustment
+    
+    inline long adjustCount(std::atomic<long>& count, long amount);
+    
     // Dependency Notification
     
-    inline void dependencyNotify(bool releaseMemory, bool fromInput);
+    inline void dependencyNotify(bool releaseMemory, bool fromInput, bool lock = false);
     void dependenciesReady();
     void incrementInputDependency();
     void resetOutputDependencyCount();
     long getNumOuputDependencies()         { return static_cast<long>(mOutputDependencies.size()); }
     
+    // Compiled Schedule
+    
+    bool isSchedulable();
+    void scheduledUpdate();
+    void compileSchedule();
+    void clearSchedule();
+    
     // Connections
     
     void connectionUpdate(Queue *queue) final;
@@ -325,6 +361,13 @@ private:
     FrameLib_Context::ProcessingQueue mProcessingQueue;
     FrameLib_DSP *mNext;
     
+    // Profiling (compiled only if FRAMELIB_PROFILING is defined)
+
+#ifdef FRAMELIB_PROFILING
+    FrameLib_Context::Profiler mProfiler;
+    FrameLib_Profiler::Entry mProfileEntry;
+#endif
+    
     // IO Info
     
     std::vector<FrameLib_DSP *> mInputDependencies;
@@ -333,11 +376,24 @@ private:
     std::vector<Input> mInputs;
     std::vector<Output> mOutputs;
     
-    // Dependency Counts
+    // Dependency Counts (atomic to allow notification from multiple processing threads)
+    
+    std::atomic<long> mInputCount;
+    std::atomic<long> mDependencyCount;
+    std::atomic<long> mOutputMemoryCount;
+    
+    // Processing Locks (held for this object and its inputs in address order whilst processing in parallel)
+    
+    std::vector<FrameLib_DSP *> mLockOrder;
+    FrameLib_SpinLock mProcessingLock;
+    
+    // Compiled Schedule (synchronous objects that are processed directly by their root object in topological order)
     
-    long mInputCount;
-    long mDependencyCount;
-    long mOutputMemoryCount;
+    std::vector<FrameLib_DSP *> mSchedule;
+    std::vector<FrameLib_DSP *> mScheduledInputs;
+    FrameLib_DSP *mScheduleRoot;
+    unsigned long mScheduleGeneration;
+    unsigned long mScheduleIndex;
     
     // Frame and Block Timings
     
@@ -351,6 +407,9 @@ private:
     bool mNoLiveInputs;
     bool mInUpdate;
     bool mOutputDone;
+    bool mOutputMemoryStolen;
+    bool mLowPriority;
+    bool mDropped;
 };
 
 
@@ -269,6 +269,8 @@ public:
     template<typename... Args>
     void reportError(ErrorSource source, FrameLib_Proxy *reporter, const char *error, Args... args)
     {
+        FrameLib_SpinLockHolder lockHolder(&mLock);
+        
         mReports->add(source, reporter, error, args...);
         
         if (mNotifier && !mNotified)
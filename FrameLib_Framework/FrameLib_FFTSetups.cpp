@@ -0,0 +1,142 @@
+
+#include "FrameLib_FFTSetups.h"
+
+#include <cassert>
+
+// Destructor
+
+FrameLib_FFTSetups::~FrameLib_FFTSetups()
+{
+    // N.B. all references should have been released by the objects holding them
+    
+    assert(mDoubleSetups.empty() && mFloatSetups.empty() && "FFT setups have not been released");
+    
+    for (auto it = mDoubleSetups.begin(); it != mDoubleSetups.end(); it++)
+        hisstools_destroy_setup(it->mSetup);
+    
+    for (auto it = mFloatSetups.begin(); it != mFloatSetups.end(); it++)
+        hisstools_destroy_setup(it->mSetup);
+}
+
+// Acquire / Release
+
+template <class T>
+void FrameLib_FFTSetups::acquire(std::vector<Entry<T>>& entries, T *setup, uintptr_t maxLog2)
+{
+    mLock.acquire();
+    
+    Entry<T> *largest = findLargest(entries);
+    
+    if (!largest || largest->mMaxLog2 < maxLog2)
+    {
+        // Create the setup without holding the lock (which may be slow for large sizes)
+        
+        T created;
+        
+        mLock.release();
+        hisstools_create_setup(&created, maxLog2);
+        mLock.acquire();
+        
+        // Another thread may have created a suitable setup in the meantime
+        
+        largest = findLargest(entries);
+        
+        if (!largest || largest->mMaxLog2 < maxLog2)
+        {
+            entries.push_back(Entry<T>(created, maxLog2));
+            largest = &entries.back();
+            mCreated++;
+        }
+        else
+            hisstools_destroy_setup(created);
+    }
+    
+    largest->mCount++;
+    *setup = largest->mSetup;
+    
+    mLock.release();
+}
+
+template <class T>
+void FrameLib_FFTSetups::release(std::vector<Entry<T>>& entries, T setup)
+{
+    FrameLib_SpinLockHolder lock(&mLock);
+    
+    for (auto it = entries.begin(); it != entries.end(); it++)
+    {
+        if (it->mSetup == setup)
+        {
+            if (--it->mCount == 0)
+            {
+                hisstools_destroy_setup(it->mSetup);
+                entries.erase(it);
+            }
+            
+            return;
+        }
+    }
+    
+    assert(0 && "FFT setup is not in the cache");
+}
+
+void FrameLib_FFTSetups::acquire(FFT_SETUP_D *setup, uintptr_t maxLog2)
+{
+    acquire(mDoubleSetups, setup, maxLog2);
+}
+
+void FrameLib_FFTSetups::acquire(FFT_SETUP_F *setup, uintptr_t maxLog2)
+{
+    acquire(mFloatSetups, setup, maxLog2);
+}
+
+void FrameLib_FFTSetups::release(FFT_SETUP_D setup)
+{
+    release(mDoubleSetups, setup);
+}
+
+void FrameLib_FFTSetups::release(FFT_SETUP_F setup)
+{
+    release(mFloatSetups, setup);
+}
+
+// Find the setup with the largest maximum size
+
+template <class T>
+FrameLib_FFTSetups::Entry<T> *FrameLib_FFTSetups::findLargest(std::vector<Entry<T>>& entries)
+{
+    Entry<T> *largest = nullptr;
+    
+    for (auto it = entries.begin(); it != entries.end(); it++)
+        if (!largest || it->mMaxLog2 > largest->mMaxLog2)
+            largest = &*it;
+    
+    return largest;
+}
+
+// Statistics
+
+template <class T>
+void FrameLib_FFTSetups::addStatistics(const std::vector<Entry<T>>& entries, Statistics& statistics)
+{
+    for (auto it = entries.begin(); it != entries.end(); it++)
+    {
+        statistics.mSetups++;
+        statistics.mReferences += it->mCount;
+    }
+}
+
+FrameLib_FFTSetups::Statistics FrameLib_FFTSetups::getStatistics()
+{
+    FrameLib_SpinLockHolder lock(&mLock);
+    
+    Statistics statistics;
+    
+    statistics.mSetups = 0;
+    statistics.mReferences = 0;
+    statistics.mCreated = mCreated;
+    
+    addStatistics(mDoubleSetups, statistics);
+    addStatistics(mFloatSetups, statistics);
+    
+    return statistics;
+}
@@ -0,0 +1,109 @@
+
+#ifndef FRAMELIB_FFTSETUPS_H
+#define FRAMELIB_FFTSETUPS_H
+
+#include "../FrameLib_Dependencies/HISSTools_FFT/HISSTools_FFT.h"
+#include "FrameLib_Types.h"
+#include "FrameLib_Threading.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ 
+ @class FrameLib_FFTSetups
+ 
+ @ingroup Memory
+ 
+ @brief a threadsafe reference counted cache of FFT setups that are shared read-only between all objects using a FrameLib_Global.
+ 
+ A setup holds the twiddle tables for every power of two size up to its maximum, so a setup with a larger maximum serves any smaller size with identical results. Requests are served by the largest existing setup of the same precision if it is large enough, and otherwise a setup of the requested size is created (so the cache grows lazily to the largest size requested). Setups are destroyed when their last reference is released. Setups are only acquired and released when objects are created or deleted, and never whilst processing.
+ 
+ */
+
+class FrameLib_FFTSetups
+{
+    /**
+     
+     @struct Entry
+     
+     @brief a single cached setup and its reference count.
+     
+     */
+    
+    template <class T>
+    struct Entry
+    {
+        Entry(T setup, uintptr_t maxLog2) : mSetup(setup), mMaxLog2(maxLog2), mCount(0) {}
+        
+        T mSetup;
+        uintptr_t mMaxLog2;
+        unsigned long mCount;
+    };
+
+public:
+    
+    /**
+     
+     @struct Statistics
+     
+     @brief the current state of the cache.
+     
+     */
+    
+    struct Statistics
+    {
+        unsigned long mSetups;              /**< the number of setups currently held */
+        unsigned long mReferences;          /**< the number of references to those setups */
+        unsigned long mCreated;             /**< the number of setups created (since construction) */
+    };
+    
+    // Constructor / Destructor
+    
+    FrameLib_FFTSetups() : mCreated(0) {}
+    ~FrameLib_FFTSetups();
+    
+    // Non-copyable
+    
+    FrameLib_FFTSetups(const FrameLib_FFTSetups&) = delete;
+    FrameLib_FFTSetups& operator=(const FrameLib_FFTSetups&) = delete;
+    
+    // Acquire a setup suitable for sizes up to 2^maxLog2 (maxLog2 must be non-zero)
+    
+    void acquire(FFT_SETUP_D *setup, uintptr_t maxLog2);
+    void acquire(FFT_SETUP_F *setup, uintptr_t maxLog2);
+    
+    // Release a setup previously acquired
+    
+    void release(FFT_SETUP_D setup);
+    void release(FFT_SETUP_F setup);
+    
+    // Statistics
+    
+    Statistics getStatistics();
+
+private:
+    
+    template <class T>
+    void acquire(std::vector<Entry<T>>& entries, T *setup, uintptr_t maxLog2);
+    
+    template <class T>
+    void release(std::vector<Entry<T>>& entries, T setup);
+    
+    template <class T>
+    static Entry<T> *findLargest(std::vector<Entry<T>>& entries);
+    
+    template <class T>
+    static void addStatistics(const std::vector<Entry<T>>& entries, Statistics& statistics);
+    
+    // Member Variables
+    
+    FrameLib_SpinLock mLock;
+    
+    std::vector<Entry<FFT_SETUP_D>> mDoubleSetups;
+    std::vector<Entry<FFT_SETUP_F>> mFloatSetups;
+    
+    unsigned long mCreated;
+};
+
+#endif /* FRAMELIB_FFTSETUPS_H */
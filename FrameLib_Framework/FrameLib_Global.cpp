@@ -42,3 +42,35 @@ FrameLib_Global *FrameLib_Global::decrement()
     
     return this;
 }
+
+// Profiling
+
+void FrameLib_Global::getProfile(std::vector<FrameLib_Profiler::Record>& records)
+{
+    std::vector<FrameLib_Profiler *> profilers;
+    
+    mProfilers.getAll(profilers);
+    
+    for (auto it = profilers.begin(); it != profilers.end(); it++)
+        (*it)->getRecords(records);
+}
+
+void FrameLib_Global::getProfileTrace(std::vector<FrameLib_Profiler::TraceEvent>& events)
+{
+    std::vector<FrameLib_Profiler *> profilers;
+    
+    mProfilers.getAll(profilers);
+    
+    for (auto it = profilers.begin(); it != profilers.end(); it++)
+        (*it)->getTrace(events);
+}
+
+void FrameLib_Global::resetProfile()
+{
+    std::vector<FrameLib_Profiler *> profilers;
+    
+    mProfilers.getAll(profilers);
+    
+    for (auto it = profilers.begin(); it != profilers.end(); it++)
+        (*it)->reset();
+}
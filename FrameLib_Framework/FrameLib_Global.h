@@ -4,8 +4,11 @@
 
 #include "FrameLib_Types.h"
 #include "FrameLib_Errors.h"
+#include "FrameLib_FFTSetups.h"
 #include "FrameLib_Memory.h"
 #include "FrameLib_ProcessingQueue.h"
+#include "FrameLib_Profiler.h"
+#include "FrameLib_WindowCache.h"
 #include "FrameLib_Threading.h"
 
 #include <memory>
@@ -74,6 +77,14 @@ private:
             return object;
         }
         
+        // Get all current objects
+        
+        void getAll(std::vector<T *>& objects)
+        {
+            for (auto it = mPointers.begin(); it != mPointers.end(); it++)
+                objects.push_back(it->mObject.get());
+        }
+        
         // Release a pre-existing object by reference address
         
         void release(void *reference)
@@ -123,13 +134,59 @@ public:
      */
     
     static void release(FrameLib_Global **global);
+    
+    /** Get usage statistics for the per-thread caches of the global allocator
+     
+     @return a FrameLib_GlobalAllocator::CacheStatistics struct summed over all threads.
+     
+     */
+    
+    FrameLib_GlobalAllocator::CacheStatistics getCacheStatistics() const { return mAllocator.getCacheStatistics(); }
+    
+    /** Get the state of the shared FFT setup cache
+     
+     @return a FrameLib_FFTSetups::Statistics struct.
+     
+     */
+    
+    FrameLib_FFTSetups::Statistics getFFTSetupStatistics() { return mFFTSetups.getStatistics(); }
+    
+    /** Get the state of the shared window table cache
+     
+     @return a FrameLib_WindowCache::Statistics struct.
+     
+     */
+    
+    FrameLib_WindowCache::Statistics getWindowCacheStatistics() { return mWindowCache.getStatistics(); }
+    
+    /** Get profiling records for the objects in all contexts
+     
+     Records are only collected when FRAMELIB_PROFILING is defined (per-context records can be retrieved via FrameLib_Context::Profiler).
+     
+     @param records a reference to a std::vector<FrameLib_Profiler::Record> to which the records are appended.
+     
+     */
+    
+    void getProfile(std::vector<FrameLib_Profiler::Record>& records);
+    
+    /** Get any traced profiling events in all contexts
+     
+     @param events a reference to a std::vector<FrameLib_Profiler::TraceEvent> to which the events are appended.
+     
+     */
+    
+    void getProfileTrace(std::vector<FrameLib_Profiler::TraceEvent>& events);
+    
+    /** Reset the profiling counters and trace in all contexts */
+    
+    void resetProfile();
         
 private:
     
     // Constructor / Destructor
     
     FrameLib_Global(FrameLib_ErrorReporter::HostNotifier *notifier)
-    : FrameLib_ErrorReporter(notifier), mAllocator(*this), mLocalAllocators(*this), mProcessingQueues(*this), mCount(0) {}
+    : FrameLib_ErrorReporter(notifier), mAllocator(*this), mWindowCache(mAllocator), mLocalAllocators(*this), mProcessingQueues(*this), mProfilers(*this), mCount(0) {}
     ~FrameLib_Global() {};
     
     // Non-copyable
@@ -152,10 +209,19 @@ private:
     
     FrameLib_GlobalAllocator mAllocator;
     
+    // Shared FFT Setups
+    
+    FrameLib_FFTSetups mFFTSetups;
+    
+    // Shared Window Tables
+    
+    FrameLib_WindowCache mWindowCache;
+    
     // Context-specific Resources
     
     PointerSet<FrameLib_LocalAllocator> mLocalAllocators;
     PointerSet<FrameLib_ProcessingQueue> mProcessingQueues;
+    PointerSet<FrameLib_Profiler> mProfilers;
     
     // Lock and Reference Count
     
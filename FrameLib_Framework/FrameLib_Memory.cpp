@@ -1,16 +1,26 @@
 
 #include "FrameLib_Memory.h"
 #include "FrameLib_Types.h"
+#include "../FrameLib_Dependencies/SIMDSupport.hpp"
+
+#include <algorithm>
+#include <cassert>
 
 // Static constants for memory scheduling and alignment
 
-// N.B. - alignment must be a power of two
+// N.B. - alignment must be a power of two (memory is aligned for the widest vectors in use so that SIMD code may use aligned access)
 
-static const size_t alignment = 16;
+static const size_t alignment = SIMDLimits<double>::byte_width > 16 ? SIMDLimits<double>::byte_width : 16;
 static size_t const initSize = 1024 * 1024 * 2;
 static size_t const growSize = 1024 * 1024 * 2;
 static const int pruneInterval = 20;
 
+// N.B. - local blocks are filed under the class they were allocated for, which is recovered from the block size on deallocation
+// N.B. - this relies on blocks served for a class always being smaller than the next class (the global caches file blocks by the same rule)
+// N.B. - the overhead that TLSF may leave on a block is smaller than the minimum local block size, so small blocks never move up a class
+
+static size_t const minLocalSize = 64;
+
 // ************************************************************************************** //
 
 // Utility
@@ -25,6 +35,90 @@ inline size_t blockSize(void* ptr)
     return tlsf_block_size(ptr);
 }
 
+// Counters that are written by a single thread
+
+inline void incrementCounter(std::atomic<unsigned long long>& counter)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+// Size classes are powers of two starting at the alignment
+
+static const int maxSizeClass = 58;
+
+inline size_t sizeClassSize(int sizeClass)
+{
+    return alignment << sizeClass;
+}
+
+// The smallest size class that can hold a given size
+
+inline int ceilSizeClass(size_t size)
+{
+    int sizeClass = 0;
+    
+    while (sizeClass < maxSizeClass && sizeClassSize(sizeClass) < size)
+        sizeClass++;
+    
+    return sizeClass;
+}
+
+// The largest size class that can be served by a block of a given size (-1 if none)
+
+inline int floorSizeClass(size_t size)
+{
+    int sizeClass = -1;
+    
+    while (sizeClass < maxSizeClass && sizeClassSize(sizeClass + 1) <= size)
+        sizeClass++;
+    
+    return sizeClass;
+}
+
+// ************************************************************************************** //
+
+// Thread Slots (each thread that allocates claims a slot for its lifetime to identify its cache)
+
+static std::atomic<bool> sThreadSlots[FrameLib_GlobalAllocator::numCacheThreads];
+
+class ThreadSlot
+{
+    
+public:
+    
+    ThreadSlot() : mIndex(-1)
+    {
+        for (int i = 0; i < FrameLib_GlobalAllocator::numCacheThreads; i++)
+        {
+            if (compareAndSwap(sThreadSlots[i], false, true))
+            {
+                mIndex = i;
+                break;
+            }
+        }
+    }
+    
+    ~ThreadSlot()
+    {
+        if (mIndex >= 0)
+            sThreadSlots[mIndex].store(false);
+        mIndex = -1;
+    }
+    
+    // Non-copyable
+    
+    ThreadSlot(const ThreadSlot&) = delete;
+    ThreadSlot& operator=(const ThreadSlot&) = delete;
+    
+    int getIndex() const { return mIndex; }
+    
+private:
+    
+    int mIndex;
+};
+
+static thread_local ThreadSlot sThreadSlot;
+
 // ************************************************************************************** //
 
 // The Core Allocator (has no threadsafety)
@@ -241,22 +335,147 @@ void FrameLib_GlobalAllocator::CoreAllocator::destroyScheduledPool()
 
 // ************************************************************************************** //
 
-// The Global Allocator (adds threadsafety to the CoreAllocator)
+// The Global Allocator (adds threadsafety and per-thread caching to the CoreAllocator)
+
+FrameLib_GlobalAllocator::~FrameLib_GlobalAllocator()
+{
+    // Return all cached blocks so that the pools are free when destroyed
+    
+    for (int i = 0; i < numCacheThreads; i++)
+        for (int j = 0; j < numSizeClasses; j++)
+            while (mCaches[i].mMagazines[j].mCount)
+                mAllocator.dealloc(mCaches[i].mMagazines[j].mBlocks[--mCaches[i].mMagazines[j].mCount]);
+}
 
 // Allocate / Deallocate Memory
 
 void *FrameLib_GlobalAllocator::alloc(size_t size)
 {
+    ThreadCache *cache = getCache();
+    int sizeClass = ceilSizeClass(size);
+    
+    if (cache && sizeClass < numSizeClasses)
+    {
+        Magazine& magazine = cache->mMagazines[sizeClass];
+        
+        if (magazine.mCount)
+            incrementCounter(cache->mHits);
+        else
+        {
+            incrementCounter(cache->mMisses);
+            refill(magazine, sizeClass);
+        }
+        
+        return magazine.mCount ? magazine.mBlocks[--magazine.mCount] : nullptr;
+    }
+    
+    if (cache)
+        incrementCounter(cache->mUncached);
+    
     FrameLib_SpinLockHolder lock(&mLock);
     return mAllocator.alloc(size);
 }
 
 void FrameLib_GlobalAllocator::dealloc(void *ptr)
 {
+    ThreadCache *cache = getCache();
+    int sizeClass = floorSizeClass(blockSize(ptr));
+    
+    if (cache && sizeClass >= 0 && sizeClass < numSizeClasses)
+    {
+        Magazine& magazine = cache->mMagazines[sizeClass];
+        
+        if (magazine.mCount == magazineSize)
+        {
+            incrementCounter(cache->mFlushes);
+            flush(magazine);
+        }
+        
+        magazine.mBlocks[magazine.mCount++] = ptr;
+        return;
+    }
+    
+    if (cache)
+        incrementCounter(cache->mUncached);
+    
     FrameLib_SpinLockHolder lock(&mLock);
     mAllocator.dealloc(ptr);
 }
 
+// Prune Unused System Memory
+
+void FrameLib_GlobalAllocator::prune()
+{
+    ThreadCache *cache = getCache();
+    
+    // Pruning works on a timescale of seconds, so threads with caches only attempt it periodically
+    
+    if (cache && ++cache->mPruneCount < pruneCount)
+        return;
+    
+    if (cache)
+        cache->mPruneCount = 0;
+    
+    if (mLock.attempt())
+    {
+        mAllocator.prune();
+        mLock.release();
+    }
+}
+
+// Cache Statistics
+
+FrameLib_GlobalAllocator::CacheStatistics FrameLib_GlobalAllocator::getCacheStatistics() const
+{
+    CacheStatistics statistics;
+    
+    for (int i = 0; i < numCacheThreads; i++)
+    {
+        statistics.mHits += mCaches[i].mHits.load(std::memory_order_relaxed);
+        statistics.mMisses += mCaches[i].mMisses.load(std::memory_order_relaxed);
+        statistics.mFlushes += mCaches[i].mFlushes.load(std::memory_order_relaxed);
+        statistics.mUncached += mCaches[i].mUncached.load(std::memory_order_relaxed);
+    }
+    
+    return statistics;
+}
+
+// Per-thread Caches
+
+FrameLib_GlobalAllocator::ThreadCache *FrameLib_GlobalAllocator::getCache()
+{
+    int index = sThreadSlot.getIndex();
+    
+    return index >= 0 ? mCaches + index : nullptr;
+}
+
+void FrameLib_GlobalAllocator::refill(Magazine& magazine, int sizeClass)
+{
+    // Fill half of the magazine with a single lock
+    
+    FrameLib_SpinLockHolder lock(&mLock);
+    
+    while (magazine.mCount < (magazineSize >> 1))
+    {
+        void *ptr = mAllocator.alloc(sizeClassSize(sizeClass));
+        
+        if (!ptr)
+            break;
+        
+        magazine.mBlocks[magazine.mCount++] = ptr;
+    }
+}
+
+void FrameLib_GlobalAllocator::flush(Magazine& magazine)
+{
+    // Return half of the magazine with a single lock
+    
+    FrameLib_SpinLockHolder lock(&mLock);
+    
+    while (magazine.mCount > (magazineSize >> 1))
+        mAllocator.dealloc(magazine.mBlocks[--magazine.mCount]);
+}
+
 // Alignment Helpers
 
 size_t FrameLib_GlobalAllocator::getAlignment()
@@ -337,20 +556,9 @@ void FrameLib_LocalAllocator::Storage::resize(bool tagged, unsigned long size)
 
 // Constructor / Destructor
 
-FrameLib_LocalAllocator::FrameLib_LocalAllocator(FrameLib_GlobalAllocator& allocator) : mAllocator(allocator)
-{
-    // Setup the free lists as a circularly linked list
-    
-    for (unsigned int i = 0; i < (numLocalFreeBlocks - 1); i++)
-    {
-        mFreeLists[i + 1].mPrev = mFreeLists + i;
-        mFreeLists[i].mNext = mFreeLists + i + 1;
-    }
-    
-    mTail = mFreeLists + (numLocalFreeBlocks - 1);
-    mTail->mNext = mFreeLists;
-    mTail->mNext->mPrev = mTail;
-}
+FrameLib_LocalAllocator::FrameLib_LocalAllocator(FrameLib_GlobalAllocator& allocator)
+: mAllocator(allocator), mMaxClassBlocks(defaultMaxClassBlocks), mMaxRetainedSize(defaultMaxRetainedSize)
+{}
 
 FrameLib_LocalAllocator::~FrameLib_LocalAllocator()
 {
@@ -364,38 +572,61 @@ void *FrameLib_LocalAllocator::alloc(size_t size)
     if (!size)
         return nullptr;
     
-    // N.B. - all memory should be aligned to alignment / memory returned will be between size and size << 1
+    // N.B. - all memory should be aligned to alignment / memory is allocated in power-of-two size classes
+    
+    int sizeClass = ceilSizeClass(std::max(size, minLocalSize));
     
-    size_t maxSize = size << 1;
+    FrameLib_SpinLockHolder lock(&mLock);
     
-    // Find an appropriately sized block in the free lists
+    mStatistics.mAllocs++;
     
-    for (FreeBlock *block = mTail->mNext; block && block->mMemory; block = block == mTail ? nullptr : block->mNext)
-        if (block->mSize >= size && block->mSize <= maxSize)
-            return removeBlock(block);
+    // Serve from the appropriate free list if possible
+    
+    if (sizeClass < numSizeClasses)
+    {
+        if (void *ptr = popBlock(sizeClass))
+        {
+            mStatistics.mHits++;
+            return ptr;
+        }
+        
+        size = sizeClassSize(sizeClass);
+    }
     
     // If this fails call the global allocator
     
-    return mAllocator.alloc(size);
+    mStatistics.mGlobalAllocs++;
+    
+    void *ptr = mAllocator.alloc(size);
+    
+    assert((!ptr || sizeClass >= numSizeClasses || floorSizeClass(blockSize(ptr)) == sizeClass) && "Block will not be filed under its allocation class");
+    
+    return ptr;
 }
 
 void FrameLib_LocalAllocator::dealloc(void *ptr)
 {
     if (ptr)
     {
-        // If the free lists are full send the tail back to the global allocator
+        int sizeClass = floorSizeClass(blockSize(ptr));
         
-        if (mTail->mMemory)
-            mAllocator.dealloc(mTail->mMemory);
+        FrameLib_SpinLockHolder lock(&mLock);
         
-        // Put the memory into the (now vacant) tail position
+        // Retain the block if it is within the retention limits
         
-        mTail->mMemory = ptr;
-        mTail->mSize = blockSize(ptr);
+        if (sizeClass >= 0 && sizeClass < numSizeClasses)
+        {
+            if (mSizeClasses[sizeClass].mCount < mMaxClassBlocks && mStatistics.mRetainedSize + sizeClassSize(sizeClass) <= mMaxRetainedSize)
+            {
+                pushBlock(ptr, sizeClass);
+                return;
+            }
+        }
         
-        // Move top and tail back one (old tail is now the top)
+        // Otherwise return the memory to the global allocator
         
-        mTail = mTail->mPrev;
+        mStatistics.mGlobalDeallocs++;
+        mAllocator.dealloc(ptr);
     }
 }
 
@@ -403,19 +634,52 @@ void FrameLib_LocalAllocator::dealloc(void *ptr)
 
 void FrameLib_LocalAllocator::clear()
 {
-    // Acquire the main allocator and then free all blocks before releasing
+    FrameLib_SpinLockHolder lock(&mLock);
     
-    FrameLib_GlobalAllocator::Pruner pruner(mAllocator);
+    for (int i = 0; i < numSizeClasses; i++)
+        while (mSizeClasses[i].mCount)
+            releaseBlock(i);
     
-    for (unsigned int i = 0; i < numLocalFreeBlocks; i++)
-    {
-        if (mFreeLists[i].mMemory)
-        {
-            pruner.dealloc(mFreeLists[i].mMemory);
-            mFreeLists[i].mMemory = nullptr;
-            mFreeLists[i].mSize = 0;
-        }
-    }
+    mAllocator.prune();
+}
+
+// Release Free Blocks Beyond the Retention Limits (and prune global allocator)
+
+void FrameLib_LocalAllocator::prune()
+{
+    FrameLib_SpinLockHolder lock(&mLock);
+    
+    trim();
+    mAllocator.prune();
+}
+
+// Retention Limits
+
+void FrameLib_LocalAllocator::setRetention(unsigned long maxClassBlocks, size_t maxRetainedSize)
+{
+    FrameLib_SpinLockHolder lock(&mLock);
+    
+    mMaxClassBlocks = maxClassBlocks;
+    mMaxRetainedSize = maxRetainedSize;
+    trim();
+}
+
+// Statistics
+
+FrameLib_LocalAllocator::Statistics FrameLib_LocalAllocator::getStatistics()
+{
+    FrameLib_SpinLockHolder lock(&mLock);
+    
+    return mStatistics;
+}
+
+void FrameLib_LocalAllocator::resetStatistics()
+{
+    FrameLib_SpinLockHolder lock(&mLock);
+    
+    size_t retainedSize = mStatistics.mRetainedSize;
+    mStatistics = Statistics();
+    mStatistics.mRetainedSize = retainedSize;
 }
 
 // Register and Release Storage
@@ -456,36 +720,49 @@ std::vector<FrameLib_LocalAllocator::Storage *>::iterator FrameLib_LocalAllocato
     return mStorage.end();
 }
 
-// Remove a Free Block after Allocation and Return the Pointer
+// Free List Helpers (N.B. - these must be called with the lock held)
 
-void *FrameLib_LocalAllocator::removeBlock(FreeBlock *block)
+void *FrameLib_LocalAllocator::popBlock(int sizeClass)
 {
-    void *ptr = block->mMemory;
-    
-    // Set to default values
-    
-    block->mMemory = nullptr;
-    block->mSize = 0;
-    
-    // If at the tail there is no need to do anything
+    SizeClass& list = mSizeClasses[sizeClass];
+    FreeBlock *block = list.mFree;
     
-    if (block == mTail)
-        return ptr;
-    
-    // Join list
-    
-    block->mNext->mPrev = block->mPrev;
-    block->mPrev->mNext = block->mNext;
-    
-    // Place at the tail
+    if (block)
+    {
+        list.mFree = block->mNext;
+        list.mCount--;
+        mStatistics.mRetainedSize -= sizeClassSize(sizeClass);
+    }
     
-    block->mPrev = mTail;
-    block->mNext = mTail->mNext;
+    return block;
+}
+
+void FrameLib_LocalAllocator::pushBlock(void *ptr, int sizeClass)
+{
+    SizeClass& list = mSizeClasses[sizeClass];
+    FreeBlock *block = static_cast<FreeBlock *>(ptr);
     
-    mTail->mNext->mPrev = block;
-    mTail->mNext = block;
+    block->mNext = list.mFree;
+    list.mFree = block;
+    list.mCount++;
+    mStatistics.mRetainedSize += sizeClassSize(sizeClass);
+}
+
+void FrameLib_LocalAllocator::releaseBlock(int sizeClass)
+{
+    mStatistics.mGlobalDeallocs++;
+    mAllocator.dealloc(popBlock(sizeClass));
+}
+
+void FrameLib_LocalAllocator::trim()
+{
+    // Enforce the per-class limit and then release the largest blocks until within the size limit
     
-    mTail = block;
+    for (int i = 0; i < numSizeClasses; i++)
+        while (mSizeClasses[i].mCount > mMaxClassBlocks)
+            releaseBlock(i);
     
-    return ptr;
+    for (int i = numSizeClasses - 1; i >= 0 && mStatistics.mRetainedSize > mMaxRetainedSize; i--)
+        while (mSizeClasses[i].mCount && mStatistics.mRetainedSize > mMaxRetainedSize)
+            releaseBlock(i);
 }
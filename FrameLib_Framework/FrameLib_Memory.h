@@ -8,6 +8,7 @@
 #include "FrameLib_Parameters.h"
 #include "FrameLib_Threading.h"
 
+#include <atomic>
 #include <vector>
 #include <ctime>
 #include <string>
@@ -26,13 +27,23 @@
  
  @brief a global threadsafe memory allocator suitable for realtime usage.
  
+ Small allocations are served from per-thread caches of size-classed blocks (magazines), which are refilled from and flushed to the underlying locked allocator in batches, so that steady-state allocation does not require the lock. Each thread that uses the allocator claims one of a fixed number of cache slots for its lifetime - threads beyond this number use the locked allocator directly.
+ 
  */
 
 class FrameLib_GlobalAllocator
 {
 
+public:
+    
+    static const int numCacheThreads = 32;
+    
 private:
     
+    static const int numSizeClasses = 13;
+    static const int magazineSize = 16;
+    static const int pruneCount = 64;
+    
     /**
      
      @class CoreAllocator
@@ -159,50 +170,77 @@ private:
         FrameLib_ErrorReporter& mErrorReporter;
     };
     
-public:
-
     /**
      
-     @class Pruner
+     @struct Magazine
      
-     @brief an RAII utility for repeated deallocation with only a single lock.
+     @brief a stack of free blocks belonging to a single size class.
      
      */
+    
+    struct Magazine
+    {
+        Magazine() : mCount(0) {}
         
-    class Pruner
+        void *mBlocks[magazineSize];
+        int mCount;
+    };
+    
+    /**
+     
+     @struct ThreadCache
+     
+     @brief a set of magazines (one per size class) that is only accessed by a single thread.
+     
+     */
+    
+    struct ThreadCache
     {
+        ThreadCache() : mHits(0), mMisses(0), mFlushes(0), mUncached(0), mPruneCount(0) {}
         
-    public:
+        Magazine mMagazines[numSizeClasses];
         
-        Pruner(FrameLib_GlobalAllocator& allocator) : mAllocator(allocator)
-        {
-            mAllocator.mLock.acquire();
-        }
+        // Counters (only written by the owning thread, but readable from others)
         
-        ~Pruner()
-        {
-            mAllocator.mAllocator.prune();
-            mAllocator.mLock.release();
-        }
+        std::atomic<unsigned long long> mHits;
+        std::atomic<unsigned long long> mMisses;
+        std::atomic<unsigned long long> mFlushes;
+        std::atomic<unsigned long long> mUncached;
         
-        // Non-copyable
+        int mPruneCount;
+    };
+    
+public:
+
+    /**
+     
+     @struct CacheStatistics
+     
+     @brief a struct for reporting the usage of the per-thread caches (summed over all threads).
+     
+     */
+    
+    struct CacheStatistics
+    {
+        CacheStatistics() : mHits(0), mMisses(0), mFlushes(0), mUncached(0) {}
         
-        Pruner(const Pruner&) = delete;
-        Pruner& operator=(const Pruner&) = delete;
+        double hitRate() const { return (mHits + mMisses) ? static_cast<double>(mHits) / static_cast<double>(mHits + mMisses) : 0.0; }
         
-        void dealloc(void *ptr) { mAllocator.mAllocator.dealloc(ptr); }
+        // Allocations served by a cache, allocations that required a refill and the number of batch flushes
 
-    private:
-        
-        // Allocator
+        unsigned long long mHits;
+        unsigned long long mMisses;
+        unsigned long long mFlushes;
         
-        FrameLib_GlobalAllocator& mAllocator;
+        // Allocations and deallocations that bypassed the caches (large sizes or threads without a cache)
+
+        unsigned long long mUncached;
     };
 
     // Constructor / Destructor
     
     FrameLib_GlobalAllocator(FrameLib_ErrorReporter& errorReporter) : mAllocator(errorReporter) {}
-    ~FrameLib_GlobalAllocator() {}
+    ~FrameLib_GlobalAllocator();
     
     // Non-copyable
     
@@ -214,17 +252,33 @@ public:
     void *alloc(size_t size);
     void dealloc(void *ptr);
     
+    // Prune unused system memory (the lock is only attempted, so this may do nothing)
+    
+    void prune();
+    
+    // Cache Statistics
+    
+    CacheStatistics getCacheStatistics() const;
+    
     // Alignment Helpers
     
     static size_t getAlignment();
     static size_t alignSize(size_t x);
     
 private:
-   
+    
+    // Per-thread Caches
+    
+    ThreadCache *getCache();
+    void refill(Magazine& magazine, int sizeClass);
+    void flush(Magazine& magazine);
+    
     // Member Variables
     
     FrameLib_SpinLock mLock;
     CoreAllocator mAllocator;
+    
+    ThreadCache mCaches[numCacheThreads];
 };
 
 
@@ -236,34 +290,74 @@ private:
 
  @brief a memory allocator suitable for usage in a given FrameLib context.
  
+ Freed memory is retained in per-size-class free lists (power-of-two sizes) so that patches cycling through many frame sizes are served locally. Blocks are only returned to the global allocator when a class exceeds its retention limits, so that in steady state no global allocator traffic is required.
+ 
  @sa FrameLib_Context
  
  */
 
 class FrameLib_LocalAllocator
 {
-    static const int numLocalFreeBlocks = 16;
+    static const int numSizeClasses = 28;
+    static const unsigned long defaultMaxClassBlocks = 64;
+    static const size_t defaultMaxRetainedSize = 1024 * 1024 * 64;
 
     /**
      
      @struct FreeBlock
      
-     @brief a memory block that can be addressed as part of double-linked list.
+     @brief a free memory block that can be addressed as part of a singly-linked list (stored in the block itself).
      
      */
     
     struct FreeBlock
     {
-        FreeBlock() : mMemory(nullptr), mSize(0), mPrev(nullptr), mNext(nullptr) {}
-        
-        void *mMemory;
-        size_t mSize;
-        
-        FreeBlock *mPrev;
         FreeBlock *mNext;
     };
     
+    /**
+     
+     @struct SizeClass
+     
+     @brief a free list of blocks of a single power-of-two size.
+     
+     */
+    
+    struct SizeClass
+    {
+        SizeClass() : mFree(nullptr), mCount(0) {}
+        
+        FreeBlock *mFree;
+        unsigned long mCount;
+    };
+    
 public:
+    
+    /**
+     
+     @struct Statistics
+     
+     @brief a struct for reporting allocator usage.
+     
+     */
+    
+    struct Statistics
+    {
+        Statistics() : mAllocs(0), mHits(0), mGlobalAllocs(0), mGlobalDeallocs(0), mRetainedSize(0) {}
+        
+        double hitRate() const { return mAllocs ? static_cast<double>(mHits) / static_cast<double>(mAllocs) : 0.0; }
+        
+        // Allocations, allocations served locally and traffic to the global allocator
+        
+        unsigned long long mAllocs;
+        unsigned long long mHits;
+        unsigned long long mGlobalAllocs;
+        unsigned long long mGlobalDeallocs;
+        
+        // Memory currently held in the free lists
+        
+        size_t mRetainedSize;
+    };
 
     /**
      
@@ -388,6 +482,19 @@ public:
     
     void clear();
     
+    // Release Free Blocks Beyond the Retention Limits (and prune global allocator)
+    
+    void prune();
+    
+    // Retention Limits (blocks per size class and total free memory)
+    
+    void setRetention(unsigned long maxClassBlocks, size_t maxRetainedSize);
+    
+    // Statistics
+    
+    Statistics getStatistics();
+    void resetStatistics();
+    
     // Alignment Helpers
     
     static size_t getAlignment()        { return FrameLib_GlobalAllocator::getAlignment(); }
@@ -404,18 +511,29 @@ private:
     
     std::vector<Storage *>::iterator findStorage(const char *name);
     
-    // Remove a Free Block after Allocation and Return the Pointer
+    // Free List Helpers
 
-    void *removeBlock(FreeBlock *block);
+    void *popBlock(int sizeClass);
+    void pushBlock(void *ptr, int sizeClass);
+    void releaseBlock(int sizeClass);
+    void trim();
     
     // Member Variables
     
     FrameLib_GlobalAllocator& mAllocator;
     
-    FreeBlock mFreeLists[numLocalFreeBlocks];
-    FreeBlock *mTail;
+    SizeClass mSizeClasses[numSizeClasses];
+    
+    unsigned long mMaxClassBlocks;
+    size_t mMaxRetainedSize;
+    
+    Statistics mStatistics;
     
     std::vector<Storage *> mStorage;
+    
+    // N.B. - the lock is needed when the context is processed by multiple threads
+    
+    FrameLib_SpinLock mLock;
 };
 
 #endif
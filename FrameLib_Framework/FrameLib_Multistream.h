@@ -129,7 +129,7 @@ public:
     const FrameLib_Parameters::Serial *getSerialised() override { return &mSerialisedParameters; }
 
     FrameLib_Expand(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy, unsigned long nStreams)
-    : FrameLib_Multistream(T::getType(), context, proxy, nStreams), mSerialisedParameters(serialisedParameters ? serialisedParameters->size() : 0)
+    : FrameLib_Multistream(T::getType(), context, proxy, nStreams), mSerialisedParameters(serialisedParameters ? serialisedParameters->size() : 0), mLowPriority(false)
     {
         // Make first block
         
@@ -208,12 +208,12 @@ public:
                     outs[outStreamOffset + j][k] += mAudioTemps[j][k];
         }
 
-        // Release temporary memory and clear allocator
+        // Release temporary memory and prune allocator (blocks within the retention limits are kept)
         
         if (getNumAudioOuts())
            dealloc(mAudioTemps[0]);
                 
-        clearAllocator();
+        pruneAllocator();
     }
    
     // Reset
@@ -227,6 +227,16 @@ public:
             (*it)->reset(samplingRate, maxBlockSize);
     }
     
+    // Priority
+    
+    void setLowPriority(bool lowPriority) override
+    {
+        mLowPriority = lowPriority;
+        
+        for (auto it = mBlocks.begin(); it != mBlocks.end(); it++)
+            (*it)->setLowPriority(lowPriority);
+    }
+    
     // Handles Audio
     
     static bool handlesAudio() { return T::handlesAudio(); }
@@ -303,6 +313,7 @@ private:
                 {
                     mBlocks.add(new T(getContext(), &mSerialisedParameters, getProxy()));
                     mBlocks.back()->setStream(this, i);
+                    mBlocks.back()->setLowPriority(mLowPriority);
                     mBlocks.back()->reset(mSamplingRate, mMaxBlockSize);
                 }
             }
@@ -366,6 +377,7 @@ private:
 
     unsigned long mMaxBlockSize;
     double mSamplingRate;
+    bool mLowPriority;
     
     std::vector<double *> mAudioTemps;
 };
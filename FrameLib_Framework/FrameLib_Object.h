@@ -262,6 +262,10 @@ public:
     virtual void blockUpdate(const double * const *ins, double **outs, unsigned long blockSize) = 0;
     virtual void reset(double samplingRate, unsigned long maxBlockSize) = 0;
     
+    // Priority (only relevant to schedulers - their frames may be dropped if processing exceeds the budget of the context)
+    
+    virtual void setLowPriority(bool lowPriority) {}
+    
     // Return to host to request to be passed audio
     
     static bool handlesAudio()  { return false; }
@@ -444,6 +448,7 @@ protected:
     }
     
     void clearAllocator() { mAllocator->clear(); }
+    void pruneAllocator() { mAllocator->prune(); }
     
     FrameLib_LocalAllocator::Storage *registerStorage(const char *name)     { return mAllocator->registerStorage(name); }
     
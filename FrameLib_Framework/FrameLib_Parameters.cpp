@@ -97,6 +97,17 @@ void FrameLib_Parameters::Serial::Iterator::read(FrameLib_Parameters *parameters
     }
 }
 
+void FrameLib_Parameters::Serial::Iterator::read(FrameLib_Parameters *parameters, unsigned long idx) const
+{
+    Entry entry = getEntry();
+    
+    switch (entry.mType)
+    {
+        case kVector:           parameters->set(idx, entry.data<double>(), entry.mSize);            break;
+        case kSingleString:     parameters->set(idx, entry.data<char>());                           break;
+    }
+}
+
 unsigned long FrameLib_Parameters::Serial::Iterator::read(double *output, unsigned long size) const
 {
     Entry entry = getEntry();
@@ -696,6 +707,97 @@ FrameLib_Parameters::SetError FrameLib_Parameters::Array::set(double *values, un
 
 // ************************************************************************************** //
 
+// Binding Class
+
+void FrameLib_Parameters::Binding::set(FrameLib_Parameters *parameters, const Serial *serialised)
+{
+    if (!serialised)
+        return;
+    
+    // N.B. this is called when processing, so the cache is never resized (tags beyond its size are looked up each time)
+    
+    for (auto it = serialised->begin(); it != serialised->end(); it++)
+    {
+        unsigned long position = it.getIndex();
+        long idx = position < mIndices.size() ? mIndices[position] : -1;
+        
+        if (idx < 0 || idx >= static_cast<long>(parameters->size()) || strcmp(it.getTag(), parameters->mParameters[idx]->name()))
+            idx = parameters->getIdx(it.getTag());
+        
+        if (position < mIndices.size())
+            mIndices[position] = idx;
+        
+        if (idx >= 0)
+            it.read(parameters, idx);
+    }
+}
+
+// ************************************************************************************** //
+
+// Name Index
+
+uint32_t FrameLib_Parameters::hashName(const char *name)
+{
+    // FNV-1a
+    
+    uint32_t hash = 2166136261U;
+    
+    for (; *name; name++)
+        hash = (hash ^ static_cast<unsigned char>(*name)) * 16777619U;
+    
+    return hash;
+}
+
+void FrameLib_Parameters::addToIndex(unsigned long idx)
+{
+    // Keep the load factor at or below one half (the table size is always a power of two)
+    
+    if (mIndex.size() < (mParameters.size() * 2))
+    {
+        unsigned long tableSize = 8;
+        
+        while (tableSize < (mParameters.size() * 2))
+            tableSize <<= 1;
+        
+        mIndex.assign(tableSize, -1);
+        mIndexHashes.assign(tableSize, 0);
+        
+        for (unsigned long i = 0; i < mParameters.size(); i++)
+            addToIndex(i);
+        
+        return;
+    }
+    
+    uint32_t hash = hashName(mParameters[idx]->name());
+    unsigned long mask = static_cast<unsigned long>(mIndex.size() - 1);
+    unsigned long position = hash & mask;
+    
+    while (mIndex[position] >= 0)
+        position = (position + 1) & mask;
+    
+    mIndex[position] = static_cast<long>(idx);
+    mIndexHashes[position] = hash;
+}
+
+long FrameLib_Parameters::findName(const char *name) const
+{
+    if (mIndex.empty())
+        return -1;
+    
+    uint32_t hash = hashName(name);
+    unsigned long mask = static_cast<unsigned long>(mIndex.size() - 1);
+    
+    // N.B. if names are duplicated the first parameter added is found, matching a linear search
+    
+    for (unsigned long position = hash & mask; mIndex[position] >= 0; position = (position + 1) & mask)
+        if (mIndexHashes[position] == hash && !strcmp(name, mParameters[mIndex[position]]->name()))
+            return mIndex[position];
+    
+    return -1;
+}
+
+// ************************************************************************************** //
+
 // Getters
 
 FrameLib_Parameters::NumericType FrameLib_Parameters::getNumericType(unsigned long idx) const
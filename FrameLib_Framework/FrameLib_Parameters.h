@@ -6,6 +6,7 @@
 #include "FrameLib_Errors.h"
 
 #include <vector>
+#include <cstdint>
 #include <cstring>
 #include <cassert>
 #include <limits>
@@ -117,6 +118,7 @@ public:
             
             void read(Serial *serial) const;
             void read(FrameLib_Parameters *parameters) const;
+            void read(FrameLib_Parameters *parameters, unsigned long idx) const;
             unsigned long read(double *output, unsigned long size) const;
             
             // Aliases (read but aliasing to a new tag)
@@ -284,6 +286,33 @@ public:
         bool checkSize(unsigned long writeSize);
     };
     
+    /**
+     
+     @class Binding
+     
+     @brief a cache of the parameter indices resolved for the tags of a Serial, by position.
+     
+     Tagged frames arriving at the same input usually have the same tags in the same order, so the indices resolved for one frame can be replayed for the next. Each cached index is verified against the tag with a single string comparison, and is resolved again if it does not match (so any change of layout is handled correctly).
+     
+     The cache is sized on construction so that setting parameters never allocates (tags beyond the cached positions are looked up on each frame).
+     
+     */
+    
+    class Binding
+    {
+        static const unsigned long sNumCachedTags = 64;
+        
+    public:
+        
+        Binding() : mIndices(sNumCachedTags, -1) {}
+        
+        void set(FrameLib_Parameters *parameters, const Serial *serialised);
+    
+    private:
+        
+        std::vector<long> mIndices;
+    };
+    
     /**
      
      @class Info
@@ -560,9 +589,10 @@ public:
     
     long getIdx(const char *name) const
     {
-        for (unsigned long i = 0; i < mParameters.size(); i++)
-            if (strcmp(name, mParameters[i]->name()) == 0)
-                return i;
+        long idx = findName(name);
+        
+        if (idx >= 0)
+            return idx;
         
         long argumentIdx = convertToNumber(name);
         
@@ -673,6 +703,7 @@ public:
     // Set Value
     
     void set(Serial *serialised)                                { if (serialised) serialised->read(this); }
+    void set(const Serial *serialised, Binding& binding)        { binding.set(this, serialised); }
     
     void set(unsigned long idx, bool value)                     { set(idx, (double) value); }
     void set(const char *name, bool value)                      { set(name, (double) value); }
@@ -823,8 +854,15 @@ private:
     {
         assert((index == mParameters.size()) && "parameters must be added in order");
         mParameters.add(parameter);
+        addToIndex(index);
     }
     
+    // Name Index (open addressing hash table of parameter indices)
+    
+    static uint32_t hashName(const char *name);
+    void addToIndex(unsigned long idx);
+    long findName(const char *name) const;
+    
     static long convertToNumber(const char *name)
     {
         long result = 0;
@@ -851,6 +889,9 @@ private:
     
     FrameLib_OwnedList<Parameter> mParameters;
     Info *mParameterInfo;
+    
+    std::vector<uint32_t> mIndexHashes;
+    std::vector<long> mIndex;
 };
 
 #endif
@@ -2,61 +2,446 @@
 #include "FrameLib_ProcessingQueue.h"
 #include "FrameLib_DSP.h"
 
+// Identification of the parallel queue and work queue index serviced by the current thread
+
+static thread_local FrameLib_ProcessingQueue *sCurrentQueue = nullptr;
+static thread_local unsigned long sCurrentIndex = 0;
+
+// Work Queue
+
+void FrameLib_ProcessingQueue::WorkQueue::push(FrameLib_DSP *object)
+{
+    FrameLib_SpinLockHolder lock(&mLock);
+    
+    object->mNext = mTop;
+    mTop = object;
+}
+
+FrameLib_DSP *FrameLib_ProcessingQueue::WorkQueue::pop()
+{
+    FrameLib_SpinLockHolder lock(&mLock);
+    
+    FrameLib_DSP *object = mTop;
+    
+    if (object)
+    {
+        mTop = object->mNext;
+        object->mNext = nullptr;
+    }
+    
+    return object;
+}
+
+// Constructor / Destructor
+
+FrameLib_ProcessingQueue::FrameLib_ProcessingQueue(FrameLib_ErrorReporter& errorReporter)
+: mTop(nullptr), mTail(nullptr), mOutstanding(0), mQueued(0), mNumAwake(0), mNumServicing(0), mTimedOut(false)
+, mBudget(Clock::duration::zero()), mPolicy(kDeadlineDrop), mBlockElapsed(Clock::duration::zero())
+, mOverBudget(false), mPrevOverBudget(false), mFlushing(false), mDeferred(false), mHasDroppedFrames(false), mNumDroppedFrames(0)
+, mScheduleGeneration(1), mNumFrames(0), mErrorReporter(errorReporter)
+{}
+
+FrameLib_ProcessingQueue::~FrameLib_ProcessingQueue()
+{
+    setNumThreads(1);
+}
+
+// Reset
+
+void FrameLib_ProcessingQueue::reset()
+{
+    // Any deferred work is discarded (objects clear their own queue pointers on reset)
+    
+    mTop = mTail = nullptr;
+    
+    for (auto it = mWorkQueues.begin(); it != mWorkQueues.end(); it++)
+        (*it)->clear();
+    
+    mOutstanding = 0;
+    mQueued = 0;
+    mTimedOut = false;
+    mDeferred = false;
+    mHasDroppedFrames = false;
+    
+    mBlockTime = FrameLib_TimeFormat(0);
+    mBlockElapsed = Clock::duration::zero();
+    mOverBudget.store(false, std::memory_order_relaxed);
+    mPrevOverBudget.store(false, std::memory_order_relaxed);
+}
+
+// Threading
+
+void FrameLib_ProcessingQueue::setNumThreads(unsigned long numThreads)
+{
+    assert((mDeferred || (!mTop && !mOutstanding)) && "Cannot change the number of threads whilst processing");
+    
+    // Any deferred work is discarded (objects must be reset before processing again)
+    
+    mTop = mTail = nullptr;
+    mOutstanding = 0;
+    mQueued = 0;
+    mDeferred = false;
+    
+    // Compiled schedules depend on the threading mode (they are recompiled on the next reset)
+    
+    invalidateSchedules();
+    
+    // Join and remove all current workers
+    
+    for (auto it = mWorkers.begin(); it != mWorkers.end(); it++)
+        (*it)->join();
+    
+    mWorkers.clear();
+    mWorkQueues.clear();
+    
+    // A single thread uses the serial queue
+    
+    if (numThreads < 2)
+        return;
+    
+    // The thread that starts processing services the first work queue, and workers service the remainder
+    
+    for (unsigned long i = 0; i < numThreads; i++)
+        mWorkQueues.add(new WorkQueue());
+    
+    for (unsigned long i = 1; i < numThreads; i++)
+    {
+        mWorkers.add(new WorkerThread(*this, i));
+        mWorkers.back()->start();
+    }
+}
+
+// Add an object to the queue
+
 void FrameLib_ProcessingQueue::add(FrameLib_DSP *object)
 {
     assert(object->mInputTime != FrameLib_TimeFormat::largest() && "Object has already reached the end of time");
-    assert((!object->mNext || mTop == object) && "Object is already in the queue and not at the top");
-
+    
     if (mTimedOut)
         return;
     
+    if (mWorkQueues.size())
+    {
+        addParallel(object);
+        return;
+    }
+    
+    assert((!object->mNext || mTop == object) && "Object is already in the queue and not at the top");
+    
     if (!mTop)
     {
         // Queue is empty - add and start processing the queue
         
         mTop = mTail = object;
         
-        // Get time
+        if (deferWork())
+            return;
         
-        mClock.start();
-        int count = 0;
+        startRun();
+        processSerial();
+        endRun();
+    }
+    else
+    {
+        // Add to the queue (which is already processing or holds deferred work)
         
-        while (mTop)
+        mTail->mNext = object;
+        mTail = object;
+    }
+}
+
+// Serial Processing
+
+void FrameLib_ProcessingQueue::processSerial()
+{
+    const int checkInterval = mBudget > Clock::duration::zero() ? sProcessPerBudgetCheck : sProcessPerTimeCheck;
+    
+    int count = 0;
+    
+    while (mTop)
+    {
+        FrameLib_DSP *object = mTop;
+        object->dependenciesReady();
+        mTop = object->mNext;
+        object->mNext = nullptr;
+        
+        // Every so often check whether we're taking too long (deferred work is left in the queue)
+        
+        if (++count == checkInterval)
         {
-            object = mTop;
-            object->dependenciesReady();
-            mTop = object->mNext;
-            object->mNext = nullptr;
-            
-            // Every so often check whether we're taking too long
-            
-            if (++count == sProcessPerTimeCheck)
+            if (checkTime())
             {
-                if (mClock.elapsed() > sMaxTime)
+                if (!mTimedOut)
+                    return;
+                
+                // Clear the list
+                
+                while (mTop)
                 {
-                    mTimedOut = true;
-                    
-                    // Clear the list
-                    
-                    while (mTop)
-                    {
-                        mErrorReporter.reportError(kErrorDSP, mTop->getProxy(), "FrameLib - DSP time out - FrameLib is disabled in this context until this is resolved");
-                        object = mTop;
-                        mTop = object->mNext;
-                        object->mNext = nullptr;
-                    }
+                    object = mTop;
+                    mTop = object->mNext;
+                    object->mNext = nullptr;
+                    timeOut(object);
                 }
-                count = 0;
             }
+            count = 0;
+        }
+    }
+    
+    mTail = nullptr;
+}
+
+// Parallel Processing
+
+void FrameLib_ProcessingQueue::addParallel(FrameLib_DSP *object)
+{
+    // N.B. the outstanding count must be incremented before the object is visible to other threads
+    
+    ++mOutstanding;
+    ++mQueued;
+    
+    // Objects added during processing (or whilst work is deferred) go to the work queue of the adding thread
+    
+    if (sCurrentQueue == this)
+    {
+        mWorkQueues[sCurrentIndex]->push(object);
+        wakeWorkers();
+        return;
+    }
+    
+    mWorkQueues[0]->push(object);
+    
+    if (mDeferred || deferWork())
+        return;
+    
+    // Otherwise this thread starts processing and blocks until there is no outstanding work
+    
+    startRun();
+    wakeWorkers();
+    serviceQueue(0);
+    endRun();
+}
+
+void FrameLib_ProcessingQueue::wakeWorkers()
+{
+    // Wake idle workers only whilst there is more queued work than awake workers
+    
+    for (auto it = mWorkers.begin(); it != mWorkers.end() && mNumAwake.load(std::memory_order_relaxed) < mQueued.load(std::memory_order_relaxed); it++)
+        (*it)->wake();
+}
+
+void FrameLib_ProcessingQueue::serviceQueue(unsigned long index)
+{
+    FrameLib_ProcessingQueue *prevQueue = sCurrentQueue;
+    unsigned long prevIndex = sCurrentIndex;
+    
+    const int checkInterval = mBudget > Clock::duration::zero() ? sProcessPerBudgetCheck : sProcessPerTimeCheck;
+    
+    sCurrentQueue = this;
+    sCurrentIndex = index;
+    
+    // Workers are counted so that the thread that started processing can wait for them to stop when work is deferred
+    
+    if (index)
+        ++mNumServicing;
+    
+    FrameLib_Backoff backoff;
+    
+    for (int count = 0; mOutstanding && !mDeferred; )
+    {
+        FrameLib_DSP *object = getWork(index);
+        
+        if (object)
+        {
+            if (mTimedOut)
+                timeOut(object);
+            else
+                object->dependenciesReady();
+            
+            --mOutstanding;
+            backoff.reset();
         }
+        else
+        {
+            // Workers that find no work for a while return to waiting (the thread that started processing continues)
+            
+            if (index && backoff.count() >= sWorkerIdleSpins)
+                break;
+            
+            backoff.wait();
+        }
+        
+        // Every so often check whether we're taking too long (only on the thread that started processing)
         
-        mTail = nullptr;
+        if (!index && ++count == checkInterval)
+        {
+            checkTime();
+            count = 0;
+        }
     }
+    
+    if (index)
+        --mNumServicing;
     else
     {
-        // Add to the queue (which is already processing)
+        backoff.reset();
         
-        mTail->mNext = object;
-        mTail = object;
+        while (mNumServicing)
+            backoff.wait();
+    }
+    
+    sCurrentQueue = prevQueue;
+    sCurrentIndex = prevIndex;
+}
+
+FrameLib_DSP *FrameLib_ProcessingQueue::getWork(unsigned long index)
+{
+    // Take from this thread's work queue first, and then attempt to steal from others
+    
+    size_t size = mWorkQueues.size();
+    
+    for (size_t i = 0; i < size; i++)
+    {
+        if (FrameLib_DSP *object = mWorkQueues[(index + i) % size]->pop())
+        {
+            --mQueued;
+            return object;
+        }
     }
+    
+    return nullptr;
+}
+
+// Timing
+
+void FrameLib_ProcessingQueue::startRun()
+{
+    mRunStart = Clock::now();
+}
+
+void FrameLib_ProcessingQueue::endRun()
+{
+    mBlockElapsed += Clock::now() - mRunStart;
+    checkBudget(mBlockElapsed);
+}
+
+bool FrameLib_ProcessingQueue::checkTime()
+{
+    Clock::duration elapsed = Clock::now() - mRunStart;
+    
+    // Time out if processing appears not to terminate
+    
+    if (elapsed > std::chrono::seconds(static_cast<long long>(sMaxTime)))
+    {
+        mTimedOut = true;
+        return true;
+    }
+    
+    checkBudget(mBlockElapsed + elapsed);
+    
+    return deferWork();
+}
+
+void FrameLib_ProcessingQueue::checkBudget(Clock::duration blockElapsed)
+{
+    // The soft deadline policy applies from the point the budget is exceeded until the end of the block
+    
+    if (mBudget > Clock::duration::zero() && !mOverBudget.load(std::memory_order_relaxed) && blockElapsed > mBudget)
+    {
+        mOverBudget.store(true, std::memory_order_relaxed);
+        mDeadlineStatistics.mOverruns++;
+    }
+}
+
+bool FrameLib_ProcessingQueue::deferWork()
+{
+    // Work is deferred when over budget unless the queue is completing work that has already been deferred
+    
+    if (mOverBudget.load(std::memory_order_relaxed) && mPolicy == kDeadlineDefer && !mFlushing)
+    {
+        if (!mDeferred)
+            mDeadlineStatistics.mDeferrals++;
+        
+        mDeferred = true;
+        return true;
+    }
+    
+    return false;
+}
+
+void FrameLib_ProcessingQueue::timeOut(FrameLib_DSP *object)
+{
+    mErrorReporter.reportError(kErrorDSP, object->getProxy(), "FrameLib - DSP time out - FrameLib is disabled in this context until this is resolved");
+}
+
+// Soft Deadline
+
+void FrameLib_ProcessingQueue::blockStart(FrameLib_TimeFormat blockStartTime)
+{
+    // Only the first object to update in each block starts a new block
+    
+    if (blockStartTime <= mBlockTime)
+        return;
+    
+    // Complete the statistics for the previous block
+    
+    if (mBlockTime != FrameLib_TimeFormat(0))
+    {
+        double blockTime = std::chrono::duration<double, std::micro>(mBlockElapsed).count();
+        
+        mDeadlineStatistics.mBlocks++;
+        mDeadlineStatistics.mMaxBlockTime = std::max(mDeadlineStatistics.mMaxBlockTime, blockTime);
+        
+        if (isDegraded())
+            mDeadlineStatistics.mDegradedBlocks++;
+    }
+    
+    // Dropping and degraded processing continue for one block after an overrun
+    
+    mPrevOverBudget.store(mOverBudget.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    mOverBudget.store(false, std::memory_order_relaxed);
+    mBlockTime = blockStartTime;
+    mBlockElapsed = Clock::duration::zero();
+    
+    // Complete any deferred work before the block time of any object is updated
+    
+    if (mDeferred || mTop)
+        flushDeferred();
+}
+
+void FrameLib_ProcessingQueue::flushDeferred()
+{
+    mFlushing = true;
+    mDeferred = false;
+    
+    startRun();
+    
+    if (isParallel())
+    {
+        wakeWorkers();
+        serviceQueue(0);
+    }
+    else
+        processSerial();
+    
+    endRun();
+    
+    mFlushing = false;
+}
+
+// Deadline Statistics
+
+FrameLib_ProcessingQueue::DeadlineStatistics FrameLib_ProcessingQueue::getDeadlineStatistics() const
+{
+    DeadlineStatistics statistics = mDeadlineStatistics;
+    
+    statistics.mDroppedFrames = mNumDroppedFrames.load(std::memory_order_relaxed);
+    
+    return statistics;
+}
+
+void FrameLib_ProcessingQueue::resetDeadlineStatistics()
+{
+    mDeadlineStatistics = DeadlineStatistics();
+    mNumDroppedFrames.store(0, std::memory_order_relaxed);
 }
@@ -4,7 +4,10 @@
 
 #include "FrameLib_Types.h"
 #include "FrameLib_Errors.h"
+#include "FrameLib_Threading.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 
 // Forward Declarations
@@ -25,40 +28,121 @@ class FrameLib_DSP;
  
  @brief a minimal processing queue that is used to non-recursively process FrameLIB_DSP objects in a network.
  
+ By default the queue is serial and is processed on the thread that adds the first object. If more than one thread is requested the queue becomes parallel: objects whose dependencies are ready are pushed onto per-worker work queues, which are serviced (and stolen from) by a pool of worker threads together with the thread that adds the first object. That thread blocks until all work resulting from its notification is complete. Workers are only woken whilst there is more queued work than awake workers, and after a bounded period without work (pausing and then yielding) they return to waiting on their semaphores.
+ 
+ Objects that are compiled into the schedule of a root object (see FrameLib_DSP) never enter the queue. Schedules are only compiled for serial queues, and are recompiled on reset after any change to connections or threading in the context.
+ 
+ Optionally a soft deadline can be set, as a budget of processing time per audio block. When the budget is exceeded the queue applies one of several policies: the remaining work can be deferred to the start of the next block (frames that then arrive late at outputs are lost), or (for the remainder of the block and the following block) frames from low priority schedulers can be dropped or objects can be signalled to use cheaper processing. Overruns are counted rather than disabling processing. A hard time out (which disables the context until it is reset) is retained only to guard against processing that does not terminate.
+ 
  */
 
 class FrameLib_ProcessingQueue
 {
+    using Clock = std::chrono::steady_clock;
+    
     /**
      
-     @class IntervalSecondsClock
+     @class WorkQueue
      
-     @brief a clock for measuring time intervals in seconds.
+     @brief a lockable stack of objects ready for processing, owned by a single worker but open to stealing by others.
      
      */
-
-    class IntervalSecondsClock
+    
+    class WorkQueue
     {
         
     public:
         
-        void start() { mStartTime = getTime(); }
-        long long elapsed() { return std::chrono::duration_cast<std::chrono::seconds>(getTime() - mStartTime).count(); }
+        WorkQueue() : mTop(nullptr) {}
+        
+        // Non-copyable
+        
+        WorkQueue(const WorkQueue&) = delete;
+        WorkQueue& operator=(const WorkQueue&) = delete;
+        
+        void push(FrameLib_DSP *object);
+        FrameLib_DSP *pop();
+        void clear() { mTop = nullptr; }
         
     private:
         
-        std::chrono::steady_clock::time_point getTime() { return mClock.now(); }
-
-        std::chrono::steady_clock mClock;
-        std::chrono::steady_clock::time_point mStartTime;
+        FrameLib_SpinLock mLock;
+        FrameLib_DSP *mTop;
+    };
+    
+    /**
+     
+     @class WorkerThread
+     
+     @brief a thread that services the queue whilst there is outstanding work, and otherwise waits to be woken.
+     
+     */
+    
+    class WorkerThread final : public FrameLib_TriggerableThread
+    {
+        
+    public:
+        
+        WorkerThread(FrameLib_ProcessingQueue& queue, unsigned long index)
+        : FrameLib_TriggerableThread(FrameLib_Thread::kAudioPriority), mQueue(queue), mIndex(index), mAwake(false) {}
+        
+        // Wake the thread if it is not already awake (returns true if the thread was woken)
+        
+        bool wake()
+        {
+            if (!compareAndSwap(mAwake, false, true))
+                return false;
+            
+            ++mQueue.mNumAwake;
+            signal();
+            return true;
+        }
+        
+    private:
+        
+        void doTask() override
+        {
+            mQueue.serviceQueue(mIndex);
+            --mQueue.mNumAwake;
+            mAwake.store(false);
+        }
+        
+        FrameLib_ProcessingQueue& mQueue;
+        unsigned long mIndex;
+        std::atomic<bool> mAwake;
     };
     
     static const int sProcessPerTimeCheck = 200;
+    static const int sProcessPerBudgetCheck = 8;
     static const int sMaxTime = 5;
+    static const unsigned long sWorkerIdleSpins = 256;
     
 public:
     
-    FrameLib_ProcessingQueue(FrameLib_ErrorReporter& errorReporter) : mTop(nullptr), mTail(nullptr), mTimedOut(false), mErrorReporter(errorReporter) {}
+    enum DeadlinePolicy { kDeadlineDrop, kDeadlineDefer, kDeadlineDegrade };
+    
+    /**
+     
+     @struct DeadlineStatistics
+     
+     @brief counters for processing time against the soft deadline (times are in microseconds).
+     
+     */
+    
+    struct DeadlineStatistics
+    {
+        DeadlineStatistics() : mBlocks(0), mOverruns(0), mDroppedFrames(0), mDeferrals(0), mDegradedBlocks(0), mMaxBlockTime(0.0) {}
+        
+        unsigned long long mBlocks;             /**< the number of completed audio blocks */
+        unsigned long long mOverruns;           /**< the number of blocks in which the budget was exceeded */
+        unsigned long long mDroppedFrames;      /**< the number of frames dropped (including those dropped downstream) */
+        unsigned long long mDeferrals;          /**< the number of times that work was deferred to the next block */
+        unsigned long long mDegradedBlocks;     /**< the number of blocks processed wholly or partly in degraded mode */
+        double mMaxBlockTime;                   /**< the maximum processing time in a single block */
+    };
+    
+    FrameLib_ProcessingQueue(FrameLib_ErrorReporter& errorReporter);
+    ~FrameLib_ProcessingQueue();
     
     // Non-copyable
     
@@ -66,16 +150,129 @@ public:
     FrameLib_ProcessingQueue& operator=(const FrameLib_ProcessingQueue&) = delete;
     
     void add(FrameLib_DSP *object);
-    void reset() { mTimedOut = false; }
+    void reset();
     bool isTimedOut() { return mTimedOut; }
+    
+    // Soft Deadline (a budget of zero disables the deadline - N.B. these should not be called whilst the queue is processing)
+    
+    void setBudget(double microseconds)                 { mBudget = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::micro>(std::max(microseconds, 0.0))); }
+    double getBudget() const                            { return std::chrono::duration<double, std::micro>(mBudget).count(); }
+    void setDeadlinePolicy(DeadlinePolicy policy)       { mPolicy = policy; }
+    DeadlinePolicy getDeadlinePolicy() const            { return mPolicy; }
+    
+    // Called by objects at the start of each audio block (before the block time is updated)
+    
+    void blockStart(FrameLib_TimeFormat blockStartTime);
+    
+    // Deadline state queried by objects during processing
+    
+    bool isDropping() const                             { return mPolicy == kDeadlineDrop && isOverBudget(); }
+    bool hasDroppedFrames() const                       { return mHasDroppedFrames.load(std::memory_order_relaxed); }
+    bool isDegraded() const                             { return mPolicy == kDeadlineDegrade && isOverBudget(); }
+    
+    void frameDropped()
+    {
+        mHasDroppedFrames.store(true, std::memory_order_relaxed);
+        mNumDroppedFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    // Deadline Statistics
+    
+    DeadlineStatistics getDeadlineStatistics() const;
+    void resetDeadlineStatistics();
+    
+    // Threading (N.B. - this should not be called whilst the queue is processing, and discards any deferred work)
+    
+    void setNumThreads(unsigned long numThreads);
+    unsigned long getNumThreads() const { return std::max(static_cast<unsigned long>(mWorkQueues.size()), 1UL); }
+    bool isParallel() const { return mWorkQueues.size() != 0; }
+
+    // Compiled Schedules (the generation changes whenever connections or threading change in the context)
+    
+    void invalidateSchedules() { mScheduleGeneration++; }
+    unsigned long getScheduleGeneration() const { return mScheduleGeneration; }
+    
+    // Frame Counting (all frames processed by objects in the context, including those in compiled schedules)
+    
+    void frameProcessed()
+    {
+        if (isParallel())
+            mNumFrames.fetch_add(1, std::memory_order_relaxed);
+        else
+            mNumFrames.store(mNumFrames.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    
+    unsigned long long getNumFrames() const { return mNumFrames.load(std::memory_order_relaxed); }
+    void resetNumFrames() { mNumFrames.store(0, std::memory_order_relaxed); }
 
 private:
     
+    // Parallel Processing
+    
+    void addParallel(FrameLib_DSP *object);
+    void serviceQueue(unsigned long index);
+    void wakeWorkers();
+    FrameLib_DSP *getWork(unsigned long index);
+    
+    // Serial Processing
+    
+    void processSerial();
+    
+    // Timing
+    
+    void startRun();
+    void endRun();
+    bool checkTime();
+    void checkBudget(Clock::duration blockElapsed);
+    
+    // N.B. - the budget state is written by the thread that started processing and read by all threads (as a hint, so ordering is relaxed)
+    
+    bool isOverBudget() const
+    {
+        return mOverBudget.load(std::memory_order_relaxed) || mPrevOverBudget.load(std::memory_order_relaxed);
+    }
+    
+    bool deferWork();
+    void timeOut(FrameLib_DSP *object);
+    void flushDeferred();
+    
+    // Serial Queue
+    
     FrameLib_DSP *mTop;
     FrameLib_DSP *mTail;
     
-    bool mTimedOut;
-    IntervalSecondsClock mClock;
+    // Parallel Queue
+    
+    FrameLib_OwnedList<WorkQueue> mWorkQueues;
+    FrameLib_OwnedList<WorkerThread> mWorkers;
+    std::atomic<long> mOutstanding;
+    std::atomic<long> mQueued;
+    std::atomic<long> mNumAwake;
+    std::atomic<unsigned long> mNumServicing;
+    
+    // Timing
+    
+    std::atomic<bool> mTimedOut;
+    Clock::time_point mRunStart;
+    
+    // Soft Deadline
+    
+    Clock::duration mBudget;
+    DeadlinePolicy mPolicy;
+    FrameLib_TimeFormat mBlockTime;
+    Clock::duration mBlockElapsed;
+    
+    std::atomic<bool> mOverBudget;
+    std::atomic<bool> mPrevOverBudget;
+    bool mFlushing;
+    std::atomic<bool> mDeferred;
+    std::atomic<bool> mHasDroppedFrames;
+    
+    DeadlineStatistics mDeadlineStatistics;
+    std::atomic<unsigned long long> mNumDroppedFrames;
+    
+    unsigned long mScheduleGeneration;
+    std::atomic<unsigned long long> mNumFrames;
     
     FrameLib_ErrorReporter& mErrorReporter;
 };
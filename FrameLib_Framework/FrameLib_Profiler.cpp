@@ -0,0 +1,215 @@
+
+#include "FrameLib_Profiler.h"
+#include "FrameLib_SerialiseGraph.h"
+
+#include <algorithm>
+#include <cstdio>
+
+// Thread identification for tracing (small indices are easier to read than native identifiers)
+
+static unsigned long getThreadIndex()
+{
+    static std::atomic<unsigned long> sNextIndex(0);
+    static thread_local unsigned long sIndex = sNextIndex++;
+    
+    return sIndex;
+}
+
+// Registration (identifiers are unique across contexts)
+
+std::atomic<unsigned long> FrameLib_Profiler::sNextID(0);
+
+void FrameLib_Profiler::addEntry(Entry *entry, FrameLib_Proxy *proxy)
+{
+    FrameLib_SpinLockHolder lock(&mLock);
+    
+    entry->mID = sNextID++;
+    entry->mProxy = proxy;
+    mEntries.push_back(entry);
+}
+
+void FrameLib_Profiler::removeEntry(Entry *entry)
+{
+    FrameLib_SpinLockHolder lock(&mLock);
+    
+    auto it = std::find(mEntries.begin(), mEntries.end(), entry);
+    
+    if (it != mEntries.end())
+        mEntries.erase(it);
+}
+
+// Timing
+
+void FrameLib_Profiler::processed(Entry& entry, TimePoint start, bool newFrame)
+{
+    TimePoint end = now();
+    uint64_t time = toNanoseconds(end - start);
+    
+    Entry::increment(entry.mFrames, newFrame ? 1 : 0);
+    Entry::increment(entry.mProcessTime, time);
+    
+    if (time > entry.mMaxProcessTime.load(std::memory_order_relaxed))
+        entry.mMaxProcessTime.store(time, std::memory_order_relaxed);
+    
+    if (mTraceCapacity)
+        trace(entry, kEventProcess, start, end);
+}
+
+void FrameLib_Profiler::updated(Entry& entry, TimePoint start)
+{
+    TimePoint end = now();
+    
+    Entry::increment(entry.mUpdateTime, toNanoseconds(end - start));
+    
+    if (mTraceCapacity)
+        trace(entry, kEventUpdate, start, end);
+}
+
+// Tracing
+
+void FrameLib_Profiler::setTraceCapacity(unsigned long capacity)
+{
+    mTrace.resize(capacity);
+    mTraceCapacity = capacity;
+    mTraceCount = 0;
+}
+
+void FrameLib_Profiler::trace(Entry& entry, EventType type, TimePoint start, TimePoint end)
+{
+    unsigned long index = mTraceCount.fetch_add(1, std::memory_order_relaxed);
+    
+    if (index < mTraceCapacity)
+    {
+        TraceEvent& event = mTrace[index];
+        
+        event.mID = entry.mID;
+        event.mType = entry.mType;
+        event.mEventType = type;
+        event.mThread = getThreadIndex();
+        event.mStart = toNanoseconds(start.time_since_epoch());
+        event.mDuration = toNanoseconds(end - start);
+    }
+    else if (index == mTraceCapacity)
+        mErrorReporter.reportError(kErrorDSP, entry.mProxy, "FrameLib - profiling trace is full (further events will not be recorded)");
+}
+
+// Retrieval
+
+void FrameLib_Profiler::getRecords(std::vector<Record>& records)
+{
+    FrameLib_SpinLockHolder lock(&mLock);
+    
+    for (auto it = mEntries.begin(); it != mEntries.end(); it++)
+    {
+        Entry& entry = **it;
+        Record record;
+        
+        record.mID = entry.mID;
+        record.mProxy = entry.mProxy;
+        
+        if (entry.mType)
+            getTypeString(record.mType, *entry.mType);
+        
+        record.mCalls = entry.mCalls.load(std::memory_order_relaxed);
+        record.mFrames = entry.mFrames.load(std::memory_order_relaxed);
+        record.mProcessTime = entry.mProcessTime.load(std::memory_order_relaxed);
+        record.mMaxProcessTime = entry.mMaxProcessTime.load(std::memory_order_relaxed);
+        record.mUpdateTime = entry.mUpdateTime.load(std::memory_order_relaxed);
+        record.mBytesAllocated = entry.mBytesAllocated.load(std::memory_order_relaxed);
+        
+        records.push_back(record);
+    }
+}
+
+void FrameLib_Profiler::getTrace(std::vector<TraceEvent>& events)
+{
+    unsigned long count = std::min(mTraceCount.load(), mTraceCapacity);
+    
+    events.insert(events.end(), mTrace.begin(), mTrace.begin() + count);
+}
+
+void FrameLib_Profiler::reset()
+{
+    FrameLib_SpinLockHolder lock(&mLock);
+    
+    for (auto it = mEntries.begin(); it != mEntries.end(); it++)
+    {
+        (*it)->mCalls = 0;
+        (*it)->mFrames = 0;
+        (*it)->mProcessTime = 0;
+        (*it)->mMaxProcessTime = 0;
+        (*it)->mUpdateTime = 0;
+        (*it)->mBytesAllocated = 0;
+    }
+    
+    mTraceCount = 0;
+}
+
+// Output
+
+static void writeJSONString(std::ostream& output, const std::string& str)
+{
+    output << "\"";
+    
+    for (auto it = str.begin(); it != str.end(); it++)
+    {
+        if (*it == '"' || *it == '\\')
+            output << "\\" << *it;
+        else
+            output << *it;
+    }
+    
+    output << "\"";
+}
+
+void FrameLib_Profiler::writeJSON(std::ostream& output, const std::vector<Record>& records)
+{
+    output << "{\n  \"objects\": [";
+    
+    for (auto it = records.begin(); it != records.end(); it++)
+    {
+        output << (it == records.begin() ? "\n" : ",\n");
+        output << "    { \"id\": " << it->mID << ", \"type\": ";
+        writeJSONString(output, it->mType);
+        output << ", \"calls\": " << it->mCalls;
+        output << ", \"frames\": " << it->mFrames;
+        output << ", \"process_ns\": " << it->mProcessTime;
+        output << ", \"max_process_ns\": " << it->mMaxProcessTime;
+        output << ", \"update_ns\": " << it->mUpdateTime;
+        output << ", \"bytes_allocated\": " << it->mBytesAllocated << " }";
+    }
+    
+    output << "\n  ]\n}\n";
+}
+
+void FrameLib_Profiler::writeChromeTrace(std::ostream& output, const std::vector<TraceEvent>& events)
+{
+    const int strBufSize = 64;
+    char formatted[strBufSize];
+    
+    std::string type;
+    
+    output << "{\n  \"traceEvents\": [";
+    
+    for (auto it = events.begin(); it != events.end(); it++)
+    {
+        if (it->mType)
+            getTypeString(type, *it->mType);
+        else
+            type = "unknown";
+        
+        // Times are in microseconds
+        
+        output << (it == events.begin() ? "\n" : ",\n");
+        output << "    { \"name\": ";
+        writeJSONString(output, type);
+        output << ", \"cat\": \"" << (it->mEventType == kEventProcess ? "process" : "update") << "\", \"ph\": \"X\"";
+        snprintf(formatted, strBufSize, "%.3f", it->mStart / 1000.0);
+        output << ", \"ts\": " << formatted;
+        snprintf(formatted, strBufSize, "%.3f", it->mDuration / 1000.0);
+        output << ", \"dur\": " << formatted;
+        output << ", \"pid\": 0, \"tid\": " << it->mThread << ", \"args\": { \"id\": " << it->mID << " } }";
+    }
+    
+    output << "\n  ]\n}\n";
+}
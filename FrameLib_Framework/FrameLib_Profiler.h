@@ -0,0 +1,206 @@
+
+#ifndef FRAMELIB_PROFILER_H
+#define FRAMELIB_PROFILER_H
+
+#include "FrameLib_Types.h"
+#include "FrameLib_Errors.h"
+#include "FrameLib_Threading.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+/**
+ 
+ @defgroup Profiling
+ 
+ */
+
+/**
+ 
+ @class FrameLib_Profiler
+ 
+ @ingroup Profiling
+ 
+ @brief a per-context collector of processing statistics for individual FrameLib_DSP objects.
+ 
+ Instrumentation of FrameLib_DSP objects is only compiled when FRAMELIB_PROFILING is defined (otherwise no entries are ever added, and the profiler is never accessed during processing). Each object owns an Entry which it registers on construction. The counters of an entry are only written by the thread processing the object, so they are stored without atomic read-modify-write, and may be read safely (but not necessarily consistently) from other threads.
+ 
+ Optionally the profiler also stores a trace of timed processing events in a fixed size buffer, which can be written in the Chrome trace event format (for chrome://tracing or Perfetto).
+ 
+ */
+
+class FrameLib_Profiler
+{
+    using Clock = std::chrono::steady_clock;
+
+public:
+    
+    using TimePoint = Clock::time_point;
+    
+    enum EventType { kEventProcess, kEventUpdate };
+    
+    /**
+     
+     @class Entry
+     
+     @brief the counters for a single object (owned by the object).
+     
+     */
+    
+    class Entry
+    {
+        friend class FrameLib_Profiler;
+    
+    public:
+        
+        Entry() : mID(0), mType(nullptr), mProxy(nullptr), mCalls(0), mFrames(0), mProcessTime(0), mMaxProcessTime(0), mUpdateTime(0), mBytesAllocated(0) {}
+        
+        // Non-copyable
+        
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+        
+        // Set the dynamic type of the owning object (N.B. this cannot be determined during construction)
+        
+        void setType(const std::type_info& type)    { mType = &type; }
+        
+        // Counting
+        
+        void addCall()                              { increment(mCalls, 1); }
+        void addBytesAllocated(size_t size)         { increment(mBytesAllocated, size); }
+    
+    private:
+        
+        static void increment(std::atomic<uint64_t>& counter, uint64_t amount)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+        
+        unsigned long mID;
+        const std::type_info *mType;
+        FrameLib_Proxy *mProxy;
+        
+        std::atomic<uint64_t> mCalls;
+        std::atomic<uint64_t> mFrames;
+        std::atomic<uint64_t> mProcessTime;
+        std::atomic<uint64_t> mMaxProcessTime;
+        std::atomic<uint64_t> mUpdateTime;
+        std::atomic<uint64_t> mBytesAllocated;
+    };
+    
+    /**
+     
+     @struct Record
+     
+     @brief a snapshot of the counters for a single object (times are in nanoseconds).
+     
+     */
+    
+    struct Record
+    {
+        unsigned long mID;                  /**< a unique identifier for the object */
+        std::string mType;                  /**< the C++ type of the object */
+        FrameLib_Proxy *mProxy;             /**< the proxy of the object (identifying it to the host) */
+        
+        uint64_t mCalls;                    /**< the number of times that the object's dependencies were ready */
+        uint64_t mFrames;                   /**< the number of frames produced by process() (or schedule() for schedulers) */
+        uint64_t mProcessTime;              /**< the total time spent in process() or schedule() */
+        uint64_t mMaxProcessTime;           /**< the maximum time spent in a single call to process() or schedule() */
+        uint64_t mUpdateTime;               /**< the total time spent in update() and setting parameters from inputs */
+        uint64_t mBytesAllocated;           /**< the total size of output allocations */
+    };
+    
+    /**
+     
+     @struct TraceEvent
+     
+     @brief a single timed event (times are in nanoseconds on the steady clock).
+     
+     */
+    
+    struct TraceEvent
+    {
+        unsigned long mID;
+        const std::type_info *mType;
+        EventType mEventType;
+        unsigned long mThread;
+        uint64_t mStart;
+        uint64_t mDuration;
+    };
+    
+    // Constructor
+    
+    FrameLib_Profiler(FrameLib_ErrorReporter& errorReporter)
+    : mTraceCapacity(0), mTraceCount(0), mErrorReporter(errorReporter) {}
+    
+    // Non-copyable
+    
+    FrameLib_Profiler(const FrameLib_Profiler&) = delete;
+    FrameLib_Profiler& operator=(const FrameLib_Profiler&) = delete;
+    
+    // Compile-time status
+
+#ifdef FRAMELIB_PROFILING
+    static constexpr bool isEnabled() { return true; }
+#else
+    static constexpr bool isEnabled() { return false; }
+#endif
+    
+    // Registration
+    
+    void addEntry(Entry *entry, FrameLib_Proxy *proxy);
+    void removeEntry(Entry *entry);
+    
+    // Timing
+    
+    static TimePoint now() { return Clock::now(); }
+    
+    void processed(Entry& entry, TimePoint start, bool newFrame = true);
+    void updated(Entry& entry, TimePoint start);
+    
+    // Tracing (N.B. the capacity should not be changed whilst processing - zero disables tracing)
+    
+    void setTraceCapacity(unsigned long capacity);
+    unsigned long getTraceCapacity() const { return mTraceCapacity; }
+    
+    // Retrieval
+    
+    void getRecords(std::vector<Record>& records);
+    void getTrace(std::vector<TraceEvent>& events);
+    void reset();
+    
+    // Output
+    
+    static void writeJSON(std::ostream& output, const std::vector<Record>& records);
+    static void writeChromeTrace(std::ostream& output, const std::vector<TraceEvent>& events);
+
+private:
+    
+    void trace(Entry& entry, EventType type, TimePoint start, TimePoint end);
+    
+    static uint64_t toNanoseconds(Clock::duration duration)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    }
+    
+    // Entries
+    
+    FrameLib_SpinLock mLock;
+    std::vector<Entry *> mEntries;
+    static std::atomic<unsigned long> sNextID;
+    
+    // Trace
+    
+    std::vector<TraceEvent> mTrace;
+    unsigned long mTraceCapacity;
+    std::atomic<unsigned long> mTraceCount;
+    
+    FrameLib_ErrorReporter& mErrorReporter;
+};
+
+#endif /* FRAMELIB_PROFILER_H */
@@ -9,22 +9,22 @@
 #ifdef __GNUC__
 #include <cxxabi.h>
 
-void unmangleName(std::string& name, FrameLib_Object<FrameLib_Multistream> *obj)
+void unmangleName(std::string& name, const std::type_info& type)
 {
     int status;
     
-    const char *type_mangled_name = typeid(*obj).name();
+    const char *type_mangled_name = type.name();
     char *real_name = abi::__cxa_demangle(type_mangled_name, 0, 0, &status);
     
     name = real_name;
     free(real_name);
 }
 #else
-void unmangleName(std::string& name, FrameLib_Object<FrameLib_Multistream> *obj)
+void unmangleName(std::string& name, const std::type_info& type)
 {
     // FIX - needs implementing
     
-    const char *type_mangled_name = typeid(*obj).name();
+    const char *type_mangled_name = type.name();
     name = type_mangled_name;
 }
 #endif
@@ -111,9 +111,20 @@ size_t findAndResolveFunctions(std::string& name, size_t beg, size_t end)
     }
 }
 
-void getTypeString(std::string& name, FrameLib_Object<FrameLib_Multistream> *obj)
+void removeInlineNamespaces(std::string& name)
 {
-    unmangleName(name, obj);
+    // Remove the inline namespace used by libc++ so that names match across standard libraries
+    
+    const std::string inlineNamespace("std::__1::");
+    
+    for (size_t pos = name.find(inlineNamespace); pos != std::string::npos; pos = name.find(inlineNamespace, pos))
+        name.erase(pos + 5, 5);
+}
+
+void getTypeString(std::string& name, const std::type_info& type)
+{
+    unmangleName(name, type);
+    removeInlineNamespaces(name);
 
     // Resolve functions recursively
     
@@ -184,7 +195,7 @@ void serialiseGraph(std::vector<FrameLib_ObjectDescription>& objects, FrameLib_M
         objects.push_back(FrameLib_ObjectDescription());
         FrameLib_ObjectDescription& description = objects.back();
         
-        getTypeString(description.mObjectType, object);
+        getTypeString(description.mObjectType, typeid(*object));
         description.mNumStreams = object->getNumStreams();
         
         // Parameters
@@ -330,6 +341,215 @@ std::string serialiseGraph(FrameLib_Multistream *requestObject)
     return output.str();
 }
 
+// Graph Text Format
+
+void writeValues(std::ostream& output, const std::vector<double>& vector)
+{
+    const int strBufSize = 64;
+    char formatted[strBufSize];
+    
+    output << vector.size();
+    
+    for (auto it = vector.begin(); it != vector.end(); it++)
+    {
+        snprintf(formatted, strBufSize, "%.17g", *it);
+        output << " " << formatted;
+    }
+}
+
+bool readValues(std::istringstream& input, std::vector<double>& vector)
+{
+    std::string value;
+    unsigned long size = 0;
+    
+    if (!(input >> size))
+        return false;
+    
+    vector.resize(size);
+    
+    // N.B. values are read with strtod in order to accept inf and nan
+    
+    for (unsigned long i = 0; i < size; i++)
+    {
+        char *end;
+        
+        if (!(input >> value))
+            return false;
+        
+        vector[i] = strtod(value.c_str(), &end);
+        
+        if (*end)
+            return false;
+    }
+    
+    return true;
+}
+
+std::string readRemainder(std::istringstream& input)
+{
+    std::string remainder;
+    
+    input >> std::ws;
+    std::getline(input, remainder);
+    
+    return remainder;
+}
+
+void writeGraph(std::ostream& output, const std::vector<FrameLib_ObjectDescription>& objects)
+{
+    const unsigned long kOrdering = -1;
+    
+    output << "framelib_graph 1\n";
+    
+    for (auto it = objects.begin(); it != objects.end(); it++)
+    {
+        output << "\nobject " << it->mObjectType << "\n";
+        output << "streams " << it->mNumStreams << "\n";
+        
+        for (auto jt = it->mParameters.begin(); jt != it->mParameters.end(); jt++)
+        {
+            output << "parameter " << jt->mTag;
+            
+            if (jt->mType == kVector)
+            {
+                output << " vector ";
+                writeValues(output, jt->mVector);
+                output << "\n";
+            }
+            else
+                output << " string " << jt->mString << "\n";
+        }
+        
+        for (auto jt = it->mInputs.begin(); jt != it->mInputs.end(); jt++)
+        {
+            if (jt->size())
+            {
+                output << "input " << (jt - it->mInputs.begin()) << " ";
+                writeValues(output, *jt);
+                output << "\n";
+            }
+        }
+        
+        for (auto jt = it->mConnections.begin(); jt != it->mConnections.end(); jt++)
+        {
+            if (jt->mInputIndex == kOrdering)
+                output << "ordering " << jt->mObjectIndex << " " << jt->mOutputIndex << "\n";
+            else
+                output << "connection " << jt->mObjectIndex << " " << jt->mOutputIndex << " " << jt->mInputIndex << "\n";
+        }
+        
+        output << "end\n";
+    }
+}
+
+bool readGraph(std::istream& input, std::vector<FrameLib_ObjectDescription>& objects)
+{
+    const unsigned long kOrdering = -1;
+    
+    std::string line;
+    std::string keyword;
+    bool inObject = false;
+    
+    objects.clear();
+    
+    if (!std::getline(input, line) || line.compare(0, 15, "framelib_graph ") != 0)
+        return false;
+    
+    while (std::getline(input, line))
+    {
+        std::istringstream lineStream(line);
+        
+        // Skip blank lines and comments
+        
+        if (!(lineStream >> keyword) || keyword[0] == '#')
+            continue;
+        
+        if (keyword == "object")
+        {
+            if (inObject)
+                return false;
+            
+            objects.push_back(FrameLib_ObjectDescription());
+            objects.back().mObjectType = readRemainder(lineStream);
+            inObject = true;
+            continue;
+        }
+        
+        if (!inObject)
+            return false;
+        
+        FrameLib_ObjectDescription& description = objects.back();
+        
+        if (keyword == "end")
+            inObject = false;
+        else if (keyword == "streams")
+        {
+            if (!(lineStream >> description.mNumStreams))
+                return false;
+        }
+        else if (keyword == "parameter")
+        {
+            FrameLib_ObjectDescription::Tagged tagged;
+            std::string type;
+            
+            if (!(lineStream >> tagged.mTag >> type))
+                return false;
+            
+            if (type == "vector")
+            {
+                tagged.mType = kVector;
+                if (!readValues(lineStream, tagged.mVector))
+                    return false;
+            }
+            else if (type == "string")
+            {
+                tagged.mType = kSingleString;
+                tagged.mString = readRemainder(lineStream);
+            }
+            else
+                return false;
+            
+            description.mParameters.push_back(tagged);
+        }
+        else if (keyword == "input")
+        {
+            unsigned long idx;
+            
+            if (!(lineStream >> idx))
+                return false;
+            
+            if (description.mInputs.size() <= idx)
+                description.mInputs.resize(idx + 1);
+            
+            if (!readValues(lineStream, description.mInputs[idx]))
+                return false;
+        }
+        else if (keyword == "connection" || keyword == "ordering")
+        {
+            unsigned long objectIdx, outIdx, inIdx = kOrdering;
+            
+            if (!(lineStream >> objectIdx >> outIdx) || (keyword == "connection" && !(lineStream >> inIdx)))
+                return false;
+            
+            description.mConnections.push_back(FrameLib_ObjectDescription::Connection(objectIdx, outIdx, inIdx));
+        }
+        else
+            return false;
+    }
+    
+    // Check that the last object is complete and that all connections refer to earlier objects
+    
+    if (inObject)
+        return false;
+    
+    for (auto it = objects.begin(); it != objects.end(); it++)
+        for (auto jt = it->mConnections.begin(); jt != it->mConnections.end(); jt++)
+            if (jt->mObjectIndex >= static_cast<unsigned long>(it - objects.begin()))
+                return false;
+    
+    return true;
+}
+
 std::string exportClassName(const char *codeIn, const char *classname)
 {
     std::string codeOut(codeIn);
@@ -364,10 +584,14 @@ ExportError exportWriteFile(std::stringstream& contents, const char *path, const
 ExportError exportGraph(FrameLib_Multistream *requestObject, const char *path, const char *className)
 {
     ExportError error = kExportSuccess;
-    std::stringstream header, cpp;
+    std::vector<FrameLib_ObjectDescription> objects;
+    std::stringstream header, cpp, graph;
+    
+    serialiseGraph(objects, requestObject);
     
     header << exportClassName(exportHeader, className);
     cpp << exportClassName(exportCPPOpen, className) << serialiseGraph(requestObject) << exportClassName(exportCPPClose, className);
+    writeGraph(graph, objects);
 
     if ((error = exportWriteFile(header, path, className, ".h")))
         return error;
@@ -375,5 +599,8 @@ ExportError exportGraph(FrameLib_Multistream *requestObject, const char *path, c
     if ((error = exportWriteFile(cpp, path, className, ".cpp")))
         return error;
     
+    if ((error = exportWriteFile(graph, path, className, ".flgraph")))
+        return error;
+    
     return kExportSuccess;
 }
@@ -4,6 +4,10 @@
 
 #include "FrameLib_Multistream.h"
 
+#include <istream>
+#include <ostream>
+#include <typeinfo>
+
 /**
  
  @defgroup Serialisation
@@ -89,12 +93,56 @@ struct FrameLib_ObjectDescription
 
 void serialiseGraph(std::vector<FrameLib_ObjectDescription>& objects, FrameLib_Multistream *requestObject);
 
+/**
+ 
+ @ingroup Serialisation
+ 
+ @brief get the type string used to describe objects of a given C++ type in a FrameLib_ObjectDescription.
+ 
+ @param name a reference to a std::string in which to return the type string.
+ @param type the std::type_info of the object type (for instance typeid(FrameLib_Expand<FrameLib_Plus>)).
+ 
+ */
+
+void getTypeString(std::string& name, const std::type_info& type);
+
+/**
+ 
+ @ingroup Serialisation
+ 
+ @brief write a serialised graph in a line-based text format that can be loaded without compilation.
+ 
+ Each object is written as a block starting with an "object" line and ending with an "end" line. Values are written with full precision.
+ 
+ @param output a reference to a std::ostream in which to write the graph.
+ @param objects a reference to a std::vector<FrameLib_ObjectDescription> containing the serialised description.
+ 
+ */
+
+void writeGraph(std::ostream& output, const std::vector<FrameLib_ObjectDescription>& objects);
+
+/**
+ 
+ @ingroup Serialisation
+ 
+ @brief read a serialised graph from the text format written by writeGraph().
+ 
+ @param input a reference to a std::istream from which to read the graph.
+ @param objects a reference to a std::vector<FrameLib_ObjectDescription> in which to return the serialised description.
+ @return true if the graph was read successfully, or false if the input was malformed.
+ 
+ */
+
+bool readGraph(std::istream& input, std::vector<FrameLib_ObjectDescription>& objects);
+
 /**
  
  @ingroup Serialisation
 
  @brief export C++ code for a graph from a pointer to any object in the graph.
  
+ Alongside the .h and .cpp files a .flgraph file is written in the text format of writeGraph().
+ 
  @param requestObject a pointer to any pointer to a FrameLib_Multistream object within a graph.
  @param path a C-string containing the path in which to write the output files.
  @param className a C-string containing the name of the class to be created in the exported code.
@@ -5,6 +5,11 @@
 #include "FrameLib_Types.h"
 
 #include <atomic>
+#include <thread>
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 /**
  
@@ -71,6 +76,54 @@ bool nullSwap(std::atomic<T *>& value, T *exchange)
 }
 
 
+/**
+ 
+ @class FrameLib_Backoff
+ 
+ @ingroup Threading
+ 
+ @brief a helper for spinning threads that pauses the processor for a bounded number of spins and then yields the thread.
+ 
+ Yielding allows a thread that has been preempted whilst holding a lock (or producing work) to make progress on a loaded system.
+ 
+ */
+
+class FrameLib_Backoff
+{
+    static const unsigned long sPauseSpins = 64;
+    
+public:
+    
+    FrameLib_Backoff() : mCount(0) {}
+    
+    void wait()
+    {
+        if (mCount++ < sPauseSpins)
+            pause();
+        else
+            std::this_thread::yield();
+    }
+    
+    void reset()                    { mCount = 0; }
+    unsigned long count() const     { return mCount; }
+    
+private:
+    
+    static void pause()
+    {
+#if defined(_WIN32)
+        YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+        _mm_pause();
+#elif defined(__arm__) || defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+    
+    unsigned long mCount;
+};
+
+
 /**
  
  @class FrameLib_SpinLock
@@ -95,8 +148,15 @@ public:
     FrameLib_SpinLock& operator=(const FrameLib_SpinLock&) = delete;
     
     bool attempt() { return compareAndSwap(mAtomicLock, false, true); }
-    void acquire() { while (attempt() == false); }
-    void release() { compareAndSwap(mAtomicLock, true, false); }
+    void release() { mAtomicLock.store(false, std::memory_order_release); }
+    
+    void acquire()
+    {
+        FrameLib_Backoff backoff;
+        
+        while (attempt() == false)
+            backoff.wait();
+    }
     
 private:
     
@@ -161,7 +221,7 @@ public:
     enum PriorityLevel {kLowPriority, kMediumPriority, kHighPriority, kAudioPriority};
 
     FrameLib_Thread(PriorityLevel priority, ThreadFunctionType *threadFunction, void *arg)
-    : mInternal(nullptr), mPriority(priority), mThreadFunction(threadFunction), mArg(arg), mValid(false)
+    : mInternal(), mPriority(priority), mThreadFunction(threadFunction), mArg(arg), mValid(false)
     {}
 
     ~FrameLib_Thread();
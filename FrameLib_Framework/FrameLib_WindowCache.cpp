@@ -0,0 +1,294 @@
+
+#include "FrameLib_WindowCache.h"
+#include "../FrameLib_Dependencies/WindowFunctions.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <new>
+
+// Window Calculator
+
+struct WindowCalculator : public WindowFunctions<double *, FrameLib_WindowCache::WindowTypes>
+{
+    WindowCalculator()
+    {
+        add(FrameLib_WindowCache::kHann, window_hann);
+        add(FrameLib_WindowCache::kHamming, window_hamming);
+        add(FrameLib_WindowCache::kTriangle, window_triangle);
+        add(FrameLib_WindowCache::kCosine, window_cosine);
+        add(FrameLib_WindowCache::kBlackman, window_blackman);
+        add(FrameLib_WindowCache::kBlackman62, window_blackman_62);
+        add(FrameLib_WindowCache::kBlackman70, window_blackman_70);
+        add(FrameLib_WindowCache::kBlackman74, window_blackman_74);
+        add(FrameLib_WindowCache::kBlackman92, window_blackman_92);
+        add(FrameLib_WindowCache::kBlackmanHarris, window_blackman_harris);
+        add(FrameLib_WindowCache::kFlatTop, window_flat_top);
+        add(FrameLib_WindowCache::kRectangle, window_rect);
+    }
+};
+
+static WindowCalculator sWindowCalculator;
+
+// Constructor / Destructor
+
+FrameLib_WindowCache::FrameLib_WindowCache(FrameLib_GlobalAllocator& allocator)
+: mAllocator(allocator), mHead(nullptr), mTail(nullptr), mNumTables(0), mNumUnused(0), mCalculated(0), mHits(0), mEvictThread(*this)
+{
+    mEvictThread.start();
+}
+
+FrameLib_WindowCache::~FrameLib_WindowCache()
+{
+    mEvictThread.join();
+    
+    while (mHead)
+    {
+        Entry *entry = mHead;
+        
+        // N.B. all references should have been released by the objects holding them
+        
+        assert(!entry->mCount && "window tables have not been released");
+        unlink(entry);
+        destroy(entry);
+    }
+}
+
+// Acquire / Release
+
+const FrameLib_WindowCache::Table *FrameLib_WindowCache::acquire(WindowTypes type, uint32_t size, uint32_t generateSize, bool sqrtWindow)
+{
+    Entry *created = nullptr;
+    
+    mLock.acquire();
+    
+    Entry *entry = find(type, size, generateSize, sqrtWindow);
+    
+    if (entry)
+        mHits++;
+    else
+    {
+        // Calculate the table without holding the lock
+        
+        mLock.release();
+        created = create(type, size, generateSize, sqrtWindow);
+        mLock.acquire();
+        
+        // Another thread may have calculated the same table in the meantime
+        
+        entry = find(type, size, generateSize, sqrtWindow);
+        
+        if (entry)
+            mHits++;
+        else if (created)
+        {
+            link(created);
+            mNumTables++;
+            mNumUnused++;
+            mCalculated++;
+            entry = created;
+            created = nullptr;
+        }
+    }
+    
+    if (entry)
+    {
+        use(entry);
+        
+        if (!entry->mCount++)
+            mNumUnused--;
+    }
+    
+    mLock.release();
+    
+    destroy(created);
+    
+    return entry ? &entry->mTable : nullptr;
+}
+
+void FrameLib_WindowCache::release(const Table *table)
+{
+    // N.B. the table is the first member of its entry
+    
+    Entry *entry = reinterpret_cast<Entry *>(const_cast<Table *>(table));
+    bool overLimit;
+    
+    {
+        FrameLib_SpinLockHolder lock(&mLock);
+        
+        assert(entry->mCount && "window table is not referenced");
+        
+        use(entry);
+        
+        if (!--entry->mCount)
+            mNumUnused++;
+        
+        overLimit = mNumUnused > maxUnused();
+    }
+    
+    if (overLimit)
+        mEvictThread.signal();
+}
+
+// Statistics
+
+FrameLib_WindowCache::Statistics FrameLib_WindowCache::getStatistics()
+{
+    FrameLib_SpinLockHolder lock(&mLock);
+    
+    Statistics statistics;
+    
+    statistics.mTables = mNumTables;
+    statistics.mReferences = 0;
+    statistics.mCalculated = mCalculated;
+    statistics.mHits = mHits;
+    
+    for (Entry *entry = mHead; entry; entry = entry->mNext)
+        statistics.mReferences += entry->mCount;
+    
+    return statistics;
+}
+
+// Helpers
+
+FrameLib_WindowCache::Entry *FrameLib_WindowCache::find(WindowTypes type, uint32_t size, uint32_t generateSize, bool sqrtWindow)
+{
+    for (Entry *entry = mHead; entry; entry = entry->mNext)
+    {
+        const Table& table = entry->mTable;
+        
+        if (table.mType == type && table.mSize == size && table.mGenerateSize == generateSize && table.mSqrt == sqrtWindow)
+            return entry;
+    }
+    
+    return nullptr;
+}
+
+FrameLib_WindowCache::Entry *FrameLib_WindowCache::create(WindowTypes type, uint32_t size, uint32_t generateSize, bool sqrtWindow)
+{
+    // The entry and its table are allocated together
+    
+    size_t entrySize = FrameLib_GlobalAllocator::alignSize(sizeof(Entry));
+    void *memory = mAllocator.alloc(entrySize + (generateSize + 1) * sizeof(double));
+    
+    if (!memory)
+        return nullptr;
+    
+    Entry *entry = new (memory) Entry();
+    Table& table = entry->mTable;
+    double *window = reinterpret_cast<double *>(static_cast<char *>(memory) + entrySize);
+    
+    sWindowCalculator.calculate(type, window, size, generateSize);
+    
+    window[generateSize] = generateSize ? window[generateSize - 1] : 0.0;
+    
+    if (sqrtWindow)
+        for (uint32_t i = 0; i <= generateSize; i++)
+            window[i] = sqrt(window[i]);
+    
+    // Sum the values between the endpoints
+    
+    table.mLinearSum = 0.0;
+    table.mPowerSum = 0.0;
+    
+    for (uint32_t i = 1; i < size; i++)
+        table.mLinearSum += window[i];
+    
+    for (uint32_t i = 1; i < size; i++)
+        table.mPowerSum += window[i] * window[i];
+    
+    // Store the key
+    
+    table.mWindow = window;
+    table.mType = type;
+    table.mSize = size;
+    table.mGenerateSize = generateSize;
+    table.mSqrt = sqrtWindow;
+    
+    entry->mCount = 0;
+    entry->mPrev = nullptr;
+    entry->mNext = nullptr;
+    
+    return entry;
+}
+
+void FrameLib_WindowCache::destroy(Entry *entry)
+{
+    if (entry)
+    {
+        entry->~Entry();
+        mAllocator.dealloc(entry);
+    }
+}
+
+// List Maintenance (called with the lock held)
+
+void FrameLib_WindowCache::link(Entry *entry)
+{
+    entry->mPrev = nullptr;
+    entry->mNext = mHead;
+    
+    if (mHead)
+        mHead->mPrev = entry;
+    else
+        mTail = entry;
+    
+    mHead = entry;
+}
+
+void FrameLib_WindowCache::unlink(Entry *entry)
+{
+    if (entry->mPrev)
+        entry->mPrev->mNext = entry->mNext;
+    else
+        mHead = entry->mNext;
+    
+    if (entry->mNext)
+        entry->mNext->mPrev = entry->mPrev;
+    else
+        mTail = entry->mPrev;
+}
+
+void FrameLib_WindowCache::use(Entry *entry)
+{
+    if (entry != mHead)
+    {
+        unlink(entry);
+        link(entry);
+    }
+}
+
+// Evict the least recently used unreferenced tables beyond the retention limit (called from the evict thread)
+
+void FrameLib_WindowCache::evict()
+{
+    Entry *evicted = nullptr;
+    
+    {
+        FrameLib_SpinLockHolder lock(&mLock);
+        
+        for (Entry *entry = mTail; entry && mNumUnused > maxUnused(); )
+        {
+            Entry *prev = entry->mPrev;
+            
+            if (!entry->mCount)
+            {
+                unlink(entry);
+                mNumTables--;
+                mNumUnused--;
+                entry->mNext = evicted;
+                evicted = entry;
+            }
+            
+            entry = prev;
+        }
+    }
+    
+    // Free the evicted tables without holding the lock
+    
+    while (evicted)
+    {
+        Entry *next = evicted->mNext;
+        destroy(evicted);
+        evicted = next;
+    }
+}
@@ -0,0 +1,173 @@
+
+#ifndef FRAMELIB_WINDOWCACHE_H
+#define FRAMELIB_WINDOWCACHE_H
+
+#include "FrameLib_Types.h"
+#include "FrameLib_Memory.h"
+#include "FrameLib_Threading.h"
+
+#include <cstdint>
+
+/**
+ 
+ @class FrameLib_WindowCache
+ 
+ @ingroup Memory
+ 
+ @brief a threadsafe reference counted cache of immutable window tables that are shared read-only between all objects using a FrameLib_Global.
+ 
+ Tables are keyed by the window type, the window size, the number of points generated and whether the square root of the window is taken, and store the sums needed to calculate gain compensation. A table is only calculated if no matching table is held, so each distinct configuration is calculated at most once whilst it remains in the cache. Tables that are no longer referenced are retained and evicted in least recently used order once the number of unreferenced tables exceeds a fixed limit. Entries are kept in an intrusive list ordered by recency so that acquiring and releasing tables requires no container allocations, and eviction is performed by a low priority thread so that it never runs on the threads using the tables.
+ 
+ */
+
+class FrameLib_WindowCache
+{
+
+public:
+    
+    enum WindowTypes { kHann, kHamming, kTriangle, kCosine, kBlackman, kBlackman62, kBlackman70, kBlackman74, kBlackman92, kBlackmanHarris, kFlatTop, kRectangle };
+    
+    /**
+     
+     @struct Table
+     
+     @brief a single immutable window table.
+     
+     The table holds mGenerateSize + 1 values with the final value repeated (so that the end may be interpolated safely).
+     
+     */
+    
+    struct Table
+    {
+        // Sums over the table including its endpoints (the first value and the value at mSize - 1)
+        
+        double linearSum(bool first, bool last) const   { return mLinearSum + (first ? mWindow[0] : 0.0) + (last && mSize ? mWindow[mSize - 1] : 0.0); }
+        double powerSum(bool first, bool last) const    { return mPowerSum + (first ? mWindow[0] * mWindow[0] : 0.0) + (last && mSize ? mWindow[mSize - 1] * mWindow[mSize - 1] : 0.0); }
+        
+        double *mWindow;
+        
+        WindowTypes mType;
+        uint32_t mSize;
+        uint32_t mGenerateSize;
+        bool mSqrt;
+        
+        double mLinearSum;                  /**< the sum of values 1 to mSize - 1 (exclusive) */
+        double mPowerSum;                   /**< the sum of squared values 1 to mSize - 1 (exclusive) */
+    };
+    
+    /**
+     
+     @struct Statistics
+     
+     @brief the current state of the cache.
+     
+     */
+    
+    struct Statistics
+    {
+        unsigned long mTables;              /**< the number of tables currently held */
+        unsigned long mReferences;          /**< the number of references to those tables */
+        unsigned long mCalculated;          /**< the number of tables calculated (since construction) */
+        unsigned long mHits;                /**< the number of requests served by an existing table (since construction) */
+    };
+    
+    // Constructor / Destructor
+    
+    FrameLib_WindowCache(FrameLib_GlobalAllocator& allocator);
+    ~FrameLib_WindowCache();
+    
+    // Non-copyable
+    
+    FrameLib_WindowCache(const FrameLib_WindowCache&) = delete;
+    FrameLib_WindowCache& operator=(const FrameLib_WindowCache&) = delete;
+    
+    // Acquire a table (returns a nullptr if memory cannot be allocated)
+    
+    const Table *acquire(WindowTypes type, uint32_t size, uint32_t generateSize, bool sqrtWindow);
+    
+    // Release a table previously acquired (this does not free memory)
+    
+    void release(const Table *table);
+    
+    // Statistics
+    
+    Statistics getStatistics();
+
+private:
+    
+    /**
+     
+     @struct Entry
+     
+     @brief a single cached table with its reference count and links to the entries used before and after it.
+     
+     */
+    
+    struct Entry
+    {
+        // N.B. the table must be the first member so that an entry can be found from its table
+        
+        Table mTable;
+        unsigned long mCount;
+        
+        Entry *mPrev;
+        Entry *mNext;
+    };
+    
+    /**
+     
+     @class EvictThread
+     
+     @brief a thread for evicting unreferenced tables beyond the retention limit.
+     
+     */
+    
+    class EvictThread final : public FrameLib_TriggerableThread
+    {
+    
+    public:
+        
+        EvictThread(FrameLib_WindowCache& cache) : FrameLib_TriggerableThread(FrameLib_Thread::kLowPriority), mCache(cache) {}
+    
+    private:
+        
+        void doTask() override { mCache.evict(); };
+        
+        FrameLib_WindowCache& mCache;
+    };
+    
+    // The number of unreferenced tables that are retained
+    
+    static constexpr unsigned long maxUnused() { return 32; }
+    
+    // Helpers
+    
+    Entry *find(WindowTypes type, uint32_t size, uint32_t generateSize, bool sqrtWindow);
+    Entry *create(WindowTypes type, uint32_t size, uint32_t generateSize, bool sqrtWindow);
+    void destroy(Entry *entry);
+    
+    void link(Entry *entry);
+    void unlink(Entry *entry);
+    void use(Entry *entry);
+    
+    void evict();
+    
+    // Member Variables
+    
+    FrameLib_SpinLock mLock;
+    FrameLib_GlobalAllocator& mAllocator;
+    
+    // Entries from the most (head) to least (tail) recently used
+    
+    Entry *mHead;
+    Entry *mTail;
+    
+    unsigned long mNumTables;
+    unsigned long mNumUnused;
+    unsigned long mCalculated;
+    unsigned long mHits;
+    
+    EvictThread mEvictThread;
+};
+
+#endif /* FRAMELIB_WINDOWCACHE_H */
@@ -0,0 +1,8 @@
+
+#include "FrameLib_ISTFT.h"
+#include "FrameLib_MaxClass.h"
+
+extern "C" int C74_EXPORT main(void)
+{
+    FrameLib_MaxClass_Expand<FrameLib_ISTFT>::makeClass("fl.istft~");
+}
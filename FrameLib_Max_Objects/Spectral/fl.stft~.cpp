@@ -0,0 +1,8 @@
+
+#include "FrameLib_STFT.h"
+#include "FrameLib_MaxClass.h"
+
+extern "C" int C74_EXPORT main(void)
+{
+    FrameLib_MaxClass_Expand<FrameLib_STFT>::makeClass("fl.stft~");
+}
@@ -0,0 +1,7 @@
+#include "FrameLib_Descriptors.h"
+#include "FrameLib_MaxClass.h"
+
+extern "C" int C74_EXPORT main(void)
+{
+    FrameLib_MaxClass_Expand<FrameLib_Descriptors>::makeClass("fl.descriptors~");
+}
@@ -13,6 +13,14 @@ namespace FrameLib_Binary_Ops
     struct absDiff { double operator()(double x, double y) { return std::abs(x-y); } };
 }
 
+namespace FrameLib_SIMD_Ops
+{
+    template <> struct Vector<FrameLib_Binary_Ops::absDiff> : Available
+    {
+        template <class V> V operator()(const V& a, const V& b) const { return abs(a - b); }
+    };
+}
+
 // Binary (operators)
 
 // Info specialisations
@@ -3,8 +3,9 @@
 #define FRAMELIB_BINARY_TEMPLATE_H
 
 #include "FrameLib_DSP.h"
+#include "FrameLib_SIMD_Ops.h"
 
-// OPT - vectorise where appropriate
+#include <algorithm>
 
 // Binary Operator
 
@@ -84,7 +85,6 @@ private:
     void process() override
     {
         MismatchModes mode = mMismatchMode;
-        Op op;
         
         unsigned long sizeIn1, sizeIn2, sizeCommon, sizeOut;
         
@@ -110,10 +110,10 @@ private:
                 break;
         }
         
-        // Allocate output
+        // Allocate output (in place if possible, as the calculation is element-wise)
         
         requestOutputSize(0, sizeOut);
-        allocateOutputs();
+        allocateOutputsInPlace(sizeIn1 == sizeOut ? 0 : 1);
         double *output = getOutput(0, &sizeOut);
         sizeCommon = sizeCommon > sizeOut ? sizeOut : sizeCommon;
         
@@ -122,8 +122,7 @@ private:
         
         // Do first part
         
-        for (unsigned long i = 0; i < sizeCommon; i++)
-            output[i] = op(input1[i], input2[i]);
+        FrameLib_SIMD_Ops::binary<Op>(output, input1, input2, sizeCommon);
         
         // Clean up if sizes don't match
         
@@ -136,34 +135,26 @@ private:
                 
                 case kWrap:
                 
+                    // The smaller input is processed in whole blocks (or as a scalar if it has a single value)
+                    
                     if (sizeIn1 > sizeIn2)
                     {
-                       if (sizeIn2 == 1)
-                       {
-                           double value = input2[0];
-                           for (unsigned long i = 1; i < sizeOut; i++)
-                               output[i] = op(input1[i], value);
-                       }
-                       else
-                       {
-                           for (unsigned long i = sizeCommon; i < sizeOut;)
-                               for (unsigned long j = 0; j < sizeIn2 && i < sizeOut; i++, j++)
-                                output[i] = op(input1[i], input2[j]);
-                       }
+                        if (sizeIn2 == 1)
+                            FrameLib_SIMD_Ops::binary<Op>(output + 1, input1 + 1, input2[0], sizeOut - 1);
+                        else
+                        {
+                            for (unsigned long i = sizeCommon; i < sizeOut; i += sizeIn2)
+                                FrameLib_SIMD_Ops::binary<Op>(output + i, input1 + i, input2, std::min(sizeIn2, sizeOut - i));
+                        }
                     }
                     else
                     {
                         if (sizeIn1 == 1)
-                        {
-                            double value = input1[0];
-                            for (unsigned long i = 1; i < sizeOut; i++)
-                                output[i] = op(value, input2[i]);
-                        }
+                            FrameLib_SIMD_Ops::binary<Op>(output + 1, input1[0], input2 + 1, sizeOut - 1);
                         else
                         {
-                            for (unsigned long i = sizeCommon; i < sizeOut;)
-                                for (unsigned long j = 0; j < sizeIn1 && i < sizeOut; i++, j++)
-                                    output[i] = op(input1[j], input2[i]);
+                            for (unsigned long i = sizeCommon; i < sizeOut; i += sizeIn1)
+                                FrameLib_SIMD_Ops::binary<Op>(output + i, input1, input2 + i, std::min(sizeIn1, sizeOut - i));
                         }
                     }
                     break;
@@ -171,15 +162,9 @@ private:
                 case kPadIn:
                     
                     if (sizeIn1 > sizeIn2)
-                    {
-                        for (unsigned long i = sizeCommon; i < sizeOut; i++)
-                            output[i] = op(input1[i], defaultValue);
-                    }
+                        FrameLib_SIMD_Ops::binary<Op>(output + sizeCommon, input1 + sizeCommon, defaultValue, sizeOut - sizeCommon);
                     else
-                    {
-                        for (unsigned long i = sizeCommon; i < sizeOut; i++)
-                            output[i] = op(defaultValue, input2[i]);
-                    }
+                        FrameLib_SIMD_Ops::binary<Op>(output + sizeCommon, defaultValue, input2 + sizeCommon, sizeOut - sizeCommon);
                     break;
                     
                 case kPadOut:
@@ -222,4 +207,12 @@ struct Binary_Functor
 template<double func(double, double)>
 using FrameLib_Binary = FrameLib_BinaryOp<Binary_Functor<func>>;
 
+// Vector Versions of Functions
+
+namespace FrameLib_SIMD_Ops
+{
+    template<double func(double, double)>
+    struct Vector<Binary_Functor<func>> : BinaryFunction<func> {};
+}
+
 #endif
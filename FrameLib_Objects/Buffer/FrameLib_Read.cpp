@@ -159,6 +159,11 @@ void FrameLib_Read::process()
             }
         }
         
+        // Use linear interpolation when the context is over its processing budget
+        
+        if (isDegraded() && interpType != kInterpNone)
+            interpType = kInterpLinear;
+        
         mProxy->read(output, positions, size, chan, interpType);
         
         dealloc(positions);
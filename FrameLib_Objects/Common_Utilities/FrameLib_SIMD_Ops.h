@@ -0,0 +1,559 @@
+
+#ifndef FRAMELIB_SIMD_OPS_H
+#define FRAMELIB_SIMD_OPS_H
+
+#include "../../FrameLib_Dependencies/SIMDSupport.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+// Vectorised kernels for element-wise operators
+//
+// Operators have a vector version if Vector<Op> is specialised with available set to true, and a templated operator()
+// that accepts SIMDType<double, N> for both the native vector size and a size of one (used for the remainder).
+// Operators without a vector version fall back to the scalar loop.
+//
+// The approximations to exp / exp2 / log / log2 / log10 / sin / cos are only used if FRAMELIB_SIMD_APPROXIMATIONS is defined.
+// They are accurate to a few ulps, but do not return results identical to the standard library (sin / cos are only accurate
+// for arguments with a magnitude of less than around one million, and return NaN for magnitudes greater than 2^50).
+
+namespace FrameLib_SIMD_Ops
+{
+    static const int vecSize = SIMDLimits<double>::max_size;
+    
+    typedef SIMDType<double, vecSize> VecType;
+    typedef SIMDType<double, 1> ScalarType;
+    
+    // Availability
+    
+    struct Available { static const bool available = true; };
+    
+    template <typename Op> struct Vector { static const bool available = false; };
+    template <double func(double)> struct UnaryFunction { static const bool available = false; };
+    template <double func(double, double)> struct BinaryFunction { static const bool available = false; };
+    
+    // Helpers
+    
+    template <class V> V boolean(const V& mask) { return sel(V(0.0), V(1.0), mask); }
+    
+    template <class V> V roundInt(const V& x)
+    {
+        // Rounds to the nearest integer (valid for magnitudes less than 2^51)
+        
+        const V magic(6755399441055744.0);
+        
+        return (x + magic) - magic;
+    }
+    
+    template <class V, int N> V polynomial(const V& x, const double (&coefficients)[N])
+    {
+        V result(coefficients[N - 1]);
+        
+        for (int i = N - 2; i >= 0; i--)
+            result = result * x + V(coefficients[i]);
+        
+        return result;
+    }
+    
+    // Operators
+    
+    template <> struct Vector<std::plus<double>> : Available
+    {
+        template <class V> V operator()(const V& a, const V& b) const { return a + b; }
+    };
+    
+    template <> struct Vector<std::minus<double>> : Available
+    {
+        template <class V> V operator()(const V& a, const V& b) const { return a - b; }
+    };
+    
+    template <> struct Vector<std::multiplies<double>> : Available
+    {
+        template <class V> V operator()(const V& a, const V& b) const { return a * b; }
+    };
+    
+    template <> struct Vector<std::divides<double>> : Available
+    {
+        template <class V> V operator()(const V& a, const V& b) const { return a / b; }
+    };
+    
+    template <> struct Vector<std::equal_to<double>> : Available
+    {
+        template <class V> V operator()(const V& a, const V& b) const { return boolean(a == b); }
+    };
+    
+    template <> struct Vector<std::not_equal_to<double>> : Available
+    {
+        template <class V> V operator()(const V& a, const V& b) const { return boolean(a != b); }
+    };
+    
+    template <> struct Vector<std::greater<double>> : Available
+    {
+        template <class V> V operator()(const V& a, const V& b) const { return boolean(a > b); }
+    };
+    
+    template <> struct Vector<std::less<double>> : Available
+    {
+        template <class V> V operator()(const V& a, const V& b) const { return boolean(a < b); }
+    };
+    
+    template <> struct Vector<std::greater_equal<double>> : Available
+    {
+        template <class V> V operator()(const V& a, const V& b) const { return boolean(a >= b); }
+    };
+    
+    template <> struct Vector<std::less_equal<double>> : Available
+    {
+        template <class V> V operator()(const V& a, const V& b) const { return boolean(a <= b); }
+    };
+    
+    template <> struct Vector<std::logical_and<double>> : Available
+    {
+        template <class V> V operator()(const V& a, const V& b) const
+        {
+            return sel(V(0.0), boolean(b != V(0.0)), a != V(0.0));
+        }
+    };
+    
+    template <> struct Vector<std::logical_or<double>> : Available
+    {
+        template <class V> V operator()(const V& a, const V& b) const
+        {
+            return sel(boolean(b != V(0.0)), V(1.0), a != V(0.0));
+        }
+    };
+    
+    template <> struct Vector<std::logical_not<double>> : Available
+    {
+        template <class V> V operator()(const V& a) const { return boolean(a == V(0.0)); }
+    };
+    
+    // Functions
+    
+    template <> struct UnaryFunction<fabs> : Available
+    {
+        template <class V> V operator()(const V& a) const { return abs(a); }
+    };
+    
+    template <> struct UnaryFunction<sqrt> : Available
+    {
+        template <class V> V operator()(const V& a) const { return sqrt(a); }
+    };
+    
+    // N.B. vector rounding requires SSE4.1 and round() is excluded as the vector version rounds halfway cases to even
+    
+#if defined(__SSE4_1__) || defined(__AVX__)
+    
+    template <> struct UnaryFunction<trunc> : Available
+    {
+        template <class V> V operator()(const V& a) const { return trunc(a); }
+    };
+    
+    template <> struct UnaryFunction<floor> : Available
+    {
+        template <class V> V operator()(const V& a) const { return floor(a); }
+    };
+    
+    template <> struct UnaryFunction<ceil> : Available
+    {
+        template <class V> V operator()(const V& a) const { return ceil(a); }
+    };
+    
+#endif
+    
+    // N.B. the vector min / max return the second argument if either is a NaN, so NaNs are handled explicitly to match fmin / fmax
+    
+    template <> struct BinaryFunction<fmin> : Available
+    {
+        template <class V> V operator()(const V& a, const V& b) const
+        {
+            return sel(sel(min(a, b), a, b != b), b, a != a);
+        }
+    };
+    
+    template <> struct BinaryFunction<fmax> : Available
+    {
+        template <class V> V operator()(const V& a, const V& b) const
+        {
+            return sel(sel(max(a, b), a, b != b), b, a != a);
+        }
+    };
+    
+#ifdef FRAMELIB_SIMD_APPROXIMATIONS
+    
+    // Exponent manipulation (2^n for integral n in the normal range, and the biased exponent of a positive value)
+    
+    static inline ScalarType pow2(const ScalarType& n)
+    {
+        return ldexp(1.0, static_cast<int>(n.mVal));
+    }
+    
+    static inline ScalarType exponent(const ScalarType& x)
+    {
+        int e;
+        frexp(x.mVal, &e);
+        return static_cast<double>(e + 1022);
+    }
+    
+    static inline ScalarType mantissa(const ScalarType& x)
+    {
+        int e;
+        return frexp(x.mVal, &e) * 2.0;
+    }
+    
+    template <class V> V shiftLeft52(const V& a);
+    template <class V> V shiftRight52(const V& a);
+    
+#if (SIMD_COMPILER_SUPPORT_LEVEL == SIMD_COMPILER_SUPPORT_SSE128)
+    
+    template<> inline SIMDType<double, 2> shiftLeft52(const SIMDType<double, 2>& a)
+    {
+        return _mm_castsi128_pd(_mm_slli_epi64(_mm_castpd_si128(a.mVal), 52));
+    }
+    
+    template<> inline SIMDType<double, 2> shiftRight52(const SIMDType<double, 2>& a)
+    {
+        return _mm_castsi128_pd(_mm_srli_epi64(_mm_castpd_si128(a.mVal), 52));
+    }
+    
+#elif (SIMD_COMPILER_SUPPORT_LEVEL == SIMD_COMPILER_SUPPORT_AVX256)
+    
+#ifdef __AVX2__
+    
+    template<> inline SIMDType<double, 4> shiftLeft52(const SIMDType<double, 4>& a)
+    {
+        return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(a.mVal), 52));
+    }
+    
+    template<> inline SIMDType<double, 4> shiftRight52(const SIMDType<double, 4>& a)
+    {
+        return _mm256_castsi256_pd(_mm256_srli_epi64(_mm256_castpd_si256(a.mVal), 52));
+    }
+    
+#else
+    
+    // AVX without AVX2 has no 256 bit integer shifts, so shift each half
+    
+    template<> inline SIMDType<double, 4> shiftLeft52(const SIMDType<double, 4>& a)
+    {
+        __m128i lo = _mm_slli_epi64(_mm_castpd_si128(_mm256_castpd256_pd128(a.mVal)), 52);
+        __m128i hi = _mm_slli_epi64(_mm_castpd_si128(_mm256_extractf128_pd(a.mVal, 1)), 52);
+        
+        return _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_castsi128_pd(lo)), _mm_castsi128_pd(hi), 1);
+    }
+    
+    template<> inline SIMDType<double, 4> shiftRight52(const SIMDType<double, 4>& a)
+    {
+        __m128i lo = _mm_srli_epi64(_mm_castpd_si128(_mm256_castpd256_pd128(a.mVal)), 52);
+        __m128i hi = _mm_srli_epi64(_mm_castpd_si128(_mm256_extractf128_pd(a.mVal, 1)), 52);
+        
+        return _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_castsi128_pd(lo)), _mm_castsi128_pd(hi), 1);
+    }
+    
+#endif
+    
+#elif (SIMD_COMPILER_SUPPORT_LEVEL == SIMD_COMPILER_SUPPORT_AVX512)
+    
+    template<> inline SIMDType<double, 8> shiftLeft52(const SIMDType<double, 8>& a)
+    {
+        return _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_castpd_si512(a.mVal), 52));
+    }
+    
+    template<> inline SIMDType<double, 8> shiftRight52(const SIMDType<double, 8>& a)
+    {
+        return _mm512_castsi512_pd(_mm512_srli_epi64(_mm512_castpd_si512(a.mVal), 52));
+    }
+    
+#endif
+    
+    static inline double fromBits(uint64_t bits)
+    {
+        double value;
+        memcpy(&value, &bits, sizeof(double));
+        return value;
+    }
+    
+    template <class V> V pow2(const V& n)
+    {
+        return shiftLeft52(n + V(4503599627370496.0 + 1023.0));
+    }
+    
+    template <class V> V exponent(const V& x)
+    {
+        const V twoPow52(4503599627370496.0);
+        
+        return (shiftRight52(x) | twoPow52) - twoPow52;
+    }
+    
+    template <class V> V mantissa(const V& x)
+    {
+        return (x & V(fromBits(0x000FFFFFFFFFFFFFU))) | V(1.0);
+    }
+    
+    // Approximations
+    
+    template <class V> V expApprox(const V& x)
+    {
+        const double coefficients[] = { 1.0, 1.0, 1.0 / 2.0, 1.0 / 6.0, 1.0 / 24.0, 1.0 / 120.0, 1.0 / 720.0, 1.0 / 5040.0,
+            1.0 / 40320.0, 1.0 / 362880.0, 1.0 / 3628800.0, 1.0 / 39916800.0, 1.0 / 479001600.0, 1.0 / 6227020800.0 };
+        
+        const V n = roundInt(x * V(1.4426950408889634));
+        const V f = (x - n * V(6.93147180369123816490e-01)) - n * V(1.90821492927058770002e-10);
+        
+        // Scale in two steps so that both factors are in the normal range (this also produces denormal results)
+        
+        const V n1 = roundInt(n * V(0.5));
+        
+        V result = polynomial(f, coefficients) * pow2(n1) * pow2(n - n1);
+        
+        result = sel(result, V(std::numeric_limits<double>::infinity()), x > V(709.782712893384));
+        
+        return sel(result, V(0.0), x < V(-745.1332191019412));
+    }
+    
+    template <class V> V exp2Approx(const V& x)
+    {
+        const double coefficients[] = { 1.0, 1.0, 1.0 / 2.0, 1.0 / 6.0, 1.0 / 24.0, 1.0 / 120.0, 1.0 / 720.0, 1.0 / 5040.0,
+            1.0 / 40320.0, 1.0 / 362880.0, 1.0 / 3628800.0, 1.0 / 39916800.0, 1.0 / 479001600.0, 1.0 / 6227020800.0 };
+        
+        const V n = roundInt(x);
+        const V n1 = roundInt(n * V(0.5));
+        
+        V result = polynomial((x - n) * V(0.6931471805599453), coefficients) * pow2(n1) * pow2(n - n1);
+        
+        result = sel(result, V(std::numeric_limits<double>::infinity()), x >= V(1024.0));
+        
+        return sel(result, V(0.0), x < V(-1075.0));
+    }
+    
+    template <class V> V logApprox(const V& x)
+    {
+        const double coefficients[] = { 2.0, 2.0 / 3.0, 2.0 / 5.0, 2.0 / 7.0, 2.0 / 9.0, 2.0 / 11.0, 2.0 / 13.0, 2.0 / 15.0,
+            2.0 / 17.0, 2.0 / 19.0, 2.0 / 21.0 };
+        
+        // Scale denormals into the normal range
+        
+        const V denormal = x < V(2.2250738585072014e-308);
+        const V y = sel(x, x * V(4503599627370496.0), denormal);
+        
+        // Split into exponent and a mantissa in the range [sqrt(0.5), sqrt(2)]
+        
+        V e = exponent(y) - sel(V(1023.0), V(1023.0 + 52.0), denormal);
+        V m = mantissa(y);
+        
+        const V large = m > V(1.4142135623730951);
+        
+        m = sel(m, m * V(0.5), large);
+        e = sel(e, e + V(1.0), large);
+        
+        // log(m) = 2 * atanh((m - 1) / (m + 1))
+        
+        const V s = (m - V(1.0)) / (m + V(1.0));
+        
+        V result = e * V(6.93147180369123816490e-01) + (s * polynomial(s * s, coefficients) + e * V(1.90821492927058770002e-10));
+        
+        result = sel(result, V(-std::numeric_limits<double>::infinity()), x == V(0.0));
+        result = sel(result, x, x == V(std::numeric_limits<double>::infinity()));
+        result = sel(result, V(std::numeric_limits<double>::quiet_NaN()), x < V(0.0));
+        
+        return sel(result, x, x != x);
+    }
+    
+    template <class V> V sinPolynomial(const V& x)
+    {
+        const double coefficients[] = { 1.0, -1.0 / 6.0, 1.0 / 120.0, -1.0 / 5040.0, 1.0 / 362880.0, -1.0 / 39916800.0,
+            1.0 / 6227020800.0, -1.0 / 1307674368000.0, 1.0 / 355687428096000.0, -1.0 / 121645100408832000.0,
+            1.0 / 51090942171709440000.0 };
+        
+        return x * polynomial(x * x, coefficients);
+    }
+    
+    template <class V> V reducePi(const V& x, const V& n)
+    {
+        // Three part Cody-Waite reduction (the first two parts of pi have 33 bits so that products with n are exact)
+        
+        return ((x - n * V(3.14159265346825122833e+00)) - n * V(1.21542010126079319532e-10)) - n * V(4.04453249742233291160e-21);
+    }
+    
+    template <class V> V isOdd(const V& n)
+    {
+        const V h = n * V(0.5);
+        
+        return h != roundInt(h);
+    }
+    
+    template <class V> V sinApprox(const V& x)
+    {
+        const V n = roundInt(x * V(0.3183098861837907));
+        const V s = sinPolynomial(reducePi(x, n));
+        
+        return sel(sel(s, s * V(-1.0), isOdd(n)), V(std::numeric_limits<double>::quiet_NaN()), abs(x) > V(1125899906842624.0));
+    }
+    
+    template <class V> V cosApprox(const V& x)
+    {
+        // cos(x) = -sin(x - (n + 0.5) * pi) for even n and sin(x - (n + 0.5) * pi) for odd n
+        
+        const V n = roundInt(x * V(0.3183098861837907) - V(0.5));
+        const V s = sinPolynomial(reducePi(x, n + V(0.5)));
+        
+        return sel(sel(s * V(-1.0), s, isOdd(n)), V(std::numeric_limits<double>::quiet_NaN()), abs(x) > V(1125899906842624.0));
+    }
+    
+    template <> struct UnaryFunction<exp> : Available
+    {
+        template <class V> V operator()(const V& a) const { return expApprox(a); }
+    };
+    
+    template <> struct UnaryFunction<exp2> : Available
+    {
+        template <class V> V operator()(const V& a) const { return exp2Approx(a); }
+    };
+    
+    template <> struct UnaryFunction<log> : Available
+    {
+        template <class V> V operator()(const V& a) const { return logApprox(a); }
+    };
+    
+    template <> struct UnaryFunction<log2> : Available
+    {
+        template <class V> V operator()(const V& a) const { return logApprox(a) * V(1.4426950408889634); }
+    };
+    
+    template <> struct UnaryFunction<log10> : Available
+    {
+        template <class V> V operator()(const V& a) const { return logApprox(a) * V(0.43429448190325176); }
+    };
+    
+    template <> struct UnaryFunction<sin> : Available
+    {
+        template <class V> V operator()(const V& a) const { return sinApprox(a); }
+    };
+    
+    template <> struct UnaryFunction<cos> : Available
+    {
+        template <class V> V operator()(const V& a) const { return cosApprox(a); }
+    };
+    
+#endif
+    
+    // Kernels (scalar)
+    
+    template <typename Op, bool = Vector<Op>::available> struct Kernels
+    {
+        static void unary(double *output, const double *input, unsigned long size)
+        {
+            Op op;
+            
+            for (unsigned long i = 0; i < size; i++)
+                output[i] = op(input[i]);
+        }
+        
+        static void binary(double *output, const double *input1, const double *input2, unsigned long size)
+        {
+            Op op;
+            
+            for (unsigned long i = 0; i < size; i++)
+                output[i] = op(input1[i], input2[i]);
+        }
+        
+        static void binary(double *output, const double *input1, double value, unsigned long size)
+        {
+            Op op;
+            
+            for (unsigned long i = 0; i < size; i++)
+                output[i] = op(input1[i], value);
+        }
+        
+        static void binary(double *output, double value, const double *input2, unsigned long size)
+        {
+            Op op;
+            
+            for (unsigned long i = 0; i < size; i++)
+                output[i] = op(value, input2[i]);
+        }
+    };
+    
+    // Kernels (vector)
+    
+    // N.B. the remainder uses the vector operator with a size of one so that all values are calculated identically
+    
+    template <typename Op> struct Kernels<Op, true>
+    {
+        static void unary(double *output, const double *input, unsigned long size)
+        {
+            Vector<Op> op;
+            unsigned long i = 0;
+            
+            for (; i + vecSize <= size; i += vecSize)
+                op(VecType(input + i)).store(output + i);
+            
+            for (; i < size; i++)
+                op(ScalarType(input[i])).store(output + i);
+        }
+        
+        static void binary(double *output, const double *input1, const double *input2, unsigned long size)
+        {
+            Vector<Op> op;
+            unsigned long i = 0;
+            
+            for (; i + vecSize <= size; i += vecSize)
+                op(VecType(input1 + i), VecType(input2 + i)).store(output + i);
+            
+            for (; i < size; i++)
+                op(ScalarType(input1[i]), ScalarType(input2[i])).store(output + i);
+        }
+        
+        static void binary(double *output, const double *input1, double value, unsigned long size)
+        {
+            Vector<Op> op;
+            const VecType vValue(value);
+            unsigned long i = 0;
+            
+            for (; i + vecSize <= size; i += vecSize)
+                op(VecType(input1 + i), vValue).store(output + i);
+            
+            for (; i < size; i++)
+                op(ScalarType(input1[i]), ScalarType(value)).store(output + i);
+        }
+        
+        static void binary(double *output, double value, const double *input2, unsigned long size)
+        {
+            Vector<Op> op;
+            const VecType vValue(value);
+            unsigned long i = 0;
+            
+            for (; i + vecSize <= size; i += vecSize)
+                op(vValue, VecType(input2 + i)).store(output + i);
+            
+            for (; i < size; i++)
+                op(ScalarType(value), ScalarType(input2[i])).store(output + i);
+        }
+    };
+    
+    // Entry points (N.B. output may alias either input provided that the indices are the same)
+    
+    template <typename Op> void unary(double *output, const double *input, unsigned long size)
+    {
+        Kernels<Op>::unary(output, input, size);
+    }
+    
+    template <typename Op> void binary(double *output, const double *input1, const double *input2, unsigned long size)
+    {
+        Kernels<Op>::binary(output, input1, input2, size);
+    }
+    
+    template <typename Op> void binary(double *output, const double *input1, double value, unsigned long size)
+    {
+        Kernels<Op>::binary(output, input1, value, size);
+    }
+    
+    template <typename Op> void binary(double *output, double value, const double *input2, unsigned long size)
+    {
+        Kernels<Op>::binary(output, value, input2, size);
+    }
+}
+
+#endif
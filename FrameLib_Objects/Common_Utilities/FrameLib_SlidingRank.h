@@ -0,0 +1,148 @@
+#ifndef FRAMELIB_SLIDINGRANK_H
+#define FRAMELIB_SLIDINGRANK_H
+
+#include "FrameLib_Sort_Functions.h"
+
+// Sliding Rank
+
+// N.B. - this tracks the value of a given rank in a fixed width window in which one value is replaced at a time
+// N.B. - values are held in two indexed heaps (a max heap of the values up to the rank and a min heap of those above it)
+// N.B. - replacement is O(log width) and the value at the rank is available in constant time
+// N.B. - NaNs are ordered above all other values matching FrameLib_Sort_Functions.h
+// N.B. - values are stored in heap order alongside their slots so that comparisons do not require indirection
+// N.B. - storage is supplied by the caller (width values and 2 * width indices) and must remain valid whilst in use
+
+class FrameLib_SlidingRank
+{
+
+public:
+    
+    // Constructor
+    
+    FrameLib_SlidingRank(double *values, unsigned long *indices, unsigned long width, unsigned long rank)
+    : mValues(values), mHeap(indices), mPositions(indices + width), mWidth(width), mLowerSize(std::min(rank, width - 1) + 1)
+    {}
+    
+    // Set all values (in slot order) and build the heaps
+    
+    void reset(const double *values)
+    {
+        sortIndicesAscending(mPositions, values, mWidth);
+        
+        // Ascending order is a valid min heap and descending order a valid max heap
+        
+        for (unsigned long i = 0; i < mLowerSize; i++)
+            mHeap[i] = mPositions[mLowerSize - (i + 1)];
+        for (unsigned long i = mLowerSize; i < mWidth; i++)
+            mHeap[i] = mPositions[i];
+        for (unsigned long i = 0; i < mWidth; i++)
+        {
+            mValues[i] = values[mHeap[i]];
+            mPositions[mHeap[i]] = i;
+        }
+    }
+    
+    // Replace the value in a given slot and return the value at the rank
+    
+    double replace(unsigned long slot, double value)
+    {
+        unsigned long position = mPositions[slot];
+        
+        mValues[position] = value;
+        
+        if (position < mLowerSize)
+        {
+            fixLower(position);
+            
+            if (hasUpper() && less(mValues[mLowerSize], mValues[0]))
+                exchangeTops();
+        }
+        else
+        {
+            fixUpper(position - mLowerSize);
+            
+            if (less(mValues[mLowerSize], mValues[0]))
+                exchangeTops();
+        }
+        
+        return rankValue();
+    }
+    
+    // The value at the rank
+    
+    double rankValue() const    { return mValues[0]; }
+
+private:
+    
+    static bool less(double a, double b)    { return a < b || (std::isnan(b) && !std::isnan(a)); }
+    
+    bool hasUpper() const   { return mLowerSize < mWidth; }
+    
+    // Heap ordering (the lower heap has the highest value at the top and the upper heap the lowest)
+    
+    bool aboveLower(unsigned long i, unsigned long j) const { return less(mValues[j], mValues[i]); }
+    bool aboveUpper(unsigned long i, unsigned long j) const { return less(mValues[i], mValues[j]); }
+    
+    void swap(unsigned long i, unsigned long j)
+    {
+        std::swap(mValues[i], mValues[j]);
+        std::swap(mHeap[i], mHeap[j]);
+        mPositions[mHeap[i]] = i;
+        mPositions[mHeap[j]] = j;
+    }
+    
+    // Restore the heap properties after the value at a (heap local) position has changed
+    
+    template <bool Upper> void fix(unsigned long position)
+    {
+        const unsigned long offset = Upper ? mLowerSize : 0;
+        const unsigned long size = Upper ? mWidth - mLowerSize : mLowerSize;
+        
+        auto above = [&](unsigned long i, unsigned long j) { return Upper ? aboveUpper(i + offset, j + offset) : aboveLower(i + offset, j + offset); };
+        
+        // Sift up
+        
+        while (position && above(position, (position - 1) >> 1))
+        {
+            unsigned long parent = (position - 1) >> 1;
+            swap(position + offset, parent + offset);
+            position = parent;
+        }
+        
+        // Sift down
+        
+        for (unsigned long child = (position << 1) + 1; child < size; child = (position << 1) + 1)
+        {
+            child = (child + 1 < size && above(child + 1, child)) ? child + 1 : child;
+            
+            if (!above(child, position))
+                break;
+            
+            swap(position + offset, child + offset);
+            position = child;
+        }
+    }
+    
+    void fixLower(unsigned long position)   { fix<false>(position); }
+    void fixUpper(unsigned long position)   { fix<true>(position); }
+    
+    // Move the lowest value of the upper heap to the lower heap and vice versa
+    
+    void exchangeTops()
+    {
+        swap(0, mLowerSize);
+        fixLower(0);
+        fixUpper(0);
+    }
+    
+    // Data
+    
+    double *mValues;
+    unsigned long *mHeap;
+    unsigned long *mPositions;
+    
+    unsigned long mWidth;
+    unsigned long mLowerSize;
+};
+
+#endif
@@ -1,93 +1,407 @@
-
 #ifndef FRAMELIB_SORT_FUNCTIONS_H
 #define FRAMELIB_SORT_FUNCTIONS_H
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+// Sorting
+
+// N.B. - NaNs are ordered above all other values (last when ascending / first when descending) matching compareLess() in FrameLib_TimeMedian
+// N.B. - comparison sorts use introsort (std::sort) which is O(n log n) in the worst case and requires no additional memory
+// N.B. - floating point data at or above the radix threshold is sorted using an LSD radix sort on the IEEE bit pattern if temporary memory is supplied
+// N.B. - temporary memory must be of the size given by sortTempSize() / sortIndicesTempSize() as it also holds the radix histograms
+// N.B. - index sorts are stable (indices of equal values remain in ascending order)
 
-template <typename Compare, class T> void sortVector(T *data, unsigned long size)
+namespace FrameLib_Sorting
 {
-    bool swaps = true;
-    unsigned long gap = size;
-    unsigned long i;
+    // Size Threshold (at or above this size radix sorting is used when possible)
+    
+    static const unsigned long radixThreshold = 2048;
+    
+    template <class T> bool useRadix(const T *temp, unsigned long size)
+    {
+        return temp && size >= radixThreshold && size <= std::numeric_limits<uint32_t>::max();
+    }
+    
+    // NaN Detection (only floating point types can be NaN)
+    
+    template <class T> bool isNaN(const T&)     { return false; }
+    inline bool isNaN(double a)                 { return std::isnan(a); }
+    inline bool isNaN(float a)                  { return std::isnan(a); }
+    
+    // Radix Keys (these map values to unsigned integers with the same ordering and -0.0 equal to 0.0)
     
-    while (gap > 1 || swaps)
+    template <class T> struct RadixKey
     {
-        gap = (gap > 1) ? (gap * 10) / 13 : gap;
-        gap = (gap == 9 || gap == 10) ? 11 : gap;
-        gap = !gap ? 1 : gap;
+        static const bool supported = false;
+    };
+    
+    template <class T, class U> struct FloatRadixKey
+    {
+        static const bool supported = true;
+        static const U signBit = static_cast<U>(1) << (sizeof(U) * 8 - 1);
+        
+        typedef U Type;
         
-        for (i = 0, swaps = false; i + gap < size; i++)
+        static U get(T a)
         {
-            if (Compare()(data[i], data[i + gap]))
+            U bits;
+            
+            if (isNaN(a))
+                return ~static_cast<U>(0);
+            
+            // Zeros are canonicalised so that -0.0 and 0.0 compare as equal
+            
+            a = a == T(0) ? T(0) : a;
+            std::memcpy(&bits, &a, sizeof(U));
+            
+            return (bits & signBit) ? ~bits : bits | signBit;
+        }
+    };
+    
+    template <> struct RadixKey<double> : FloatRadixKey<double, uint64_t> {};
+    template <> struct RadixKey<float> : FloatRadixKey<float, uint32_t> {};
+    
+    // Radix Histograms (11 bit digits with all digits counted in a single pass)
+    
+    // N.B. - the counts (48KB for doubles) are held in the temporary memory after the first size elements, rather than on the stack
+    // N.B. - the counts limit the size to that representable by uint32_t
+    
+    template <class T> struct RadixHistogram
+    {
+        typedef typename RadixKey<T>::Type Key;
+        
+        static const int digitBits = 11;
+        static const int radixSize = 1 << digitBits;
+        static const int numDigits = (sizeof(Key) * 8 + digitBits - 1) / digitBits;
+        static const unsigned long numCounts = numDigits * radixSize;
+        
+        static unsigned long digit(Key key, int pass) { return static_cast<unsigned long>((key >> (pass * digitBits)) & (radixSize - 1)); }
+        static Key key(T a, bool descending) { return descending ? ~RadixKey<T>::get(a) : RadixKey<T>::get(a); }
+        
+        // Temporary memory size in elements of type U (the sorting space followed by the counts)
+        
+        template <class U> static unsigned long tempSize(unsigned long size)
+        {
+            return size + (numCounts * sizeof(uint32_t) + sizeof(U) - 1) / sizeof(U);
+        }
+        
+        template <class U> static uint32_t *tempCounts(U *temp, unsigned long size)
+        {
+            return reinterpret_cast<uint32_t *>(temp + size);
+        }
+        
+        RadixHistogram(const T *data, unsigned long size, bool descending, uint32_t *counts) : mCounts(counts), mNumPasses(0)
+        {
+            std::fill_n(mCounts, numCounts, 0U);
+            
+            for (unsigned long i = 0; i < size; i++)
+            {
+                Key k = key(data[i], descending);
+                
+                for (int j = 0; j < numDigits; j++)
+                    getCounts(j)[digit(k, j)]++;
+            }
+            
+            // Passes are only needed for digits that differ between values (these are converted to offsets)
+            
+            Key first = size ? key(data[0], descending) : 0;
+            
+            for (int j = 0; j < numDigits; j++)
             {
-                std::swap(data[i], data[i + gap]);
-                swaps = true;
+                uint32_t *counts = getCounts(j);
+                
+                if (counts[digit(first, j)] == size)
+                    continue;
+                
+                uint32_t offset = 0;
+                
+                for (int k = 0; k < radixSize; k++)
+                {
+                    uint32_t count = counts[k];
+                    counts[k] = offset;
+                    offset += count;
+                }
+                
+                mPasses[mNumPasses++] = j;
             }
         }
-    }
-}
-
-template <typename Compare, class T> void sortIndices(unsigned long *indices, T *data, unsigned long size)
-{
-    bool swaps = true;
-    unsigned long gap = size;
-    unsigned long i;
+        
+        uint32_t *getCounts(int pass) const { return mCounts + pass * radixSize; }
+        
+        uint32_t *mCounts;
+        int mPasses[numDigits];
+        int mNumPasses;
+    };
     
-    for (i = 0; i < size; i++)
-        indices[i] = i;
+    // LSD Radix Sort (stable and out-of-place with input and output allowed to be the same memory)
     
-    while (gap > 1 || swaps)
+    template <class T> void radixSort(T *output, const T *input, T *temp, unsigned long size, bool descending)
     {
-        gap = (gap > 1) ? (gap * 10) / 13 : gap;
-        gap = (gap == 9 || gap == 10) ? 11 : gap;
-        gap = !gap ? 1 : gap;
+        typedef RadixHistogram<T> Histogram;
+        
+        Histogram histogram(input, size, descending, Histogram::tempCounts(temp, size));
         
-        for (i = 0, swaps = false; i + gap < size; i++)
+        // Choose the first destination so that the final pass writes to the output
+        
+        const T *src = input;
+        T *dst = (histogram.mNumPasses & 1) ? output : temp;
+        
+        if (!histogram.mNumPasses)
+        {
+            std::copy(input, input + size, output);
+            return;
+        }
+        
+        if (src == dst)
         {
-            unsigned long index1 = indices[i];
-            unsigned long index2 = indices[i + gap];
+            std::copy(input, input + size, temp);
+            src = temp;
+        }
+        
+        for (int i = 0; i < histogram.mNumPasses; i++)
+        {
+            int pass = histogram.mPasses[i];
+            uint32_t *offsets = histogram.getCounts(pass);
+            
+            for (unsigned long j = 0; j < size; j++)
+                dst[offsets[Histogram::digit(Histogram::key(src[j], descending), pass)]++] = src[j];
             
-            if (Compare()(data[index1], data[index2]))
+            src = dst;
+            dst = (dst == output) ? temp : output;
+        }
+    }
+    
+    template <class T> void radixSortIndices(unsigned long *indices, const T *data, unsigned long *temp, unsigned long size, bool descending)
+    {
+        typedef RadixHistogram<T> Histogram;
+        
+        Histogram histogram(data, size, descending, Histogram::tempCounts(temp, size));
+        
+        // The first pass reads the identity ordering so the first destination is chosen so the final pass writes to the indices
+        
+        unsigned long *dst = (histogram.mNumPasses & 1) ? indices : temp;
+        unsigned long *src = nullptr;
+        
+        if (!histogram.mNumPasses)
+        {
+            for (unsigned long i = 0; i < size; i++)
+                indices[i] = i;
+            return;
+        }
+        
+        for (int i = 0; i < histogram.mNumPasses; i++)
+        {
+            int pass = histogram.mPasses[i];
+            uint32_t *offsets = histogram.getCounts(pass);
+            
+            if (src)
             {
-                indices[i] = index2;
-                indices[i + gap] = index1;
-                swaps = true;
+                for (unsigned long j = 0; j < size; j++)
+                    dst[offsets[Histogram::digit(Histogram::key(data[src[j]], descending), pass)]++] = src[j];
             }
+            else
+            {
+                for (unsigned long j = 0; j < size; j++)
+                    dst[offsets[Histogram::digit(Histogram::key(data[j], descending), pass)]++] = j;
+            }
+            
+            src = dst;
+            dst = (dst == indices) ? temp : indices;
         }
     }
+    
+    // Introsort (NaNs are partitioned to the appropriate end first so the sort itself can use simple comparisons)
+    
+    template <class T> void introSort(T *data, unsigned long size, bool descending)
+    {
+        if (descending)
+        {
+            T *values = std::partition(data, data + size, [](const T& a) { return isNaN(a); });
+            std::sort(values, data + size, [](const T& a, const T& b) { return b < a; });
+        }
+        else
+        {
+            T *nans = std::partition(data, data + size, [](const T& a) { return !isNaN(a); });
+            std::sort(data, nans, [](const T& a, const T& b) { return a < b; });
+        }
+    }
+    
+    template <class T> void introSortIndices(unsigned long *indices, const T *data, unsigned long size, bool descending)
+    {
+        unsigned long numValues = 0;
+        unsigned long numNaNs = 0;
+        
+        for (unsigned long i = 0; i < size; i++)
+            numNaNs += isNaN(data[i]) ? 1 : 0;
+        
+        // Place the indices of NaNs at the appropriate end in order
+        
+        unsigned long *values = descending ? indices + numNaNs : indices;
+        unsigned long *nans = descending ? indices : indices + (size - numNaNs);
+        
+        for (unsigned long i = 0; i < size; i++)
+        {
+            if (isNaN(data[i]))
+                *nans++ = i;
+            else
+                values[numValues++] = i;
+        }
+        
+        // Stability is ensured by comparing indices for equal values
+        
+        if (descending)
+            std::sort(values, values + numValues, [data](unsigned long a, unsigned long b) { return data[b] < data[a] || (!(data[a] < data[b]) && a < b); });
+        else
+            std::sort(values, values + numValues, [data](unsigned long a, unsigned long b) { return data[a] < data[b] || (!(data[b] < data[a]) && a < b); });
+    }
+    
+    // Dispatch by size and type
+    
+    template <class T> void sort(T *output, const T *input, T *temp, unsigned long size, bool descending, std::true_type)
+    {
+        if (useRadix(temp, size))
+            radixSort(output, input, temp, size, descending);
+        else
+        {
+            std::copy(input, input + size, output);
+            introSort(output, size, descending);
+        }
+    }
+    
+    template <class T> void sort(T *output, const T *input, T *, unsigned long size, bool descending, std::false_type)
+    {
+        std::copy(input, input + size, output);
+        introSort(output, size, descending);
+    }
+    
+    template <class T> void sortIndices(unsigned long *indices, const T *data, unsigned long *temp, unsigned long size, bool descending, std::true_type)
+    {
+        if (useRadix(temp, size))
+            radixSortIndices(indices, data, temp, size, descending);
+        else
+            introSortIndices(indices, data, size, descending);
+    }
+    
+    template <class T> void sortIndices(unsigned long *indices, const T *data, unsigned long *, unsigned long size, bool descending, std::false_type)
+    {
+        introSortIndices(indices, data, size, descending);
+    }
+    
+    template <class T> using RadixSupport = std::integral_constant<bool, RadixKey<T>::supported>;
+    
+    // Temporary memory sizes in elements of type U (space for the histograms is only needed where radix sorting is possible)
+    
+    template <class T, class U> unsigned long radixTempSize(unsigned long size)
+    {
+        return RadixHistogram<T>::template tempSize<U>(size);
+    }
+    
+    template <class T, class U> unsigned long tempSize(unsigned long size, std::true_type)
+    {
+        return size >= radixThreshold ? radixTempSize<T, U>(size) : size;
+    }
+    
+    template <class T, class U> unsigned long tempSize(unsigned long size, std::false_type)
+    {
+        return size;
+    }
+    
+    // Multiple Selection (introselect at the middle position in the range then recursion either side)
+    
+    // N.B. - positions are ascending and lie within [lo, hi)
+    
+    template <class T> void multiSelect(T *data, unsigned long lo, unsigned long hi, const unsigned long *positions, unsigned long numPositions)
+    {
+        if (!numPositions || hi - lo < 2)
+            return;
+        
+        unsigned long position = positions[numPositions >> 1];
+        
+        std::nth_element(data + lo, data + position, data + hi, [](const T& a, const T& b) { return a < b; });
+        
+        // Any repeats of the selected position are complete
+        
+        const unsigned long *below = std::lower_bound(positions, positions + numPositions, position);
+        const unsigned long *above = std::upper_bound(below, positions + numPositions, position);
+        
+        multiSelect(data, lo, position, positions, static_cast<unsigned long>(below - positions));
+        multiSelect(data, position + 1, hi, above, static_cast<unsigned long>((positions + numPositions) - above));
+    }
 }
 
+// In-place sorts (no additional memory)
+
 template <class T> void sortAscending(T *data, unsigned long size)
 {
-    sortVector<std::greater<T>>(data, size);
+    FrameLib_Sorting::introSort(data, size, false);
 }
 
 template <class T> void sortDescending(T *data, unsigned long size)
 {
-    sortVector<std::less<T>>(data, size);
+    FrameLib_Sorting::introSort(data, size, true);
+}
+
+// Temporary memory sizes (in elements) for the out-of-place and index sorts
+
+template <class T> unsigned long sortTempSize(unsigned long size)
+{
+    return FrameLib_Sorting::tempSize<T, T>(size, FrameLib_Sorting::RadixSupport<T>());
+}
+
+template <class T> unsigned long sortIndicesTempSize(unsigned long size)
+{
+    return FrameLib_Sorting::tempSize<T, unsigned long>(size, FrameLib_Sorting::RadixSupport<T>());
+}
+
+// Out-of-place sorts (temporary memory of sortTempSize() elements allows radix sorting of large inputs)
+
+template <class T> void sortAscending(T *output, const T *input, unsigned long size, T *temp = nullptr)
+{
+    FrameLib_Sorting::sort(output, input, temp, size, false, FrameLib_Sorting::RadixSupport<T>());
 }
 
-template <class T> void sortAscending(T *output, const T *input, unsigned long size)
+template <class T> void sortDescending(T *output, const T *input, unsigned long size, T *temp = nullptr)
 {
-    std::copy(input, input + size, output);
-    sortAscending(output, size);
+    FrameLib_Sorting::sort(output, input, temp, size, true, FrameLib_Sorting::RadixSupport<T>());
 }
 
-template <class T> void sortDescending(T *output, const T *input, unsigned long size)
+// Stable index sorts (temporary memory of sortIndicesTempSize() elements allows radix sorting of large inputs)
+
+template <class T> void sortIndicesAscending(unsigned long *indices, const T *data, unsigned long size, unsigned long *temp = nullptr)
 {
-    std::copy(input, input + size, output);
-    sortDescending(output, size);
+    FrameLib_Sorting::sortIndices(indices, data, temp, size, false, FrameLib_Sorting::RadixSupport<T>());
 }
 
-template <class T> void sortIndicesAscending(unsigned long *indices, const T *data, unsigned long size)
+template <class T> void sortIndicesDescending(unsigned long *indices, const T *data, unsigned long size, unsigned long *temp = nullptr)
 {
-    sortIndices<std::greater<T>>(indices, data, size);
+    FrameLib_Sorting::sortIndices(indices, data, temp, size, true, FrameLib_Sorting::RadixSupport<T>());
 }
 
-template <class T> void sortIndicesDescending(unsigned long *indices, const T *data, unsigned long size)
+// Selection (partially orders data so that the values at the given positions are those of an ascending sort in O(n log m) for m positions)
+
+// N.B. - positions must be in ascending order / NaNs are moved to the end as when sorting
+// N.B. - values between two selected positions lie within the range of the values at those positions
+
+template <class T> void selectAscending(T *data, unsigned long size, const unsigned long *positions, unsigned long numPositions)
 {
-    sortIndices<std::less<T>>(indices, data, size);
+    T *nans = std::partition(data, data + size, [](const T& a) { return !FrameLib_Sorting::isNaN(a); });
+    unsigned long numValues = static_cast<unsigned long>(nans - data);
+    
+    // Positions at or beyond the first NaN are already complete
+    
+    numPositions = static_cast<unsigned long>(std::lower_bound(positions, positions + numPositions, numValues) - positions);
+    
+    FrameLib_Sorting::multiSelect(data, 0, numValues, positions, numPositions);
 }
 
+template <class T> void selectAscending(T *data, unsigned long size, unsigned long position)
+{
+    selectAscending(data, size, &position, 1);
+}
 
 #endif
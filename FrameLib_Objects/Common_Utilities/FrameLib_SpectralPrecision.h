@@ -0,0 +1,200 @@
+
+#ifndef FRAMELIB_SPECTRALPRECISION_H
+#define FRAMELIB_SPECTRALPRECISION_H
+
+#include "FrameLib_DSP.h"
+
+#include <algorithm>
+
+// Spectral objects may process in single precision (frames are converted at the boundaries to use the float FFT)
+
+enum FrameLib_Precision { kPrecisionDouble, kPrecisionSingle };
+
+// Add the (instantiation only) precision parameter to an object
+
+static inline void addPrecisionParameter(FrameLib_Parameters& parameters, unsigned long index)
+{
+    parameters.addEnum(index, "precision");
+    parameters.addEnumItem(kPrecisionDouble, "double");
+    parameters.addEnumItem(kPrecisionSingle, "single");
+    parameters.setInstantiation();
+}
+
+/**
+ 
+ @class FrameLib_SpectralPrecision
+ 
+ @brief a pair of processors (double and single precision) of which only the one in use acquires a shared FFT setup.
+ 
+ */
+
+template <template <class> class Processor>
+class FrameLib_SpectralPrecision
+{
+
+public:
+    
+    // Constructor
+    
+    FrameLib_SpectralPrecision(FrameLib_Context context, FrameLib_DSP *owner)
+    : mDoubleSetup(context), mSingleSetup(context), mDouble(FrameLib_DSP::Allocator(*owner), 0), mSingle(FrameLib_DSP::Allocator(*owner), 0), mPrecision(kPrecisionDouble)
+    {}
+    
+    // Set the precision and acquire an FFT setup for sizes up to 2^maxLog2
+    
+    void setPrecision(FrameLib_Precision precision, uintptr_t maxLog2)
+    {
+        mPrecision = precision;
+        
+        if (mPrecision == kPrecisionSingle)
+        {
+            mSingleSetup.acquire(maxLog2);
+            mSingle.set_fft_setup(mSingleSetup.get(), mSingleSetup.getMaxLog2());
+        }
+        else
+        {
+            mDoubleSetup.acquire(maxLog2);
+            mDouble.set_fft_setup(mDoubleSetup.get(), mDoubleSetup.getMaxLog2());
+        }
+    }
+    
+    FrameLib_Precision getPrecision() const     { return mPrecision; }
+    
+    // Processors
+    
+    Processor<double>& getDouble()              { return mDouble; }
+    Processor<float>& getSingle()               { return mSingle; }
+
+private:
+    
+    // Data
+    
+    FrameLib_Context::FFTSetup<FFT_SETUP_D> mDoubleSetup;
+    FrameLib_Context::FFTSetup<FFT_SETUP_F> mSingleSetup;
+    
+    Processor<double> mDouble;
+    Processor<float> mSingle;
+    
+    FrameLib_Precision mPrecision;
+};
+
+/**
+ 
+ @class FrameLib_PrecisionInput
+ 
+ @brief an input frame in the processing precision (double precision frames are used directly and single precision frames are converted copies).
+ 
+ */
+
+template <class T>
+class FrameLib_PrecisionInput
+{
+
+public:
+    
+    FrameLib_PrecisionInput(FrameLib_DSP *owner, const double *input, unsigned long size)
+    : mAllocator(*owner), mSize(size), mFrame(mAllocator.template allocate<T>(size))
+    {
+        if (mFrame)
+            std::copy(input, input + size, mFrame);
+    }
+    
+    ~FrameLib_PrecisionInput()  { mAllocator.deallocate(mFrame); }
+    
+    FrameLib_PrecisionInput(const FrameLib_PrecisionInput&) = delete;
+    FrameLib_PrecisionInput& operator=(const FrameLib_PrecisionInput&) = delete;
+    
+    const T *get() const        { return mFrame; }
+    operator bool() const       { return mFrame || !mSize; }
+
+private:
+    
+    FrameLib_DSP::Allocator mAllocator;
+    unsigned long mSize;
+    T *mFrame;
+};
+
+template <>
+class FrameLib_PrecisionInput<double>
+{
+
+public:
+    
+    FrameLib_PrecisionInput(FrameLib_DSP *owner, const double *input, unsigned long size) : mFrame(input) {}
+    
+    const double *get() const   { return mFrame; }
+    operator bool() const       { return true; }
+
+private:
+    
+    const double *mFrame;
+};
+
+/**
+ 
+ @class FrameLib_PrecisionOutput
+ 
+ @brief an output frame in the processing precision (single precision results are converted to the output on destruction).
+ 
+ */
+
+template <class T>
+class FrameLib_PrecisionOutput
+{
+
+public:
+    
+    FrameLib_PrecisionOutput(FrameLib_DSP *owner, double *output, unsigned long size)
+    : mAllocator(*owner), mOutput(output), mSize(size), mFrame(mAllocator.template allocate<T>(size))
+    {}
+    
+    ~FrameLib_PrecisionOutput()
+    {
+        if (mFrame)
+            std::copy(mFrame, mFrame + mSize, mOutput);
+        
+        mAllocator.deallocate(mFrame);
+    }
+    
+    FrameLib_PrecisionOutput(const FrameLib_PrecisionOutput&) = delete;
+    FrameLib_PrecisionOutput& operator=(const FrameLib_PrecisionOutput&) = delete;
+    
+    T *get() const              { return mFrame; }
+    operator bool() const       { return mFrame || !mSize; }
+    
+    // Zero the output (discarding any results)
+    
+    void zero()
+    {
+        std::fill_n(mOutput, mSize, 0.0);
+        mAllocator.deallocate(mFrame);
+    }
+
+private:
+    
+    FrameLib_DSP::Allocator mAllocator;
+    double *mOutput;
+    unsigned long mSize;
+    T *mFrame;
+};
+
+template <>
+class FrameLib_PrecisionOutput<double>
+{
+
+public:
+    
+    FrameLib_PrecisionOutput(FrameLib_DSP *owner, double *output, unsigned long size) : mFrame(output), mSize(size) {}
+    
+    double *get() const         { return mFrame; }
+    operator bool() const       { return true; }
+    
+    void zero()                 { std::fill_n(mFrame, mSize, 0.0); }
+
+private:
+    
+    double *mFrame;
+    unsigned long mSize;
+};
+
+#endif
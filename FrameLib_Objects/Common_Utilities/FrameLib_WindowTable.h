@@ -0,0 +1,192 @@
+
+#ifndef FRAMELIB_WINDOWTABLE_H
+#define FRAMELIB_WINDOWTABLE_H
+
+#include "FrameLib_DSP.h"
+#include "FrameLib_SIMD_Ops.h"
+
+/**
+ 
+ @class FrameLib_WindowTable
+ 
+ @brief a periodic window (taken from the tables shared via the context) with an overall gain that is only recalculated when its settings change.
+ 
+ */
+
+class FrameLib_WindowTable
+{
+
+public:
+    
+    enum WindowTypes { kHann, kHamming, kTriangle, kCosine, kBlackman, kBlackman62, kBlackman70, kBlackman74, kBlackman92, kBlackmanHarris, kFlatTop, kRectangle };
+    enum Compensation { kOff, kLinear, kPower, kPowerOverLinear };
+    
+    // Add the window type, sqrt and compensation parameters (at three consecutive indices)
+    
+    static void addParameters(FrameLib_Parameters& parameters, unsigned long index)
+    {
+        parameters.addEnum(index, "window");
+        parameters.addEnumItem(kHann, "hann");
+        parameters.addEnumItem(kHamming, "hamming");
+        parameters.addEnumItem(kTriangle, "triangle");
+        parameters.addEnumItem(kCosine, "cosine");
+        parameters.addEnumItem(kBlackman, "blackman");
+        parameters.addEnumItem(kBlackman62, "blackman62");
+        parameters.addEnumItem(kBlackman70, "blackman70");
+        parameters.addEnumItem(kBlackman74, "blackman74");
+        parameters.addEnumItem(kBlackman92, "blackman92");
+        parameters.addEnumItem(kBlackmanHarris, "blackmanharris");
+        parameters.addEnumItem(kFlatTop, "flattop");
+        parameters.addEnumItem(kRectangle, "rectangle");
+        
+        parameters.addBool(index + 1, "sqrt", false);
+        
+        parameters.addEnum(index + 2, "compensate");
+        parameters.addEnumItem(kOff, "off");
+        parameters.addEnumItem(kLinear, "linear");
+        parameters.addEnumItem(kPower, "power");
+        parameters.addEnumItem(kPowerOverLinear, "powoverlin");
+    }
+    
+    static void addParameterInfo(FrameLib_Parameters::Info& info)
+    {
+        info.add("Sets the window type.");
+        info.add("Sets whether the window should be used directly, or the square root of the window.");
+        info.add("Sets the gain compensation used. "
+                 "off - no compensation is used. linear - compensate the linear gain of the window. "
+                 "power - compensate the power gain of the window. powoverlin - compensate by the power gain divided by the linear gain");
+    }
+    
+    // Constructor
+    
+    FrameLib_WindowTable(FrameLib_Context context)
+    : mTable(context), mWindow(nullptr), mSize(0), mCompensation(kOff), mGain(0.0), mScale(0.0)
+    {}
+    
+    // Update from the parameters (at the index given to addParameters) with an additional gain (returns false on allocation failure)
+    
+    bool update(const FrameLib_Parameters& parameters, unsigned long index, unsigned long size, double gain)
+    {
+        using CacheTypes = FrameLib_Context::WindowTable::WindowTypes;
+        
+        WindowTypes windowType = static_cast<WindowTypes>(parameters.getInt(index));
+        bool sqrtWindow = parameters.getBool(index + 1);
+        Compensation compensation = static_cast<Compensation>(parameters.getInt(index + 2));
+        
+        // N.B. the window is periodic (its end point is omitted) so that overlapping windows sum to a constant
+        
+        const FrameLib_WindowCache::Table *table = mTable.get();
+        
+        if (!mTable.acquire(static_cast<CacheTypes>(windowType), static_cast<uint32_t>(size), static_cast<uint32_t>(size), sqrtWindow))
+        {
+            mWindow = nullptr;
+            mSize = 0;
+            return false;
+        }
+        
+        if (table != mTable.get() || compensation != mCompensation || gain != mGain)
+            calculateScale(compensation, gain);
+        
+        return true;
+    }
+    
+    const double *get() const   { return mWindow; }
+    unsigned long size() const  { return mSize; }
+    double scale() const        { return mScale; }
+    
+    // Multiply an input against the window starting from the given offset into the window
+    
+    template <class T>
+    void apply(T *output, const double *input, unsigned long offset, unsigned long size) const
+    {
+        const double *window = mWindow + offset;
+        
+        for (unsigned long i = 0; i < size; i++)
+            output[i] = static_cast<T>(input[i] * (window[i] * mScale));
+    }
+    
+    void apply(double *output, const double *input, unsigned long offset, unsigned long size) const
+    {
+        using VecType = FrameLib_SIMD_Ops::VecType;
+        
+        const int vecSize = FrameLib_SIMD_Ops::vecSize;
+        const double *window = mWindow + offset;
+        const VecType scale(mScale);
+        unsigned long i = 0;
+        
+        for (; i + vecSize <= size; i += vecSize)
+            (VecType(input + i) * (VecType(window + i) * scale)).store(output + i);
+        
+        for (; i < size; i++)
+            output[i] = input[i] * (window[i] * mScale);
+    }
+    
+    // Multiply an input against the window starting from the given offset into the window and accumulate into the output
+    
+    template <class T>
+    void applyAdd(double *output, const T *input, unsigned long offset, unsigned long size) const
+    {
+        const double *window = mWindow + offset;
+        
+        for (unsigned long i = 0; i < size; i++)
+            output[i] += input[i] * (window[i] * mScale);
+    }
+    
+    void applyAdd(double *output, const double *input, unsigned long offset, unsigned long size) const
+    {
+        using VecType = FrameLib_SIMD_Ops::VecType;
+        using ScalarType = FrameLib_SIMD_Ops::ScalarType;
+        
+        const int vecSize = FrameLib_SIMD_Ops::vecSize;
+        const double *window = mWindow + offset;
+        const VecType scale(mScale);
+        unsigned long i = 0;
+        
+        for (; i + vecSize <= size; i += vecSize)
+            (VecType(output + i) + VecType(input + i) * (VecType(window + i) * scale)).store(output + i);
+        
+        for (; i < size; i++)
+            (ScalarType(output[i]) + ScalarType(input[i]) * (ScalarType(window[i]) * ScalarType(mScale))).store(output + i);
+    }
+
+private:
+    
+    // Calculate the overall scaling from the gain of the window and the additional gain
+    
+    void calculateScale(Compensation compensation, double gain)
+    {
+        const FrameLib_WindowCache::Table *table = mTable.get();
+        
+        mWindow = table->mWindow;
+        mSize = table->mSize;
+        
+        double linearGain = static_cast<double>(mSize) / table->linearSum(true, false);
+        double powerGain = static_cast<double>(mSize) / table->powerSum(true, false);
+        
+        mScale = gain;
+        
+        switch (compensation)
+        {
+            case kOff:                  break;
+            case kLinear:               mScale *= linearGain;               break;
+            case kPower:                mScale *= powerGain;                break;
+            case kPowerOverLinear:      mScale *= powerGain / linearGain;   break;
+        }
+        
+        mCompensation = compensation;
+        mGain = gain;
+    }
+    
+    // Data
+    
+    FrameLib_Context::WindowTable mTable;
+    
+    const double *mWindow;
+    unsigned long mSize;
+    
+    Compensation mCompensation;
+    double mGain;
+    double mScale;
+};
+
+#endif
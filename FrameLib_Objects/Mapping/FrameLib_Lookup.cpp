@@ -102,6 +102,11 @@ void FrameLib_Lookup::process()
         case kBSpline:      interpType = kInterpCubicBSpline;       break;
     }
     
+    // Use linear interpolation when the context is over its processing budget
+    
+    if (isDegraded() && interpType != kInterpNone)
+        interpType = kInterpLinear;
+    
     if (scaling != kSamples)
     {
         temp = alloc<double>(sizeIn1);
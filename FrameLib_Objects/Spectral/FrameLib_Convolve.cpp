@@ -1,7 +1,7 @@
 
 #include "FrameLib_Convolve.h"
 
-FrameLib_Convolve::FrameLib_Convolve(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 2, 1), mProcessor(*this)
+FrameLib_Convolve::FrameLib_Convolve(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 2, 1), mProcessor(context, this)
 {
     mParameters.addInt(kMaxLength, "maxlength", 16384, 0);
     mParameters.setMin(0);
@@ -16,12 +16,19 @@ FrameLib_Convolve::FrameLib_Convolve(FrameLib_Context context, FrameLib_Paramete
     mParameters.addEnumItem(EdgeMode::kEdgeWrapCentre, "wrap");
     mParameters.addEnumItem(EdgeMode::kEdgeFold, "fold");
     mParameters.setInstantiation();
+    addPrecisionParameter(mParameters, kPrecision);
+    mParameters.addEnum(kPartitions, "partitions");
+    mParameters.addEnumItem(kPartitionNone, "none");
+    mParameters.addEnumItem(kPartitionUniform, "uniform");
+    mParameters.addEnumItem(kPartitionNonUniform, "nonuniform");
+    mParameters.setInstantiation();
 
     mParameters.set(serialisedParameters);
         
-    mProcessor.set_max_fft_size(mParameters.getInt(kMaxLength));
+    mProcessor.setPrecision(static_cast<FrameLib_Precision>(mParameters.getInt(kPrecision)), Processor<double>::calc_fft_size_log2(mParameters.getInt(kMaxLength)));
     
     mMode = static_cast<Mode>(mParameters.getInt(kMode));
+    mPartitions = static_cast<Partitions>(mParameters.getInt(kPartitions));
     
     if (mMode  == kComplex)
         setIO(4, 2);
@@ -71,6 +78,11 @@ FrameLib_Convolve::ParameterInfo::ParameterInfo()
 {
     add("Sets the maximum output length. The output length will be M + N - 1 where M and N are the sizes of the two inputs respectively");
     add("Sets the type of input expected / output produced.");
+    add("Sets the edge behaviour (how the inputs are treated beyond their ends).");
+    add("Sets the precision used internally. Single precision is faster but less accurate (frames are converted at the input and output).");
+    add("Sets the partitioning of the second input (the kernel) for real inputs with linear edges. "
+        "When partitioned the spectra of the kernel are only recalculated when it changes, so long static kernels are efficient. "
+        "Uniform partitions are sized to the first input, whereas non-uniform partitions double in size along the kernel (up to 1024 samples) to use fewer partitions for short inputs.");
 }
 
 // Process
@@ -79,6 +91,18 @@ void FrameLib_Convolve::process()
 {
     EdgeMode edgeMode = static_cast<EdgeMode>(mParameters.getInt(kEdgeMode));
     
+    if (mProcessor.getPrecision() == kPrecisionSingle)
+        convolve(mProcessor.getSingle(), edgeMode, mPartitions);
+    else
+        convolve(mProcessor.getDouble(), edgeMode, mPartitions);
+}
+
+template <class T>
+void FrameLib_Convolve::convolve(Processor<T>& processor, EdgeMode edgeMode, Partitions partitions)
+{
+    auto mode = static_cast<typename Processor<T>::EdgeMode>(edgeMode);
+    auto partitionMode = partitions == kPartitionUniform ? Processor<T>::kPartitionUniform : Processor<T>::kPartitionNonUniform;
+    
     if (mMode == kReal)
     {
         // Get Inputs
@@ -89,14 +113,25 @@ void FrameLib_Convolve::process()
         
         // Get Output Size
         
-        unsigned long sizeOut = mProcessor.convolved_size(sizeIn1, sizeIn2, edgeMode);
+        unsigned long sizeOut = processor.convolved_size(sizeIn1, sizeIn2, mode);
         
         // Get output
         
         requestOutputSize(0, sizeOut);
         
         if (allocateOutputs())
-            mProcessor.convolve(getOutput(0, &sizeOut), {input1, sizeIn1}, {input2, sizeIn2}, edgeMode);
+        {
+            FrameLib_PrecisionInput<T> in1(this, input1, sizeIn1);
+            FrameLib_PrecisionInput<T> in2(this, input2, sizeIn2);
+            FrameLib_PrecisionOutput<T> output(this, getOutput(0, &sizeOut), sizeOut);
+            
+            if (!in1 || !in2 || !output)
+                output.zero();
+            else if (partitions == kPartitionNone || edgeMode != EdgeMode::kEdgeLinear)
+                processor.convolve(output.get(), {in1.get(), sizeIn1}, {in2.get(), sizeIn2}, mode);
+            else if (!processor.convolve_partitioned(output.get(), {in1.get(), sizeIn1}, {in2.get(), sizeIn2}, partitionMode))
+                output.zero();
+        }
     }
     else
     {
@@ -111,7 +146,7 @@ void FrameLib_Convolve::process()
         
         // Get Output Size
 
-        unsigned long sizeOut = mProcessor.convolved_size(std::max(sizeR1, sizeI1), std::max(sizeR2, sizeI2), edgeMode);
+        unsigned long sizeOut = processor.convolved_size(std::max(sizeR1, sizeI1), std::max(sizeR2, sizeI2), mode);
         
         // Get output
         
@@ -120,10 +155,20 @@ void FrameLib_Convolve::process()
         
         if (allocateOutputs())
         {
-            double *rOut = getOutput(0, &sizeOut);
-            double *iOut = getOutput(1, &sizeOut);
-        
-            mProcessor.convolve(rOut, iOut, {inR1, sizeR1}, {inI1, sizeI1}, {inR2, sizeR2}, {inI2, sizeI2}, edgeMode);
+            FrameLib_PrecisionInput<T> r1(this, inR1, sizeR1);
+            FrameLib_PrecisionInput<T> i1(this, inI1, sizeI1);
+            FrameLib_PrecisionInput<T> r2(this, inR2, sizeR2);
+            FrameLib_PrecisionInput<T> i2(this, inI2, sizeI2);
+            FrameLib_PrecisionOutput<T> rOut(this, getOutput(0, &sizeOut), sizeOut);
+            FrameLib_PrecisionOutput<T> iOut(this, getOutput(1, &sizeOut), sizeOut);
+            
+            if (r1 && i1 && r2 && i2 && rOut && iOut)
+                processor.convolve(rOut.get(), iOut.get(), {r1.get(), sizeR1}, {i1.get(), sizeI1}, {r2.get(), sizeR2}, {i2.get(), sizeI2}, mode);
+            else
+            {
+                rOut.zero();
+                iOut.zero();
+            }
         }
     }
 }
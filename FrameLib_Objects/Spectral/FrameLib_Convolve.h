@@ -3,16 +3,21 @@
 #define FRAMELIB_CONVOLVE_H
 
 #include "FrameLib_DSP.h"
-#include "../../FrameLib_Dependencies/SpectralProcessor.hpp"
+#include "FrameLib_SpectralPrecision.h"
+#include "../../FrameLib_Dependencies/PartitionedConvolver.hpp"
 
 class FrameLib_Convolve final : public FrameLib_Processor
 {
-    using EdgeMode = spectral_processor<double, FrameLib_DSP::Allocator>::EdgeMode;
+    template <class T>
+    using Processor = partitioned_convolver<T, FrameLib_DSP::Allocator>;
+    
+    using EdgeMode = Processor<double>::EdgeMode;
     
     // Parameter Enums and Info
 
-    enum ParameterList { kMaxLength, kMode, kEdgeMode };
+    enum ParameterList { kMaxLength, kMode, kEdgeMode, kPrecision, kPartitions };
     enum Mode { kReal, kComplex };
+    enum Partitions { kPartitionNone, kPartitionUniform, kPartitionNonUniform };
     
     struct ParameterInfo : public FrameLib_Parameters::Info { ParameterInfo(); };
 
@@ -33,18 +38,22 @@ private:
     // Process
     
     void process() override;
+    
+    template <class T>
+    void convolve(Processor<T>& processor, EdgeMode edgeMode, Partitions partitions);
 
 private:
     
     // Data
     
     Mode mMode;
+    Partitions mPartitions;
 
     static ParameterInfo sParamInfo;
     
-    // Processor
+    // Processors (using FFT setups shared with other objects)
     
-    spectral_processor<double, FrameLib_DSP::Allocator> mProcessor;
+    FrameLib_SpectralPrecision<Processor> mProcessor;
 };
 
 #endif
@@ -1,7 +1,7 @@
 
 #include "FrameLib_Correlate.h"
 
-FrameLib_Correlate::FrameLib_Correlate(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 2, 1), mProcessor(*this)
+FrameLib_Correlate::FrameLib_Correlate(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 2, 1), mProcessor(context, this)
 {
     mParameters.addInt(kMaxLength, "maxlength", 16384, 0);
     mParameters.setMin(0);
@@ -16,10 +16,11 @@ FrameLib_Correlate::FrameLib_Correlate(FrameLib_Context context, FrameLib_Parame
     mParameters.addEnumItem(EdgeMode::kEdgeWrapCentre, "wrap");
     mParameters.addEnumItem(EdgeMode::kEdgeFold, "fold");
     mParameters.setInstantiation();
+    addPrecisionParameter(mParameters, kPrecision);
     
     mParameters.set(serialisedParameters);
         
-    mProcessor.set_max_fft_size(mParameters.getInt(kMaxLength));
+    mProcessor.setPrecision(static_cast<FrameLib_Precision>(mParameters.getInt(kPrecision)), Processor<double>::calc_fft_size_log2(mParameters.getInt(kMaxLength)));
     
     mMode = static_cast<Mode>(mParameters.getInt(kMode));
     
@@ -32,7 +33,8 @@ FrameLib_Correlate::FrameLib_Correlate(FrameLib_Context context, FrameLib_Parame
 std::string FrameLib_Correlate::objectInfo(bool verbose)
 {
     return formatInfo("Calculate the correlation of two input frames, (using frequency domain processing internally): "
-                   "The output is a frame of length M + N - 1 where M and N are the lengths of the two inputs respectively",
+                   "The output is a frame of length M + N - 1 where M and N are the lengths of the two inputs respectively. "
+                   "In real mode inputs that are unchanged since the previous frame (such as a fixed template) are not transformed again.",
                    "Calculate the correlation of two input frames, (using frequency domain processing internally).", verbose);
 }
 
@@ -71,6 +73,8 @@ FrameLib_Correlate::ParameterInfo::ParameterInfo()
 {
     add("Sets the maximum output length. The output length will be M + N - 1 where M and N are the sizes of the two inputs respectively");
     add("Sets the type of input expected / output produced.");
+    add("Sets the edge behaviour (how the inputs are treated beyond their ends).");
+    add("Sets the precision used internally. Single precision is faster but less accurate (frames are converted at the input and output).");
 }
 
 // Process
@@ -78,7 +82,18 @@ FrameLib_Correlate::ParameterInfo::ParameterInfo()
 void FrameLib_Correlate::process()
 {
     EdgeMode edgeMode = static_cast<EdgeMode>(mParameters.getInt(kEdgeMode));
+    
+    if (mProcessor.getPrecision() == kPrecisionSingle)
+        correlate(mProcessor.getSingle(), edgeMode);
+    else
+        correlate(mProcessor.getDouble(), edgeMode);
+}
 
+template <class T>
+void FrameLib_Correlate::correlate(Processor<T>& processor, EdgeMode edgeMode)
+{
+    auto mode = static_cast<typename Processor<T>::EdgeMode>(edgeMode);
+    
     if (mMode == kReal)
     {
         // Get Inputs
@@ -90,14 +105,23 @@ void FrameLib_Correlate::process()
         
         // Get Output Size
         
-        unsigned long sizeOut = mProcessor.correlated_size(sizeIn1, sizeIn2, edgeMode);
+        unsigned long sizeOut = processor.correlated_size(sizeIn1, sizeIn2, mode);
         
         // Get output
         
         requestOutputSize(0, sizeOut);
         
         if (allocateOutputs())
-            mProcessor.correlate(getOutput(0, &sizeOut), {input1, sizeIn1}, {input2, sizeIn2}, edgeMode);
+        {
+            FrameLib_PrecisionInput<T> in1(this, input1, sizeIn1);
+            FrameLib_PrecisionInput<T> in2(this, input2, sizeIn2);
+            FrameLib_PrecisionOutput<T> output(this, getOutput(0, &sizeOut), sizeOut);
+            
+            if (in1 && in2 && output)
+                processor.correlate_cached(output.get(), {in1.get(), sizeIn1}, {in2.get(), sizeIn2}, mode);
+            else
+                output.zero();
+        }
     }
     else
     {
@@ -112,7 +136,7 @@ void FrameLib_Correlate::process()
         
         // Get Output Size
 
-        unsigned long sizeOut = mProcessor.correlated_size(std::max(sizeR1, sizeI1), std::max(sizeR2, sizeI2), edgeMode);
+        unsigned long sizeOut = processor.correlated_size(std::max(sizeR1, sizeI1), std::max(sizeR2, sizeI2), mode);
 
         // Get output
         
@@ -121,10 +145,20 @@ void FrameLib_Correlate::process()
         
         if (allocateOutputs())
         {
-            double *rOut = getOutput(0, &sizeOut);
-            double *iOut = getOutput(1, &sizeOut);
-        
-            mProcessor.correlate(rOut, iOut, {inR1, sizeR1}, {inI1, sizeI1}, {inR2, sizeR2}, {inI2, sizeI2}, edgeMode);
+            FrameLib_PrecisionInput<T> r1(this, inR1, sizeR1);
+            FrameLib_PrecisionInput<T> i1(this, inI1, sizeI1);
+            FrameLib_PrecisionInput<T> r2(this, inR2, sizeR2);
+            FrameLib_PrecisionInput<T> i2(this, inI2, sizeI2);
+            FrameLib_PrecisionOutput<T> rOut(this, getOutput(0, &sizeOut), sizeOut);
+            FrameLib_PrecisionOutput<T> iOut(this, getOutput(1, &sizeOut), sizeOut);
+            
+            if (r1 && i1 && r2 && i2 && rOut && iOut)
+                processor.correlate(rOut.get(), iOut.get(), {r1.get(), sizeR1}, {i1.get(), sizeI1}, {r2.get(), sizeR2}, {i2.get(), sizeI2}, mode);
+            else
+            {
+                rOut.zero();
+                iOut.zero();
+            }
         }
     }
 }
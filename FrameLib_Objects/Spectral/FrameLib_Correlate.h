@@ -3,15 +3,19 @@
 #define FRAMELIB_CORRELATE_H
 
 #include "FrameLib_DSP.h"
+#include "FrameLib_SpectralPrecision.h"
 #include "../../FrameLib_Dependencies/SpectralProcessor.hpp"
 
 class FrameLib_Correlate final : public FrameLib_Processor
 {
-    using EdgeMode = spectral_processor<double, FrameLib_DSP::Allocator>::EdgeMode;
+    template <class T>
+    using Processor = spectral_processor<T, FrameLib_DSP::Allocator>;
+    
+    using EdgeMode = Processor<double>::EdgeMode;
 
     // Parameter Enums and Info
 
-    enum ParameterList { kMaxLength, kMode, kEdgeMode };
+    enum ParameterList { kMaxLength, kMode, kEdgeMode, kPrecision };
     enum Mode { kReal, kComplex };
     
     struct ParameterInfo : public FrameLib_Parameters::Info { ParameterInfo(); };
@@ -33,6 +37,9 @@ private:
     // Process
     
     void process() override;
+    
+    template <class T>
+    void correlate(Processor<T>& processor, EdgeMode edgeMode);
 
 private:
     
@@ -42,9 +49,9 @@ private:
 
     static ParameterInfo sParamInfo;
     
-    // Processor
+    // Processors (using FFT setups shared with other objects)
     
-    spectral_processor<double, FrameLib_DSP::Allocator> mProcessor;
+    FrameLib_SpectralPrecision<Processor> mProcessor;
 };
 
 #endif
@@ -3,7 +3,7 @@
 
 // Constructor / Destructor
 
-FrameLib_FFT::FrameLib_FFT(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 1, 2), mProcessor(*this)
+FrameLib_FFT::FrameLib_FFT(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 1, 2), mProcessor(context, this)
 {
     mParameters.addInt(kMaxLength, "maxlength", 16384, 0);
     mParameters.setMin(0);
@@ -15,15 +15,19 @@ FrameLib_FFT::FrameLib_FFT(FrameLib_Context context, FrameLib_Parameters::Serial
     mParameters.addEnumItem(kComplex, "complex");
     mParameters.addEnumItem(kFullSpectrum, "fullspectrum");
     mParameters.setInstantiation();
+    mParameters.addBool(kExact, "exact", false);
+    mParameters.setInstantiation();
+    addPrecisionParameter(mParameters, kPrecision);
     
     mParameters.set(serialisedParameters);
     
-    mProcessor.set_max_fft_size(mParameters.getInt(kMaxLength));
+    mProcessor.setPrecision(static_cast<FrameLib_Precision>(mParameters.getInt(kPrecision)), Processor<double>::calc_fft_size_log2(mParameters.getInt(kMaxLength)));
     
     // Store parameters
 
     mMode = static_cast<Mode>(mParameters.getInt(kMode));
     mNormalise = mParameters.getBool(kNormalise);
+    mExact = mParameters.getBool(kExact);
     
     // If in complex mode create 2 inlets/outlets
 
@@ -35,15 +39,16 @@ FrameLib_FFT::FrameLib_FFT(FrameLib_Context context, FrameLib_Parameters::Serial
 
 std::string FrameLib_FFT::objectInfo(bool verbose)
 {
-    return formatInfo("Calculate the real Fast Fourier Transform of an input frame: All FFTs performed will use a power of two size. "
+    return formatInfo("Calculate the real Fast Fourier Transform of an input frame: By default all FFTs performed will use a power of two size. "
                    "Output frames will be (N / 2) + 1 in length where N is the FFT size. Inputs which are not a power of two are zero-padded to the next power of two. "
+                   "If the exact parameter is on the FFT size is instead the input length. "
                    "Real and imaginary values are output as separate frames.",
                    "Calculate the real Fast Fourier Transform of an input frame.", verbose);
 }
 
 std::string FrameLib_FFT::inputInfo(unsigned long idx, bool verbose)
 {
-    return formatInfo("Time Domain Input - will be zero-padded if the length is not a power of two.", "Time Domain Input", verbose);
+    return formatInfo("Time Domain Input - will be zero-padded if the length is not a power of two (unless exact is on).", "Time Domain Input", verbose);
 }
 
 std::string FrameLib_FFT::outputInfo(unsigned long idx, bool verbose)
@@ -62,14 +67,29 @@ FrameLib_FFT::ParameterInfo::ParameterInfo()
 {
     add("Sets the maximum input length / FFT size.");
     add("When on the output is normalised so that sine waves produce the same level output regardless of the FFT size.");
-    add("Sets the type of input expected / output produced.");
+    add("Sets the type of input expected / output produced. "
+        "real - real input with the (N / 2) + 1 unique bins output (the spectrum of a real signal can be processed at this size). "
+        "complex - complex input with N bins output (inputs with no imaginary values are transformed as real inputs). "
+        "fullspectrum - real input with N bins output (only needed where the full spectrum is required).");
+    add("When on the FFT size is the input length (which need not be a power of two) rather than the next power of two. "
+        "Power of two sizes are more efficient, but other sizes avoid zero-padding (and thus give bins at different frequencies).");
+    add("Sets the precision used internally. Single precision is faster but less accurate (frames are converted at the input and output).");
 }
 
 // Process
 
 void FrameLib_FFT::process()
 {
-    FFT_SPLIT_COMPLEX_D spectrum;
+    if (mProcessor.getPrecision() == kPrecisionSingle)
+        transform(mProcessor.getSingle());
+    else
+        transform(mProcessor.getDouble());
+}
+
+template <class T>
+void FrameLib_FFT::transform(Processor<T>& processor)
+{
+    typename FFTTypes<T>::Split spectrum;
     
     // Get Input(s)
     
@@ -82,15 +102,15 @@ void FrameLib_FFT::process()
     if (mMode == kComplex)
         inputI = getInput(1, &sizeInI);
     
-    // Get FFT size log 2
+    // Get FFT size (and log 2)
     
-    unsigned long FFTSizeLog2 = mProcessor.calc_fft_size_log2(std::max(sizeInR, sizeInI));
-    unsigned long FFTSize = 1 << FFTSizeLog2;
+    unsigned long FFTSizeLog2 = processor.calc_fft_size_log2(std::max(sizeInR, sizeInI));
+    unsigned long FFTSize = mExact ? std::max(sizeInR, sizeInI) : 1 << FFTSizeLog2;
     sizeOut = mMode == kReal ? (FFTSize >> 1) + 1 : FFTSize;
     
     // Check size
     
-    if (FFTSize > mProcessor.max_fft_size() || (!sizeInR && !sizeInI))
+    if (FFTSize > processor.max_fft_size() || (!sizeInR && !sizeInI))
         sizeOut = 0;
     
     // Calculate output size
@@ -98,50 +118,73 @@ void FrameLib_FFT::process()
     requestOutputSize(0, sizeOut);
     requestOutputSize(1, sizeOut);
     allocateOutputs();
-    spectrum.realp = getOutput(0, &sizeOut);
-    spectrum.imagp = getOutput(1, &sizeOut);
+    
+    double *outputR = getOutput(0, &sizeOut);
+    double *outputI = getOutput(1, &sizeOut);
     
     // Transform
     
-    if (sizeOut && spectrum.realp && spectrum.imagp)
+    if (sizeOut && outputR && outputI)
     {
-        // Take the fft
+        FrameLib_PrecisionInput<T> inR(this, inputR, sizeInR);
+        FrameLib_PrecisionInput<T> inI(this, inputI, sizeInI);
+        FrameLib_PrecisionOutput<T> outR(this, outputR, sizeOut);
+        FrameLib_PrecisionOutput<T> outI(this, outputI, sizeOut);
+        
+        if (!inR || !inI || !outR || !outI)
+        {
+            outR.zero();
+            outI.zero();
+            return;
+        }
+        
+        spectrum.realp = outR.get();
+        spectrum.imagp = outI.get();
         
-        if (mMode == kComplex)
+        // Take the fft (complex inputs with no imaginary values are transformed as real inputs)
+        
+        bool realInput = mMode != kComplex || std::all_of(inI.get(), inI.get() + sizeInI, [](T x) { return x == T(0); });
+        
+        if (!realInput)
         {
-            copyVector(spectrum.realp, inputR, sizeInR);
-            zeroVector(spectrum.realp + sizeInR, sizeOut - sizeInR);
-            copyVector(spectrum.imagp, inputI, sizeInI);
-            zeroVector(spectrum.imagp + sizeInI, sizeOut - sizeInI);
+            std::copy(inR.get(), inR.get() + sizeInR, spectrum.realp);
+            std::fill_n(spectrum.realp + sizeInR, sizeOut - sizeInR, T(0));
+            std::copy(inI.get(), inI.get() + sizeInI, spectrum.imagp);
+            std::fill_n(spectrum.imagp + sizeInI, sizeOut - sizeInI, T(0));
             
-            mProcessor.fft(spectrum, FFTSizeLog2);
+            if (mExact)
+                processor.fft_arbitrary(spectrum, FFTSize);
+            else
+                processor.fft(spectrum, FFTSizeLog2);
         }
         else
         {
-            mProcessor.rfft(spectrum, inputR, sizeInR, FFTSizeLog2);
-            
-            // Move Nyquist Bin
-            
-            spectrum.realp[FFTSize >> 1] = spectrum.imagp[0];
-            spectrum.imagp[FFTSize >> 1] = 0.0;
-            spectrum.imagp[0] = 0.0;
-            
-            // Mirror Spectrum
-            
-            if (mMode == kFullSpectrum)
+            if (mExact)
+                processor.rfft_arbitrary(spectrum, inR.get(), sizeInR, FFTSize);
+            else
             {
-                for (unsigned long i = (FFTSize >> 1) + 1; i < sizeOut; i++)
-                {
-                    spectrum.realp[i] = spectrum.realp[FFTSize - i];
-                    spectrum.imagp[i] = -spectrum.imagp[FFTSize - i];
-                }
+                processor.rfft(spectrum, inR.get(), sizeInR, FFTSizeLog2);
+                
+                // Move Nyquist Bin
+                
+                spectrum.realp[FFTSize >> 1] = spectrum.imagp[0];
+                spectrum.imagp[FFTSize >> 1] = T(0);
+                spectrum.imagp[0] = T(0);
             }
         }
         
-        // Scale
+        // Scale (N.B. the power of two real transform produces double the spectrum)
+        
+        double scale = ((!realInput || mExact) ? 1.0 : 0.5) / (mNormalise ? (double) FFTSize : 1.0);
         
-        double scale = ((mMode == kComplex) ? 1.0 : 0.5) / (mNormalise ? (double) FFTSize : 1.0);
+        // Scale the unique bins only and then mirror the spectrum for real inputs with a full spectrum output
         
-        mProcessor.scale_spectrum(spectrum, sizeOut, scale);
+        if (realInput && mMode != kReal)
+        {
+            processor.scale_spectrum(spectrum, (FFTSize >> 1) + 1, static_cast<T>(scale));
+            processor.mirror_spectrum(spectrum, FFTSize);
+        }
+        else
+            processor.scale_spectrum(spectrum, sizeOut, static_cast<T>(scale));
     }
 }
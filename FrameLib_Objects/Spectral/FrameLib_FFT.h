@@ -3,6 +3,7 @@
 #define FRAMELIB_FFT_H
 
 #include "FrameLib_DSP.h"
+#include "FrameLib_SpectralPrecision.h"
 #include "../../FrameLib_Dependencies/SpectralProcessor.hpp"
 
 // FIX - add zero padding (why not do this prior to FFT with the pad object?)
@@ -12,9 +13,12 @@ class FrameLib_FFT final : public FrameLib_Processor
     // Parameter Enums and Info
 
     enum Mode { kReal, kComplex, kFullSpectrum };
-    enum ParameterList { kMaxLength, kNormalise, kMode };
+    enum ParameterList { kMaxLength, kNormalise, kMode, kExact, kPrecision };
     
     struct ParameterInfo : public FrameLib_Parameters::Info { ParameterInfo(); };
+    
+    template <class T>
+    using Processor = spectral_processor<T, FrameLib_DSP::Allocator>;
 
 public:
 
@@ -34,6 +38,9 @@ private:
     
     void process() override;
     
+    template <class T>
+    void transform(Processor<T>& processor);
+    
     // Param Info
     
     static ParameterInfo sParamInfo;
@@ -42,10 +49,11 @@ private:
     
     Mode mMode;
     bool mNormalise;
+    bool mExact;
     
-    // Processor
+    // Processors (using FFT setups shared with other objects)
     
-    spectral_processor<double, FrameLib_DSP::Allocator> mProcessor;
+    FrameLib_SpectralPrecision<Processor> mProcessor;
 };
 
 #endif
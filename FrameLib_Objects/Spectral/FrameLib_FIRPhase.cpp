@@ -3,7 +3,7 @@
 
 // Constructor / Destructor
 
-FrameLib_FIRPhase::FrameLib_FIRPhase(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 1, 1), mProcessor(*this)
+FrameLib_FIRPhase::FrameLib_FIRPhase(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 1, 1), mFFTSetup(context), mProcessor(*this, 0)
 {
     mParameters.addInt(kMaxLength, "maxlength", 16384, 0);
     mParameters.setMin(0);
@@ -13,7 +13,8 @@ FrameLib_FIRPhase::FrameLib_FIRPhase(FrameLib_Context context, FrameLib_Paramete
     
     mParameters.set(serialisedParameters);
     
-    mProcessor.set_max_fft_size(mParameters.getInt(kMaxLength));
+    mFFTSetup.acquire(mProcessor.calc_fft_size_log2(mParameters.getInt(kMaxLength)));
+    mProcessor.set_fft_setup(mFFTSetup.get(), mFFTSetup.getMaxLog2());
 }
 
 // Info
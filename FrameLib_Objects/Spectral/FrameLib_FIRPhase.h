@@ -37,8 +37,9 @@ private:
 
     static ParameterInfo sParamInfo;
     
-    // Processor
+    // Processor (using an FFT setup shared with other objects)
     
+    FrameLib_Context::FFTSetup<FFT_SETUP_D> mFFTSetup;
     spectral_processor<double, FrameLib_DSP::Allocator> mProcessor;
 };
 
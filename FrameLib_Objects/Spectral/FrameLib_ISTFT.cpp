@@ -0,0 +1,225 @@
+
+#include "FrameLib_ISTFT.h"
+
+// Constructor
+
+FrameLib_ISTFT::FrameLib_ISTFT(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_AudioOutput(context, proxy, &sParamInfo, 3, 0, 1), mWindow(context), mProcessor(context, this)
+{
+    mParameters.addDouble(kBufferSize, "buffer_size", 250000, 0);
+    mParameters.setMin(0);
+    mParameters.setInstantiation();
+    
+    mParameters.addEnum(kUnits, "units", 1);
+    mParameters.addEnumItem(kSamples, "samples");
+    mParameters.addEnumItem(kMS, "ms");
+    mParameters.addEnumItem(kSeconds, "seconds");
+    mParameters.setInstantiation();
+    
+    mParameters.addDouble(kDelay, "delay", 0);
+    mParameters.setMin(0);
+    
+    FrameLib_WindowTable::addParameters(mParameters, kWindowType);
+    
+    mParameters.addInt(kMaxLength, "maxlength", 16384);
+    mParameters.setMin(0);
+    mParameters.setInstantiation();
+    mParameters.addBool(kNormalise, "normalise", false);
+    mParameters.setInstantiation();
+    addPrecisionParameter(mParameters, kPrecision);
+    
+    mParameters.set(serialisedParameters);
+    
+    mProcessor.setPrecision(static_cast<FrameLib_Precision>(mParameters.getInt(kPrecision)), Processor<double>::calc_fft_size_log2(mParameters.getInt(kMaxLength)));
+    
+    mNormalise = mParameters.getBool(kNormalise);
+    
+    setParameterInput(2);
+    
+    objectReset();
+}
+
+// Info
+
+std::string FrameLib_ISTFT::objectInfo(bool verbose)
+{
+    return formatInfo("Calculates the inverse real Fast Fourier Transform of two input frames (comprising the real and imaginary values), "
+                   "windows the result and outputs it to the host environment by pasting it into an overlap-add buffer: "
+                   "This is equivalent to an ifft followed by a window and a sink, but uses a precomputed window and avoids the intermediate frames. "
+                   "Inputs are expected to match in length with a length of (N / 2) + 1 where N is the FFT size. The window spans the whole FFT size. "
+                   "The length of the internal buffer determines the maximum FFT size. Output suffers no latency.",
+                   "Calculates the inverse real Fast Fourier Transform of two input frames and outputs the windowed result to the host environment.", verbose);
+}
+
+std::string FrameLib_ISTFT::inputInfo(unsigned long idx, bool verbose)
+{
+    if (idx == 2)
+        return parameterInputInfo(verbose);
+    else if (idx)
+        return formatInfo("Frequency Domain Imaginary Values - inputs should match in size and be (N / 2) + 1 in length.", "Freq Domain Imag Values", verbose);
+    else
+        return formatInfo("Frequency Domain Real Values - inputs should match in size and be (N / 2) + 1 in length.", "Freq Domain Real Values", verbose);
+}
+
+std::string FrameLib_ISTFT::audioInfo(unsigned long idx, bool verbose)
+{
+    return "Audio Output";
+}
+
+// Parameter Info
+
+FrameLib_ISTFT::ParameterInfo FrameLib_ISTFT::sParamInfo;
+
+FrameLib_ISTFT::ParameterInfo::ParameterInfo()
+{
+    add("Sets the internal buffer size in the units specified by the units parameter.");
+    add("Sets the time units used to determine the buffer size and delay.");
+    add("Sets the delay before output in the units specified by the units parameter.");
+    FrameLib_WindowTable::addParameterInfo(*this);
+    add("Sets the maximum FFT size.");
+    add("When on the input is expected to be normalised.");
+    add("Sets the precision used internally. Single precision is faster but less accurate (frames are converted at the input).");
+}
+
+// Helpers
+
+unsigned long FrameLib_ISTFT::convertTimeToSamples(double time)
+{
+    switch (static_cast<Units>(mParameters.getInt(kUnits)))
+    {
+        case kSamples:  break;
+        case kMS:       time = msToSamples(time);       break;
+        case kSeconds:  time = secondsToSamples(time);  break;
+    }
+    
+    return roundToUInt(time);
+}
+
+void FrameLib_ISTFT::copyAndZero(double *output, unsigned long offset, unsigned long size)
+{
+    if (size)
+    {
+        copyVector(output, &mBuffer[offset], size);
+        zeroVector(&mBuffer[offset], size);
+        
+        mCounter = offset + size;
+    }
+}
+
+// Object Reset, Block Process and Process
+
+void FrameLib_ISTFT::objectReset()
+{
+    size_t size = convertTimeToSamples(mParameters.getValue(kBufferSize)) + mMaxBlockSize;
+    
+    if (size != bufferSize())
+        mBuffer.resize(size);
+    
+    zeroVector(mBuffer.data(), bufferSize());
+    
+    mCounter = 0;
+}
+
+void FrameLib_ISTFT::blockProcess(const double * const *ins, double **outs, unsigned long blockSize)
+{
+    // Safety
+    
+    if (blockSize > bufferSize() || isTimedOut())
+    {
+        zeroVector(outs[0], blockSize);
+        return;
+    }
+    
+    // Calculate first segment size and copy segments
+    
+    unsigned long size = ((mCounter + blockSize) > bufferSize()) ? bufferSize() - mCounter : blockSize;
+    
+    copyAndZero(outs[0], mCounter, size);
+    copyAndZero(outs[0] + size, 0, blockSize - size);
+}
+
+void FrameLib_ISTFT::process()
+{
+    if (mProcessor.getPrecision() == kPrecisionSingle)
+        transform(mProcessor.getSingle());
+    else
+        transform(mProcessor.getDouble());
+}
+
+template <class T>
+void FrameLib_ISTFT::transform(Processor<T>& processor)
+{
+    typename FFTTypes<T>::Split spectrum;
+    
+    unsigned long sizeInR, sizeInI;
+    
+    FrameLib_TimeFormat frameTime = getFrameTime();
+    FrameLib_TimeFormat delayTime = convertTimeToSamples(mParameters.getValue(kDelay));
+    FrameLib_TimeFormat blockStartTime = getBlockStartTime();
+    const double *inputR = getInput(0, &sizeInR);
+    const double *inputI = getInput(1, &sizeInI);
+    
+    unsigned long sizeIn = std::max(sizeInR, sizeInI);
+    
+    // Get FFT size (and log 2)
+    
+    unsigned long FFTSizeLog2 = processor.calc_fft_size_log2(sizeIn ? (sizeIn - 1) << 1 : 0);
+    unsigned long FFTSize = 1 << FFTSizeLog2;
+    unsigned long spectrumSize = FFTSize >> 1;
+    
+    // Calculate time offset
+    
+    unsigned long offset = roundToUInt(delayTime + frameTime - blockStartTime);
+    
+    // Safety
+    
+    if (!spectrumSize || FFTSize > processor.max_fft_size() || frameTime < blockStartTime || (offset + FFTSize) > bufferSize())
+        return;
+    
+    // Setup temporary memory (the scaling of the transform is folded into the window)
+    
+    T *frame = alloc<T>(FFTSize * 2);
+    
+    double scale = mNormalise ? 1.0 : 1.0 / static_cast<double>(FFTSize);
+    
+    if (!frame || !mWindow.update(mParameters, kWindowType, FFTSize, scale))
+    {
+        dealloc(frame);
+        return;
+    }
+    
+    spectrum.realp = frame + FFTSize;
+    spectrum.imagp = spectrum.realp + spectrumSize;
+    
+    // Copy Spectrum
+    
+    unsigned long copySizeR = std::min(sizeInR, spectrumSize);
+    unsigned long copySizeI = std::min(sizeInI, spectrumSize);
+    
+    std::copy(inputR, inputR + copySizeR, spectrum.realp);
+    std::fill_n(spectrum.realp + copySizeR, spectrumSize - copySizeR, T(0));
+    std::copy(inputI, inputI + copySizeI, spectrum.imagp);
+    std::fill_n(spectrum.imagp + copySizeI, spectrumSize - copySizeI, T(0));
+    
+    // Copy Nyquist Bin
+    
+    if (sizeInR >= spectrumSize + 1)
+        spectrum.imagp[0] = static_cast<T>(inputR[spectrumSize]);
+    
+    // Convert to time domain
+    
+    processor.rifft(frame, spectrum, FFTSizeLog2);
+    
+    // Calculate actual offset into buffer
+    
+    offset += mCounter;
+    offset = (offset < bufferSize()) ? offset : offset - bufferSize();
+    
+    // Calculate first segment size and window and add segments
+    
+    unsigned long size = ((offset + FFTSize) > bufferSize()) ? bufferSize() - offset : FFTSize;
+    
+    mWindow.applyAdd(&mBuffer[offset], frame, 0, size);
+    mWindow.applyAdd(mBuffer.data(), frame + size, size, FFTSize - size);
+    
+    dealloc(frame);
+}
@@ -0,0 +1,71 @@
+
+#ifndef FRAMELIB_ISTFT_H
+#define FRAMELIB_ISTFT_H
+
+#include "FrameLib_DSP.h"
+#include "FrameLib_SpectralPrecision.h"
+#include "FrameLib_WindowTable.h"
+#include "../../FrameLib_Dependencies/SpectralProcessor.hpp"
+
+#include <vector>
+
+class FrameLib_ISTFT final : public FrameLib_AudioOutput
+{
+    // Parameter Enums and Info
+    
+    enum ParameterList { kBufferSize, kUnits, kDelay, kWindowType, kSqrt, kCompensation, kMaxLength, kNormalise, kPrecision };
+    enum Units { kSamples, kMS, kSeconds };
+    
+    struct ParameterInfo : public FrameLib_Parameters::Info { ParameterInfo(); };
+    
+    template <class T>
+    using Processor = spectral_processor<T, FrameLib_DSP::Allocator>;
+
+public:
+    
+    // Constructor
+    
+    FrameLib_ISTFT(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy);
+    
+    // Info
+    
+    std::string objectInfo(bool verbose) override;
+    std::string inputInfo(unsigned long idx, bool verbose) override;
+    std::string audioInfo(unsigned long idx, bool verbose) override;
+
+private:
+    
+    // Helpers
+    
+    unsigned long bufferSize() const { return static_cast<unsigned long>(mBuffer.size()); }
+    
+    unsigned long convertTimeToSamples(double time);
+    
+    void copyAndZero(double *output, unsigned long offset, unsigned long size);
+    
+    // Object Reset, Block Process and Process
+    
+    void objectReset() override;
+    void blockProcess(const double * const *ins, double **outs, unsigned long blockSize) override;
+    void process() override;
+    
+    template <class T>
+    void transform(Processor<T>& processor);
+    
+    // Data
+    
+    std::vector<double> mBuffer;
+    unsigned long mCounter;
+    
+    bool mNormalise;
+    
+    FrameLib_WindowTable mWindow;
+    
+    // Processors (using FFT setups shared with other objects)
+    
+    FrameLib_SpectralPrecision<Processor> mProcessor;
+    
+    static ParameterInfo sParamInfo;
+};
+
+#endif
@@ -3,7 +3,7 @@
 
 // Constructor / Destructor
 
-FrameLib_Multitaper::FrameLib_Multitaper(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 1, 1), mProcessor(*this)
+FrameLib_Multitaper::FrameLib_Multitaper(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 1, 1), mFFTSetup(context), mProcessor(*this, 0)
 {
     mParameters.addInt(kMaxLength, "maxlength", 16384, 0);
     mParameters.setMin(0);
@@ -12,50 +12,34 @@ FrameLib_Multitaper::FrameLib_Multitaper(FrameLib_Context context, FrameLib_Para
     mParameters.addInt(kNumTapers, "numtapers", 3, 1);
     mParameters.setMin(1);
     
-    mParameters.set(serialisedParameters);
+    mParameters.addEnum(kWeighting, "weighting", 2);
+    mParameters.addEnumItem(kParabolic, "parabolic");
+    mParameters.addEnumItem(kAdaptive, "adaptive");
     
-    mProcessor.set_max_fft_size(mParameters.getInt(kMaxLength) * 2);
-}
-
-// Helpers
-
-void FrameLib_Multitaper::getWrapped(double &rOut, double&iOut, double *real, double *imag, long size, long pos)
-{
-    pos &= (size - 1);
+    mParameters.set(serialisedParameters);
     
-    if (pos <= (size >> 1))
-    {
-        rOut = real[pos];
-        iOut = imag[pos];
-    }
-    else
-    {
-        pos = size - pos;
-        rOut = real[pos];
-        iOut = -imag[pos];
-    }
+    mFFTSetup.acquire(mProcessor.calc_fft_size_log2(mParameters.getInt(kMaxLength) * 2));
+    mProcessor.set_fft_setup(mFFTSetup.get(), mFFTSetup.getMaxLog2());
 }
 
 // Info
 
 std::string FrameLib_Multitaper::objectInfo(bool verbose)
 {
-    return formatInfo("Calculates the multitaper power spectrum of a real input using the cosine tapers: All FFTs performed will use a power of two size. "
-                   "Output frames will be (N / 2) + 1 in length where N is the FFT size. Inputs which are not a power of two are zero-padded to the next power of two.",
-                   "Calculates the multitaper power spectrum of a real input using the cosinre tapers.", verbose);
+    return formatInfo("Calculates the multitaper power spectrum of a real input using sine tapers: All FFTs performed will use a power of two size. "
+                   "Output frames will be (N / 2) + 1 in length where N is the FFT size. Inputs which are not a power of two are zero-padded to the next power of two. "
+                   "The taper spectra are combined either with fixed parabolic weights, or adaptively per bin to reduce broadband leakage.",
+                   "Calculates the multitaper power spectrum of a real input using sine tapers.", verbose);
 }
 
 std::string FrameLib_Multitaper::inputInfo(unsigned long idx, bool verbose)
 {
-    if (idx)
-        return formatInfo("Frequency Domain Real Values - inputs should match in size and be (N / 2) + 1 in length.", "Freq Domain Real Values", verbose);
-    else
-        return formatInfo("Frequency Domain Imaginary Values - inputs should match in size and be (N / 2) + 1 in length.", "Freq Domain Imag Values", verbose);
+    return formatInfo("Time Domain Input - will be zero-padded if the length is not a power of two.", "Time Domain Input", verbose);
 }
 
 std::string FrameLib_Multitaper::outputInfo(unsigned long idx, bool verbose)
 {
-    return "Time Domain Output";
+    return "Power Spectrum";
 }
 
 // Parameter Info
@@ -66,6 +50,8 @@ FrameLib_Multitaper::ParameterInfo::ParameterInfo()
 {
     add("Sets the maximum input length / FFT size.");
     add("Sets the number of tapers to use.");
+    add("Sets the weighting of the tapers. parabolic - fixed weights that decrease with the taper order. "
+        "adaptive - weights are calculated per bin (after Thomson) so that tapers with greater broadband leakage contribute less where the spectrum is low.");
 }
 
 // Process
@@ -94,70 +80,12 @@ void FrameLib_Multitaper::process()
     allocateOutputs();
     
     double *output = getOutput(0, &sizeOut);
-    double *tempMem = alloc<double>((FFTSize + 1) << 1);
     
     unsigned long nTapers = mParameters.getInt(kNumTapers);
+    bool adaptive = static_cast<Weighting>(mParameters.getInt(kWeighting)) == kAdaptive;
     
-    // Transform
+    // Calculate the power spectrum (the spectrum is unwrapped once and each taper is a contiguous pass over the bins)
     
-    if (tempMem && sizeOut && output)
-    {
-        FFT_SPLIT_COMPLEX_D spectrum;
-        
-        spectrum.realp = ((double *) tempMem);
-        spectrum.imagp = ((double *) tempMem) + (FFTSize + 1);
-        
-        // Take the real fft
-        
-        mProcessor.rfft(spectrum, input, sizeIn, (FFTSizeLog2 + 1));
-        
-        // Move Nyquist Bin
-        
-        spectrum.realp[FFTSize] = spectrum.imagp[0];
-        spectrum.imagp[FFTSize] = 0.0;
-        spectrum.imagp[0] = 0.0;
-        
-        // Scale
-        
-        mProcessor.scale_spectrum(spectrum, FFTSize + 1, 0.5);
-        
-        // Do Multitaper
-        
-        // Zero output power spectrum
-        
+    if (sizeOut && !mProcessor.power_spectrum(output, input, sizeIn, nTapers, adaptive ? mProcessor.kWeightingAdaptive : mProcessor.kWeightingParabolic))
         zeroVector(output, sizeOut);
-
-        // Do tapers
-        
-        // FIX - weighting - I can't find where this stuff comes from...
-        
-        double weightSum = nTapers - (((1.0 / (double) nTapers) - 3.0 + 2.0 * nTapers) / 6.0);
-        double normFactor = 1.0 / (4.0 * weightSum);
-        
-        for (unsigned long i = 1; i <= nTapers; i++)
-        {
-            double weight = (1.0 - ((i - 1) * (i - 1)) / (double) (nTapers * nTapers));
-            double taperScale = weight * normFactor;
-            
-            // Deal with bins safely (could be optimised)
-            
-            for (unsigned long j = 0; j < sizeOut; j++)
-            {
-                double r1, i1, r2, i2, r3, i3;
-                
-                getWrapped(r1, i1, spectrum.realp, spectrum.imagp, FFTSize << 1, ((j << 1) + i));
-                getWrapped(r2, i2, spectrum.realp, spectrum.imagp, FFTSize << 1, ((j << 1) - i));
-                
-                // FIX - possible these should be flipped...
-                
-                r3 = (i1 - i2);
-                i3 = (r2 - r1);
-                
-                output[j] += ((r3 * r3) + (i3 * i3)) * taperScale;
-            }
-        }
-        
-    }
-    
-    dealloc(tempMem);
 }
@@ -3,13 +3,14 @@
 #define FRAMELIB_MULTITAPER_H
 
 #include "FrameLib_DSP.h"
-#include "../../FrameLib_Dependencies/SpectralProcessor.hpp"
+#include "../../FrameLib_Dependencies/MultitaperEstimator.hpp"
 
 class FrameLib_Multitaper final : public FrameLib_Processor
 {
     // Parameter Enums and Info
 
-    enum ParameterList { kMaxLength, kNumTapers };
+    enum ParameterList { kMaxLength, kNumTapers, kWeighting };
+    enum Weighting { kParabolic, kAdaptive };
     
     struct ParameterInfo : public FrameLib_Parameters::Info { ParameterInfo(); };
 
@@ -27,19 +28,16 @@ public:
 
 private:
     
-    // Helpers
-    
-    void getWrapped(double &rOut, double&iOut, double *real, double *imag, long size, long pos);
-    
     // Process
     
     void process() override;
     
     static ParameterInfo sParamInfo;
     
-    // Processor
+    // Processor (using an FFT setup shared with other objects)
     
-    spectral_processor<double, FrameLib_DSP::Allocator> mProcessor;
+    FrameLib_Context::FFTSetup<FFT_SETUP_D> mFFTSetup;
+    multitaper_estimator<double, FrameLib_DSP::Allocator> mProcessor;
 };
 
 #endif
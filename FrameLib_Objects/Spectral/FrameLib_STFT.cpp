@@ -0,0 +1,240 @@
+
+#include "FrameLib_STFT.h"
+
+// Constructor
+
+FrameLib_STFT::FrameLib_STFT(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_AudioInput(context, proxy, &sParamInfo, 2, 2, 1), mWindow(context), mProcessor(context, this)
+{
+    mParameters.addDouble(kBufferSize, "buffer_size", 16384, 0);
+    mParameters.setMin(0.0);
+    mParameters.setInstantiation();
+    
+    mParameters.addInt(kLength, "length", 4096, 1);
+    mParameters.setMin(0);
+    
+    mParameters.addEnum(kUnits, "units", 2);
+    mParameters.addEnumItem(kSamples, "samples");
+    mParameters.addEnumItem(kMS, "ms");
+    mParameters.addEnumItem(kSeconds, "seconds");
+    
+    mParameters.addDouble(kDelay, "delay", 0);
+    mParameters.setMin(0);
+    
+    FrameLib_WindowTable::addParameters(mParameters, kWindowType);
+    
+    mParameters.addInt(kMaxLength, "maxlength", 16384);
+    mParameters.setMin(0);
+    mParameters.setInstantiation();
+    mParameters.addBool(kNormalise, "normalise", false);
+    mParameters.setInstantiation();
+    addPrecisionParameter(mParameters, kPrecision);
+    
+    mParameters.set(serialisedParameters);
+    
+    mProcessor.setPrecision(static_cast<FrameLib_Precision>(mParameters.getInt(kPrecision)), Processor<double>::calc_fft_size_log2(mParameters.getInt(kMaxLength)));
+    
+    mLength = convertTimeToSamples(mParameters.getValue(kLength));
+    mNormalise = mParameters.getBool(kNormalise);
+    
+    setParameterInput(1);
+    
+    objectReset();
+}
+
+// Info
+
+std::string FrameLib_STFT::objectInfo(bool verbose)
+{
+    return formatInfo("Captures audio from the host environment and outputs the real Fast Fourier Transform of the most recent values after windowing: "
+                   "This is equivalent to a source followed by a window and an fft, but uses a precomputed window and avoids the intermediate frames. "
+                   "Windows are the length of the captured frame, which is zero-padded to the next power of two for the transform. "
+                   "Output frames will be (N / 2) + 1 in length where N is the FFT size. Real and imaginary values are output as separate frames. "
+                   "Latency is equivalent to the length of the captured frame. The length of the internal buffer determines the maximum frame length.",
+                   "Captures audio from the host environment and outputs the real Fast Fourier Transform of the most recent values after windowing.", verbose);
+}
+
+std::string FrameLib_STFT::inputInfo(unsigned long idx, bool verbose)
+{
+    if (idx)
+        return parameterInputInfo(verbose);
+    else
+        return formatInfo("Trigger Frame - triggers capture and transform to output", "Trigger Frame", verbose);
+}
+
+std::string FrameLib_STFT::outputInfo(unsigned long idx, bool verbose)
+{
+    if (!idx)
+        return "Real Values";
+    else
+        return "Imaginary Values";
+}
+
+std::string FrameLib_STFT::audioInfo(unsigned long idx, bool verbose)
+{
+    return "Audio Input";
+}
+
+// Parameter Info
+
+FrameLib_STFT::ParameterInfo FrameLib_STFT::sParamInfo;
+
+FrameLib_STFT::ParameterInfo::ParameterInfo()
+{
+    add("Sets the internal buffer size in the units specified by the units parameter.");
+    add("Sets the length of captured (and windowed) frames in the units specified by the units parameter.");
+    add("Sets the time units used to determine the buffer size and length.");
+    add("Sets the input delay in the units specified by the units parameter: "
+        "N.B. - there is a minimum delay or latency of the captured length.");
+    FrameLib_WindowTable::addParameterInfo(*this);
+    add("Sets the maximum FFT size.");
+    add("When on the output is normalised so that sine waves produce the same level output regardless of the FFT size.");
+    add("Sets the precision used internally. Single precision is faster but less accurate (frames are converted at the output).");
+}
+
+// Helpers
+
+unsigned long FrameLib_STFT::convertTimeToSamples(double time)
+{
+    switch (static_cast<Units>(mParameters.getInt(kUnits)))
+    {
+        case kSamples:  break;
+        case kMS:       time = msToSamples(time);       break;
+        case kSeconds:  time = secondsToSamples(time);  break;
+    }
+    
+    return roundToUInt(time);
+}
+
+void FrameLib_STFT::copy(const double *input, unsigned long offset, unsigned long size)
+{
+    if (size)
+    {
+        copyVector(&mBuffer[offset], input, size);
+        mCounter = offset + size;
+    }
+}
+
+// Object Reset, Block Process, Update and Process
+
+void FrameLib_STFT::objectReset()
+{
+    unsigned long size = convertTimeToSamples(mParameters.getValue(kBufferSize)) + mMaxBlockSize;
+    
+    if (size != bufferSize())
+        mBuffer.resize(size);
+    
+    zeroVector(mBuffer.data(), bufferSize());
+    
+    mCounter = 0;
+}
+
+void FrameLib_STFT::blockProcess(const double * const *ins, double **outs, unsigned long blockSize)
+{
+    // Safety
+    
+    if (blockSize > bufferSize())
+        return;
+    
+    // Calculate first segment size and copy segments
+    
+    unsigned long size = ((mCounter + blockSize) > bufferSize()) ? bufferSize() - mCounter : blockSize;
+    
+    copy(ins[0], mCounter, size);
+    copy(ins[0] + size, 0, blockSize - size);
+}
+
+void FrameLib_STFT::update()
+{
+    mLength = convertTimeToSamples(mParameters.getValue(kLength));
+}
+
+void FrameLib_STFT::process()
+{
+    if (mProcessor.getPrecision() == kPrecisionSingle)
+        transform(mProcessor.getSingle());
+    else
+        transform(mProcessor.getDouble());
+}
+
+template <class T>
+void FrameLib_STFT::transform(Processor<T>& processor)
+{
+    typename FFTTypes<T>::Split spectrum;
+    
+    unsigned long length = mLength;
+    
+    FrameLib_TimeFormat frameTime = getFrameTime();
+    unsigned long delayTime = convertTimeToSamples(mParameters.getValue(kDelay));
+    delayTime = std::max(length, delayTime);
+    
+    // Get FFT size (and log 2)
+    
+    unsigned long FFTSizeLog2 = processor.calc_fft_size_log2(length);
+    unsigned long FFTSize = 1 << FFTSizeLog2;
+    unsigned long sizeOut = length ? (FFTSize >> 1) + 1 : 0;
+    
+    // Check size
+    
+    if (FFTSize > processor.max_fft_size())
+        sizeOut = 0;
+    
+    // Calculate output size
+    
+    requestOutputSize(0, sizeOut);
+    requestOutputSize(1, sizeOut);
+    allocateOutputs();
+    
+    double *outputR = getOutput(0, &sizeOut);
+    double *outputI = getOutput(1, &sizeOut);
+    
+    if (!sizeOut || !outputR || !outputI)
+        return;
+    
+    // Calculate time offset
+    
+    unsigned long offset = roundToUInt(getBlockEndTime() - frameTime) + delayTime;
+    
+    // Setup outputs and temporary memory (the scaling of the transform is folded into the window)
+    
+    FrameLib_PrecisionOutput<T> outR(this, outputR, sizeOut);
+    FrameLib_PrecisionOutput<T> outI(this, outputI, sizeOut);
+    T *frame = alloc<T>(length);
+    
+    double scale = 0.5 / (mNormalise ? static_cast<double>(FFTSize) : 1.0);
+    
+    // Safety
+    
+    if (offset > bufferSize() || !outR || !outI || !frame || !mWindow.update(mParameters, kWindowType, length, scale))
+    {
+        outR.zero();
+        outI.zero();
+        dealloc(frame);
+        return;
+    }
+    
+    // Calculate actual offset into buffer
+    
+    offset = (offset <= mCounter) ? mCounter - offset : mCounter + bufferSize() - offset;
+    
+    // Calculate first segment size and window segments
+    
+    unsigned long size = ((offset + length) > bufferSize()) ? bufferSize() - offset : length;
+    
+    mWindow.apply(frame, &mBuffer[offset], 0, size);
+    mWindow.apply(frame + size, mBuffer.data(), size, length - size);
+    
+    // Take the fft (directly into the output)
+    
+    spectrum.realp = outR.get();
+    spectrum.imagp = outI.get();
+    
+    processor.rfft(spectrum, frame, length, FFTSizeLog2);
+    
+    // Move Nyquist Bin
+    
+    spectrum.realp[FFTSize >> 1] = spectrum.imagp[0];
+    spectrum.imagp[FFTSize >> 1] = T(0);
+    spectrum.imagp[0] = T(0);
+    
+    dealloc(frame);
+}
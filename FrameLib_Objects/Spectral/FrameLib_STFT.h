@@ -0,0 +1,74 @@
+
+#ifndef FRAMELIB_STFT_H
+#define FRAMELIB_STFT_H
+
+#include "FrameLib_DSP.h"
+#include "FrameLib_SpectralPrecision.h"
+#include "FrameLib_WindowTable.h"
+#include "../../FrameLib_Dependencies/SpectralProcessor.hpp"
+
+#include <vector>
+
+class FrameLib_STFT final : public FrameLib_AudioInput
+{
+    // Parameter Enums and Info
+    
+    enum ParameterList { kBufferSize, kLength, kUnits, kDelay, kWindowType, kSqrt, kCompensation, kMaxLength, kNormalise, kPrecision };
+    enum Units { kSamples, kMS, kSeconds };
+    
+    struct ParameterInfo : public FrameLib_Parameters::Info { ParameterInfo(); };
+    
+    template <class T>
+    using Processor = spectral_processor<T, FrameLib_DSP::Allocator>;
+
+public:
+    
+    // Constructor
+    
+    FrameLib_STFT(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy);
+    
+    // Info
+    
+    std::string objectInfo(bool verbose) override;
+    std::string inputInfo(unsigned long idx, bool verbose) override;
+    std::string outputInfo(unsigned long idx, bool verbose) override;
+    std::string audioInfo(unsigned long idx, bool verbose) override;
+
+private:
+    
+    // Helpers
+    
+    unsigned long bufferSize() const { return static_cast<unsigned long>(mBuffer.size()); }
+    
+    unsigned long convertTimeToSamples(double time);
+    
+    void copy(const double *input, unsigned long offset, unsigned long size);
+    
+    // Object Reset, Block Process, Update and Process
+    
+    void objectReset() override;
+    void blockProcess(const double * const *ins, double **outs, unsigned long blockSize) override;
+    void update() override;
+    void process() override;
+    
+    template <class T>
+    void transform(Processor<T>& processor);
+    
+    // Data
+    
+    std::vector<double> mBuffer;
+    unsigned long mLength;
+    unsigned long mCounter;
+    
+    bool mNormalise;
+    
+    FrameLib_WindowTable mWindow;
+    
+    // Processors (using FFT setups shared with other objects)
+    
+    FrameLib_SpectralPrecision<Processor> mProcessor;
+    
+    static ParameterInfo sParamInfo;
+};
+
+#endif
@@ -1,13 +1,9 @@
 
 #include "FrameLib_Window.h"
 
-// Window Calculator
+// Constructor
 
-FrameLib_Window::WindowCalculator FrameLib_Window::sWindowCalculator;
-
-// Constructor / Destructor
-
-FrameLib_Window::FrameLib_Window(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 2, 1)
+FrameLib_Window::FrameLib_Window(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 2, 1), mWindowTable(context)
 {
     mParameters.addEnum(kWindowType, "window", 0);
     mParameters.addEnumItem(kHann, "hann");
@@ -43,9 +39,7 @@ FrameLib_Window::FrameLib_Window(FrameLib_Context context, FrameLib_Parameters::
     mParameters.set(serialisedParameters);
     
     mWindow = nullptr;
-    mWindowType = kHann;
     mSize = 0;
-    mSqrtWindow = false;
     mLinearGain = 0.0;
     mPowerGain = 0.0;
     mEnds = kNone;
@@ -53,11 +47,6 @@ FrameLib_Window::FrameLib_Window(FrameLib_Context context, FrameLib_Parameters::
     setParameterInput(1);
 }
 
-FrameLib_Window::~FrameLib_Window()
-{
-    dealloc(mWindow);
-}
-
 // Info
 
 std::string FrameLib_Window::objectInfo(bool verbose)
@@ -97,7 +86,7 @@ FrameLib_Window::ParameterInfo::ParameterInfo()
 
 // Helpers
 
-void FrameLib_Window::updateWindow(unsigned long inSize, EndPoints ends)
+bool FrameLib_Window::updateWindow(unsigned long inSize, EndPoints ends)
 {
     WindowTypes windowType = (WindowTypes) mParameters.getInt(kWindowType);
     bool sqrtWindow = mParameters.getBool(kSqrt);
@@ -108,61 +97,43 @@ void FrameLib_Window::updateWindow(unsigned long inSize, EndPoints ends)
     windowSize = ends == kBoth ? windowSize - 1 : windowSize;
     windowSize = ends == kNone ? windowSize + 1 : windowSize;
     
-    if (windowSize == mSize && windowType == mWindowType && sqrtWindow == mSqrtWindow && ends == mEnds)
-        return;
+    // Acquire the table (which is only calculated if no other object holds a matching one)
     
-    if (mSize != windowSize)
+    const FrameLib_WindowCache::Table *previous = mWindowTable.get();
+    const FrameLib_WindowCache::Table *table = mWindowTable.acquire(static_cast<FrameLib_WindowCache::WindowTypes>(windowType), windowSize, windowSize + 1, sqrtWindow);
+    
+    if (!table)
     {
-        dealloc(mWindow);
-        mWindow = alloc<double>(windowSize + 2);
+        mWindow = nullptr;
+        return false;
     }
     
-    sWindowCalculator.calculate(windowType, mWindow, windowSize, windowSize + 1);
-    
-    mWindow[windowSize + 1] = mWindow[windowSize];
-    
-    if (sqrtWindow)
-        for (unsigned long i = 0; i <= windowSize + 1; i++)
-            mWindow[i] = sqrt(mWindow[i]);
+    if (table == previous && ends == mEnds)
+        return true;
     
     // Store window parameters
     
-    mWindowType = windowType;
+    mWindow = table->mWindow;
     mSize = windowSize;
-    mSqrtWindow = sqrtWindow;
     mEnds = ends;
     
     // Calculate the gain of the window
     
-    double linearGain = 0.0;
-    double powerGain = 0.0;
-    
-    for (unsigned long i = 1; i < windowSize; i++)
-        linearGain += mWindow[i];
-    
-    for (unsigned long i = 1; i < windowSize; i++)
-        powerGain += mWindow[i] * mWindow[i];
+    bool first = ends == kFirst || ends == kBoth;
+    bool last = ends == kLast || ends == kBoth;
     
     unsigned long sizeNorm = mSize;
     
-    if (ends == kFirst || ends == kBoth)
-    {
-        linearGain += mWindow[0];
-        powerGain += mWindow[0] * mWindow[0];
-    }
-    
-    if (ends == kLast || ends == kBoth)
-    {
-        linearGain += mWindow[mSize - 1];
-        powerGain += mWindow[mSize - 1] * mWindow[mSize - 1];
+    if (last)
         sizeNorm++;
-    }
     
     if (ends == kNone)
         sizeNorm--;
     
-    mLinearGain = (double) sizeNorm / linearGain;
-    mPowerGain = (double) sizeNorm / powerGain;
+    mLinearGain = (double) sizeNorm / table->linearSum(first, last);
+    mPowerGain = (double) sizeNorm / table->powerSum(first, last);
+    
+    return true;
 }
 
 double FrameLib_Window::linearInterp(double pos)
@@ -202,9 +173,13 @@ void FrameLib_Window::process()
         sizeFactor = ends == kNone ? sizeIn + 1 : sizeFactor;
         
         bool preIncrement = ends == kNone || ends == kLast;
-        double gain;
+        double gain = 1.0;
 
-        updateWindow(sizeIn, ends);
+        if (!updateWindow(sizeIn, ends))
+        {
+            zeroVector(output, sizeOut);
+            return;
+        }
         
         switch (compensate)
         {
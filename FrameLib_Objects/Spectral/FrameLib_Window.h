@@ -3,7 +3,6 @@
 #define FRAMELIB_WINDOW_H
 
 #include "FrameLib_DSP.h"
-#include "../../FrameLib_Dependencies/WindowFunctions.hpp"
 #include "../../FrameLib_Dependencies/TableReader.hpp"
 
 // FIX - review gain calculation
@@ -21,10 +20,9 @@ class FrameLib_Window final : public FrameLib_Processor
 
 public:
 
-    // Constructor / Destructor
+    // Constructor
     
     FrameLib_Window(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy);
-    ~FrameLib_Window();
     
     // Info
     
@@ -36,7 +34,7 @@ private:
 
     // Helpers
     
-    void updateWindow (unsigned long inSize, EndPoints ends);
+    bool updateWindow(unsigned long inSize, EndPoints ends);
     double linearInterp(double pos);
     
     // Process
@@ -54,37 +52,17 @@ private:
         const double *mData;
     };
     
-    struct WindowCalculator : public WindowFunctions<double *, WindowTypes>
-    {
-        WindowCalculator()
-        {
-            add(kHann, window_hann);
-            add(kHamming, window_hamming);
-            add(kTriangle, window_triangle);
-            add(kCosine, window_cosine);
-            add(kBlackman, window_blackman);
-            add(kBlackman62, window_blackman_62);
-            add(kBlackman70, window_blackman_70);
-            add(kBlackman74, window_blackman_62);
-            add(kBlackman92, window_blackman_92);
-            add(kBlackmanHarris, window_blackman_harris);
-            add(kFlatTop, window_kaiser);
-            add(kRectangle, window_rect);
-        }
-    };
-    
     // Data
     
-    static WindowCalculator sWindowCalculator;
-    double *mWindow;
+    // Window table (shared with other objects)
+    
+    FrameLib_Context::WindowTable mWindowTable;
+    const double *mWindow;
 
-    WindowTypes mWindowType;
     EndPoints mEnds;
     
     unsigned long mSize;
 
-    bool mSqrtWindow;
-
     double mLinearGain;
     double mPowerGain;
     
@@ -3,7 +3,7 @@
 
 // Constructor / Destructor
 
-FrameLib_iFFT::FrameLib_iFFT(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 2, 1), mProcessor(*this)
+FrameLib_iFFT::FrameLib_iFFT(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 2, 1), mProcessor(context, this)
 {
     mParameters.addInt(kMaxLength, "maxlength", 16384, 0);
     mParameters.setMin(0);
@@ -15,15 +15,19 @@ FrameLib_iFFT::FrameLib_iFFT(FrameLib_Context context, FrameLib_Parameters::Seri
     mParameters.addEnumItem(kComplex, "complex");
     mParameters.addEnumItem(kFullSpectrum, "fullspectrum");
     mParameters.setInstantiation();
+    mParameters.addBool(kExact, "exact", false);
+    mParameters.setInstantiation();
+    addPrecisionParameter(mParameters, kPrecision);
 
     mParameters.set(serialisedParameters);
         
-    mProcessor.set_max_fft_size(mParameters.getInt(kMaxLength));
+    mProcessor.setPrecision(static_cast<FrameLib_Precision>(mParameters.getInt(kPrecision)), Processor<double>::calc_fft_size_log2(mParameters.getInt(kMaxLength)));
 
     // Store parameters
     
     mMode = static_cast<Mode>(mParameters.getInt(kMode));
     mNormalise = mParameters.getBool(kNormalise);
+    mExact = mParameters.getBool(kExact);
     
     // If in complex mode create 2 inlets/outlets
     
@@ -35,8 +39,9 @@ FrameLib_iFFT::FrameLib_iFFT(FrameLib_Context context, FrameLib_Parameters::Seri
 
 std::string FrameLib_iFFT::objectInfo(bool verbose)
 {
-    return formatInfo("Calculate the inverse real Fast Fourier Transform of two input frames (comprising the real and imaginary values): All FFTs performed will use a power of two size. "
-                   "Output frames will be N in length where N is the FFT size. Inputs are expected to match in length with a length of (N / 2) + 1.",
+    return formatInfo("Calculate the inverse real Fast Fourier Transform of two input frames (comprising the real and imaginary values): By default all FFTs performed will use a power of two size. "
+                   "Output frames will be N in length where N is the FFT size. Inputs are expected to match in length with a length of (N / 2) + 1. "
+                   "If the exact parameter is on the FFT size is instead derived directly from the input length.",
                    "Calculate the inverse real Fast Fourier Transform of two input frames (comprising the real and imaginary values).", verbose);
 }
 
@@ -61,17 +66,33 @@ FrameLib_iFFT::ParameterInfo::ParameterInfo()
 {
     add("Sets the maximum output length / FFT size.");
     add("When on the input is expected to be normalised.");
-    add("Sets the type of input expected / output produced.");
+    add("Sets the type of input expected / output produced. "
+        "real - (N / 2) + 1 bins input with real output. "
+        "complex - N bins input with complex output (spectra of real signals are transformed as real spectra). "
+        "fullspectrum - N bins input (of which only the unique bins are used) with real output.");
+    add("When on the FFT size is derived directly from the input length (which need not correspond to a power of two). "
+        "In real mode the output length is then 2 * (M - 1) where M is the input length.");
+    add("Sets the precision used internally. Single precision is faster but less accurate (frames are converted at the input and output).");
 }
 
 // Process
 
 void FrameLib_iFFT::process()
 {
-    FFT_SPLIT_COMPLEX_D spectrum;
+    if (mProcessor.getPrecision() == kPrecisionSingle)
+        transform(mProcessor.getSingle());
+    else
+        transform(mProcessor.getDouble());
+}
+
+template <class T>
+void FrameLib_iFFT::transform(Processor<T>& processor)
+{
+    typename FFTTypes<T>::Split spectrum;
     
     unsigned long sizeInR, sizeInI, sizeIn, sizeOut, spectrumSize;
     unsigned long FFTSizeLog2 = 0;
+    unsigned long FFTSize = 0;
     
     // Get Inputs
     
@@ -83,15 +104,16 @@ void FrameLib_iFFT::process()
     if (sizeIn)
     {
         unsigned long calcSize = mMode == kReal ? (sizeIn - 1) << 1 : sizeIn;
-        FFTSizeLog2 = mProcessor.calc_fft_size_log2(calcSize);
-        sizeOut = 1 << FFTSizeLog2;
+        FFTSizeLog2 = processor.calc_fft_size_log2(calcSize);
+        FFTSize = mExact ? calcSize : 1 << FFTSizeLog2;
+        sizeOut = FFTSize;
     }
     else
         sizeOut = 0;
     
     // Sanity Check
     
-    if (sizeOut > mProcessor.max_fft_size())
+    if (sizeOut > processor.max_fft_size())
         sizeOut = 0;
     
     // Calculate output size
@@ -104,57 +126,117 @@ void FrameLib_iFFT::process()
     // Setup output and temporary memory
     
     double *outputR = getOutput(0, &sizeOut);
-    double *outputI = nullptr;
+    double *outputI = mMode == kComplex ? getOutput(1, &sizeOut) : nullptr;
+    
+    FrameLib_PrecisionOutput<T> outR(this, outputR, sizeOut);
+    FrameLib_PrecisionOutput<T> outI(this, outputI, mMode == kComplex ? sizeOut : 0);
     
     if (mMode == kComplex && sizeOut)
     {
-        outputI = getOutput(1, &sizeOut);
-        
-        spectrum.realp = outputR;
-        spectrum.imagp = outputI;
+        spectrum.realp = outR.get();
+        spectrum.imagp = outI.get();
         
         spectrumSize = sizeOut;
     }
+    else if (mExact)
+    {
+        // Exact real transforms use unpacked spectra
+        
+        spectrumSize = sizeOut ? (sizeOut >> 1) + 1 : 0;
+        
+        spectrum.realp = alloc<T>(spectrumSize * 2 * sizeof(T));
+        spectrum.imagp = spectrum.realp + spectrumSize;
+    }
     else
     {
-        spectrum.realp = alloc<double>(sizeOut ? sizeOut * sizeof(double) : 0);
+        spectrum.realp = alloc<T>(sizeOut ? sizeOut * sizeof(T) : 0);
         spectrum.imagp = spectrum.realp + (sizeOut >> 1);
         
         spectrumSize = sizeOut >> 1;
     }
     
-    if (sizeOut && spectrum.realp)
+    if (sizeOut && (!outR || !outI || !spectrum.realp || !spectrum.imagp))
     {
-        double scale = mNormalise ? 1.0 : 1.0 / static_cast<double>(1 << FFTSizeLog2);
+        outR.zero();
+        outI.zero();
+        if (mMode != kComplex)
+            dealloc(spectrum.realp);
+    }
+    else if (sizeOut && spectrum.realp)
+    {
+        double scale = mNormalise ? 1.0 : 1.0 / static_cast<double>(FFTSize);
         
         // Copy Spectrum
         
         unsigned long copySizeR = std::min(sizeInR, spectrumSize);
         unsigned long copySizeI = std::min(sizeInI, spectrumSize);
         
-        copyVector(spectrum.realp, inputR, copySizeR);
-        zeroVector(spectrum.realp + copySizeR, spectrumSize - copySizeR);
-        copyVector(spectrum.imagp, inputI, copySizeI);
-        zeroVector(spectrum.imagp + copySizeI, spectrumSize - copySizeI);
+        std::copy(inputR, inputR + copySizeR, spectrum.realp);
+        std::fill_n(spectrum.realp + copySizeR, spectrumSize - copySizeR, T(0));
+        std::copy(inputI, inputI + copySizeI, spectrum.imagp);
+        std::fill_n(spectrum.imagp + copySizeI, spectrumSize - copySizeI, T(0));
         
-        if (mMode == kComplex)
+        if (mMode == kComplex && !(FFTSize & 1U) && processor.is_conjugate_symmetric(spectrum, FFTSize))
+        {
+            // The spectrum of a real signal is converted using the real transform (with a zero imaginary output)
+            
+            typename FFTTypes<T>::Split unique;
+            
+            unsigned long uniqueSize = (FFTSize >> 1) + 1;
+            
+            unique.realp = alloc<T>(uniqueSize * 2);
+            unique.imagp = unique.realp + uniqueSize;
+            
+            if (unique.realp)
+            {
+                std::copy(spectrum.realp, spectrum.realp + uniqueSize, unique.realp);
+                std::copy(spectrum.imagp, spectrum.imagp + uniqueSize, unique.imagp);
+                
+                // Pack the Nyquist bin for the power of two transform
+                
+                if (!mExact)
+                    unique.imagp[0] = unique.realp[FFTSize >> 1];
+                
+                if (mExact)
+                    processor.rifft_arbitrary(outR.get(), unique, FFTSize);
+                else
+                    processor.rifft(outR.get(), unique, FFTSizeLog2);
+                processor.scale_vector(outR.get(), sizeOut, static_cast<T>(scale));
+                
+                outI.zero();
+            }
+            else
+            {
+                outR.zero();
+                outI.zero();
+            }
+            
+            dealloc(unique.realp);
+        }
+        else if (mMode == kComplex)
         {
             // Convert to time domain and scale
 
-            mProcessor.ifft(spectrum, FFTSizeLog2);
-            mProcessor.scale_spectrum(spectrum, sizeOut, scale);
+            if (mExact)
+                processor.ifft_arbitrary(spectrum, FFTSize);
+            else
+                processor.ifft(spectrum, FFTSizeLog2);
+            processor.scale_spectrum(spectrum, sizeOut, static_cast<T>(scale));
         }
         else
         {
             // Copy Nyquist Bin
             
-            if (sizeInR >= ((sizeOut >> 1) + 1))
-                spectrum.imagp[0] = inputR[sizeOut >> 1];
+            if (!mExact && sizeInR >= ((sizeOut >> 1) + 1))
+                spectrum.imagp[0] = static_cast<T>(inputR[sizeOut >> 1]);
         
             // Convert to time domain and scale
         
-            mProcessor.rifft(outputR, spectrum, FFTSizeLog2);
-            mProcessor.scale_vector(outputR, sizeOut, scale);
+            if (mExact)
+                processor.rifft_arbitrary(outR.get(), spectrum, FFTSize);
+            else
+                processor.rifft(outR.get(), spectrum, FFTSizeLog2);
+            processor.scale_vector(outR.get(), sizeOut, static_cast<T>(scale));
         
             dealloc(spectrum.realp);
         }
@@ -3,6 +3,7 @@
 #define FRAMELIB_IFFT_H
 
 #include "FrameLib_DSP.h"
+#include "FrameLib_SpectralPrecision.h"
 #include "../../FrameLib_Dependencies/SpectralProcessor.hpp"
 
 // FIX - review FFTSetup
@@ -12,9 +13,12 @@ class FrameLib_iFFT final : public FrameLib_Processor
     // Parameter Enums and Info
 
     enum Mode { kReal, kComplex, kFullSpectrum };
-    enum ParameterList { kMaxLength, kNormalise, kMode };
+    enum ParameterList { kMaxLength, kNormalise, kMode, kExact, kPrecision };
     
     struct ParameterInfo : public FrameLib_Parameters::Info { ParameterInfo(); };
+    
+    template <class T>
+    using Processor = spectral_processor<T, FrameLib_DSP::Allocator>;
 
 public:
 
@@ -33,6 +37,9 @@ private:
     // Process
     
     void process() override;
+    
+    template <class T>
+    void transform(Processor<T>& processor);
 
     // Param Info
     
@@ -42,10 +49,11 @@ private:
     
     Mode mMode;
     bool mNormalise;
+    bool mExact;
     
-    // Processor
+    // Processors (using FFT setups shared with other objects)
     
-    spectral_processor<double, FrameLib_DSP::Allocator> mProcessor;
+    FrameLib_SpectralPrecision<Processor> mProcessor;
 };
 
 #endif
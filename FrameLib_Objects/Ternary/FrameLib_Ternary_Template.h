@@ -137,7 +137,7 @@ private:
         }
         
         requestOutputSize(0,sizeOut);
-        allocateOutputs();
+        allocateOutputsInPlace(sizeIn[0] == sizeOut ? 0 : (sizeIn[1] == sizeOut ? 1 : 2));
         double *output = getOutput(0, &sizeOut);
 
         if (!sizeOut)
@@ -11,7 +11,9 @@ class FrameLib_TimeBuffer : public FrameLib_Processor, private FrameLib_RingBuff
     const int sMaxFrames = 0;
     const int sNumFrames = 1;
     
-    // Parameter Info
+protected:
+    
+    // Parameter Info (derived classes adding parameters may extend this and pass it to the constructor)
 
     struct ParameterInfo : public FrameLib_Parameters::Info
     {
@@ -26,7 +28,7 @@ public:
     
     // Constructor
     
-    FrameLib_TimeBuffer(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 2, 1), FrameLib_RingBuffer(this), mLastNumFrames(0)
+    FrameLib_TimeBuffer(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy, ParameterInfo *info = &sParamInfo) : FrameLib_Processor(context, proxy, info, 2, 1), FrameLib_RingBuffer(this), mLastNumFrames(0)
     {
         mParameters.addInt(sMaxFrames, "max_frames", 10, 0);
         mParameters.setMin(1);
@@ -34,6 +36,8 @@ public:
         mParameters.addInt(sNumFrames, "num_frames", 10, 1);
         mParameters.setMin(1);
         
+        T::addParameters(mParameters);
+        
         mParameters.set(serialisedParameters);
 
         setParameterInput(1);
@@ -41,6 +45,10 @@ public:
     
 protected:
     
+    // Additional Parameters (derived classes may hide this to add parameters before the serialised parameters are read)
+    
+    static void addParameters(FrameLib_Parameters& parameters) {}
+    
     void smoothReset()
     {
         resize(0, 0);
@@ -1,15 +1,23 @@
 
 #include "FrameLib_TimeMedian.h"
 
-FrameLib_TimeMedian::FrameLib_TimeMedian(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_TimeBuffer<FrameLib_TimeMedian>(context, serialisedParameters, proxy), mOrdered(nullptr), mNumFrames(0)
+FrameLib_TimeMedian::FrameLib_TimeMedian(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_TimeBuffer<FrameLib_TimeMedian>(context, serialisedParameters, proxy, &sParamInfo), mOrdered(nullptr), mNumFrames(0), mBlocked(false)
 {}
 
+// Parameters (added by the time buffer before the serialised parameters are read)
+
+void FrameLib_TimeMedian::addParameters(FrameLib_Parameters& parameters)
+{
+    parameters.addDouble(kPercentile, "percentile", 50.0, 2);
+    parameters.setClip(0.0, 100.0);
+}
+
 // Info
 
 std::string FrameLib_TimeMedian::objectInfo(bool verbose)
 {
-    return formatInfo("Outputs the median per sample over a given number of frames: Frames are expected to be of uniform size, otherwise the buffer is reset. The number of frames (as well as the maximum number of frames) can be set as parameters. The output is the same size as the input.",
-                      "Outputs the median per sample over a given number of frames.", verbose);
+    return formatInfo("Outputs the median (or another percentile) per sample over a given number of frames: Frames are expected to be of uniform size, otherwise the buffer is reset. The number of frames (as well as the maximum number of frames) can be set as parameters. The output is the same size as the input.",
+                      "Outputs the median (or another percentile) per sample over a given number of frames.", verbose);
 }
 
 std::string FrameLib_TimeMedian::inputInfo(unsigned long idx, bool verbose)
@@ -25,24 +33,48 @@ std::string FrameLib_TimeMedian::outputInfo(unsigned long idx, bool verbose)
     return "Medians Over Time";
 }
 
+// Parameter Info
+
+FrameLib_TimeMedian::ParameterInfo FrameLib_TimeMedian::sParamInfo;
+
+FrameLib_TimeMedian::ParameterInfo::ParameterInfo()
+{
+    add("Sets the percentile to output [0-100]. "
+        "The output is the value at position (percentile / 100 * number of frames) in the ordered values, so 50 gives the median. "
+        "No interpolation is performed.");
+}
+
 // Update size
 
+// N.B. - for small numbers of frames channels are grouped into blocks of one vector, holding each rank contiguously
+// N.B. - each new or old value is then moved through the block with vector selects rather than searching and copying per channel
+// N.B. - this is O(frames) per channel, but branch free and sequential, so is only used where it is faster than searching
+
 void FrameLib_TimeMedian::resetSize(unsigned long maxFrames, unsigned long size)
 {
+    mBlocked = sBlockSize > 1 && maxFrames <= sMaxBlockedFrames;
+    
+    unsigned long allocSize = (mBlocked ? ((size + sBlockSize - 1) / sBlockSize) * sBlockSize : size) * maxFrames;
+    
     dealloc(mOrdered);
-    mOrdered = alloc<double>(size * maxFrames);
-    zeroVector(mOrdered, size * maxFrames);
+    mOrdered = alloc<double>(allocSize);
+    zeroVector(mOrdered, allocSize);
     mNumFrames = 0;
 }
 
 bool compareLess(double a, double b)
 {
-    return (a < b || (isnan(b) && !isnan(a)));
+    return (a < b || (std::isnan(b) && !std::isnan(a)));
 }
 
 bool compareMore(double a, double b)
 {
-    return (a > b || (isnan(a) && !isnan(b)));
+    return (a > b || (std::isnan(a) && !std::isnan(b)));
+}
+
+static FrameLib_SIMD_Ops::VecType compareLess(const FrameLib_SIMD_Ops::VecType& a, const FrameLib_SIMD_Ops::VecType& b)
+{
+    return sel(a == a, FrameLib_SIMD_Ops::VecType(0.0), b <= a);
 }
 
 unsigned long find(double input, double *channel, unsigned long numFrames)
@@ -87,7 +119,7 @@ bool checkArray(const double *array, unsigned long size)
         {
             for (unsigned long j = 0; j < size; j++)
             {
-                if (isnan(array[j]))
+                if (std::isnan(array[j]))
                     std::cout << "NaN\n";
                 else
                     std::cout << array[j] << "\n";
@@ -101,10 +133,80 @@ bool checkArray(const double *array, unsigned long size)
 }
 */
 
+// Blocked Helpers
+
+FrameLib_TimeMedian::VecType FrameLib_TimeMedian::loadBlock(const double *frame, unsigned long idx, unsigned long size) const
+{
+    double padded[sBlockSize] = {};
+    
+    // N.B. - lanes beyond the end of the frame are always zero
+    
+    if ((idx + 1) * sBlockSize <= size)
+        return VecType(frame + idx * sBlockSize);
+    
+    std::copy(frame + idx * sBlockSize, frame + size, padded);
+    
+    return VecType(padded);
+}
+
+void FrameLib_TimeMedian::addBlocked(const double *newFrame, unsigned long size, unsigned long numFrames)
+{
+    const VecType all = VecType(0.0) == VecType(0.0);
+    
+    for (unsigned long i = 0; i < (size + sBlockSize - 1) / sBlockSize; i++)
+    {
+        // Values below the new value stay in place and values above move up by one rank
+        
+        double *block = getBlock(i);
+        VecType value = loadBlock(newFrame, i, size);
+        VecType previous = value;
+        VecType previousLess = all;
+        
+        for (unsigned long j = 0; j < numFrames; j++)
+        {
+            VecType current(block + j * sBlockSize);
+            VecType currentLess = compareLess(current, value);
+            
+            sel(sel(previous, value, previousLess), current, currentLess).store(block + j * sBlockSize);
+            previous = current;
+            previousLess = currentLess;
+        }
+        
+        sel(previous, value, previousLess).store(block + numFrames * sBlockSize);
+    }
+}
+
+void FrameLib_TimeMedian::removeBlocked(const double *oldFrame, unsigned long size, unsigned long numFrames)
+{
+    for (unsigned long i = 0; i < (size + sBlockSize - 1) / sBlockSize; i++)
+    {
+        // Values below the old value stay in place and values from the old value upwards move down by one rank
+        
+        double *block = getBlock(i);
+        VecType value = loadBlock(oldFrame, i, size);
+        VecType current(block);
+        
+        for (unsigned long j = 0; j + 1 < numFrames; j++)
+        {
+            VecType next(block + (j + 1) * sBlockSize);
+            
+            sel(next, current, compareLess(current, value)).store(block + j * sBlockSize);
+            current = next;
+        }
+    }
+}
+
 // Process
 
 void FrameLib_TimeMedian::exchange(const double *newFrame, const double *oldFrame, unsigned long size)
 {
+    if (mBlocked)
+    {
+        removeBlocked(oldFrame, size, mNumFrames);
+        addBlocked(newFrame, size, mNumFrames - 1);
+        return;
+    }
+    
     for (unsigned long i = 0; i < size; i++)
     {
         // Find insertion points
@@ -135,6 +237,12 @@ void FrameLib_TimeMedian::add(const double *newFrame, unsigned long size)
 {
     assert(mNumFrames < getMaxFrames() && "Number of frames cannot be increased above the maximum");
     
+    if (mBlocked)
+    {
+        addBlocked(newFrame, size, mNumFrames++);
+        return;
+    }
+    
     for (unsigned long i = 0; i < size; i++)
     {
         // Find insertion point
@@ -158,6 +266,12 @@ void FrameLib_TimeMedian::remove(const double *oldFrame, unsigned long size)
 {
     assert(mNumFrames && "Number of frames cannot be reduced to zero!");
     
+    if (mBlocked)
+    {
+        removeBlocked(oldFrame, size, mNumFrames--);
+        return;
+    }
+    
     for (unsigned long i = 0; i < size; i++)
     {
         // Find removal point
@@ -178,6 +292,17 @@ void FrameLib_TimeMedian::remove(const double *oldFrame, unsigned long size)
 
 void FrameLib_TimeMedian::result(double *output, unsigned long size)
 {
-    for (unsigned long i = 0; i < size; i++)
-        output[i] = getChannel(i)[mNumFrames >> 1];
+    double percentile = mParameters.getValue(kPercentile);
+    unsigned long rank = std::min(mNumFrames - 1, truncToUInt(percentile * mNumFrames / 100.0));
+    
+    if (mBlocked)
+    {
+        for (unsigned long i = 0; i < size; i++)
+            output[i] = getBlock(i / sBlockSize)[rank * sBlockSize + (i % sBlockSize)];
+    }
+    else
+    {
+        for (unsigned long i = 0; i < size; i++)
+            output[i] = getChannel(i)[rank];
+    }
 }
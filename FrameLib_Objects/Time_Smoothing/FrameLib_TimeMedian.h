@@ -3,10 +3,25 @@
 #define FRAMELIB_TIMEMEDIAN_H
 
 #include "FrameLib_TimeBuffer_Template.h"
+#include "FrameLib_SIMD_Ops.h"
 
 class FrameLib_TimeMedian final : public FrameLib_TimeBuffer<FrameLib_TimeMedian>
 {
-   
+    friend class FrameLib_TimeBuffer<FrameLib_TimeMedian>;
+    
+    // Parameter Enums and Info (following the time buffer parameters)
+    
+    enum ParameterList { kPercentile = 2 };
+    
+    struct ParameterInfo : public FrameLib_TimeBuffer<FrameLib_TimeMedian>::ParameterInfo { ParameterInfo(); };
+    
+    // Blocked Layout
+    
+    typedef FrameLib_SIMD_Ops::VecType VecType;
+    
+    static const unsigned long sBlockSize = FrameLib_SIMD_Ops::vecSize;
+    static const unsigned long sMaxBlockedFrames = 48 * sBlockSize;
+
 public:
     
     // Constructor
@@ -30,13 +45,23 @@ public:
 
 private:
 
+    static void addParameters(FrameLib_Parameters& parameters);
+    
     double *getChannel(unsigned long idx) const { return mOrdered + (idx * getMaxFrames()); }
+    double *getBlock(unsigned long idx) const   { return mOrdered + (idx * getMaxFrames() * sBlockSize); }
 
     void add(const double *newFrame, unsigned long size) override;
     void remove(const double *oldFrame, unsigned long size) override;
     void exchange(const double *newFrame, const double *oldFrame, unsigned long size) override;
     void result(double *output, unsigned long size) override;
     
+    // Blocked Helpers
+    
+    VecType loadBlock(const double *frame, unsigned long idx, unsigned long size) const;
+    
+    void addBlocked(const double *newFrame, unsigned long size, unsigned long numFrames);
+    void removeBlocked(const double *oldFrame, unsigned long size, unsigned long numFrames);
+    
     // Object Reset
     
     void objectReset() override { smoothReset(); }
@@ -45,6 +70,9 @@ private:
         
     double *mOrdered;
     unsigned long mNumFrames;
+    bool mBlocked;
+    
+    static ParameterInfo sParamInfo;
 };
 
 #endif
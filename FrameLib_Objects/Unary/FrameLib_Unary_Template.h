@@ -3,8 +3,7 @@
 #define FRAMELIB_UNARY_TEMPLATE_H
 
 #include "FrameLib_DSP.h"
-
-// OPT - vectorise where appropriate
+#include "FrameLib_SIMD_Ops.h"
 
 // Unary (Operator Version)
 
@@ -34,17 +33,15 @@ private:
     
     void process() override
     {
-        Op op;
         unsigned long size;
         const double *input = getInput(0, &size);
         
         requestOutputSize(0, size);
-        allocateOutputs();
+        allocateOutputsInPlace(0);
 
         double *output = getOutput(0, &size);
         
-        for (unsigned long i = 0; i < size; i++)
-            output[i] = op(input[i]);
+        FrameLib_SIMD_Ops::unary<Op>(output, input, size);
     }
     
     // Description (specialise to change description)
@@ -65,4 +62,12 @@ struct Unary_Functor
 template<double func(double)>
 using FrameLib_Unary = FrameLib_UnaryOp<Unary_Functor<func>>;
 
+// Vector Versions of Functions
+
+namespace FrameLib_SIMD_Ops
+{
+    template<double func(double)>
+    struct Vector<Unary_Functor<func>> : UnaryFunction<func> {};
+}
+
 #endif
@@ -0,0 +1,342 @@
+
+#include "FrameLib_Descriptors.h"
+#include "FrameLib_SIMD_Ops.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Constructor
+
+FrameLib_Descriptors::FrameLib_Descriptors(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo)
+{
+    const int strBufSize = 32;
+    
+    char argStr[strBufSize];
+    char nameStr[strBufSize];
+    
+    mParameters.addInt(kNumDescriptors, "num_descriptors", 1);
+    mParameters.setClip(1, maxNumDescriptors);
+    mParameters.setInstantiation();
+    
+    mParameters.addEnum(kMode, "mode");
+    mParameters.addEnumItem(kSeparate, "separate");
+    mParameters.addEnumItem(kPacked, "packed");
+    mParameters.setInstantiation();
+    
+    // Read in once to get number of descriptors needed
+    
+    mParameters.setErrorReportingEnabled(false);
+    mParameters.set(serialisedParameters);
+    mParameters.setErrorReportingEnabled(true);
+    
+    // If no number of descriptors is specified explicity then examine the serialised parameters to determine the number needed
+    
+    if (serialisedParameters && !mParameters.changed(kNumDescriptors))
+    {
+        for (int i = 0; i < maxNumDescriptors; i++)
+        {
+            snprintf(argStr, strBufSize, "%d", i);
+            snprintf(nameStr, strBufSize, "descriptor_%02d", i + 1);
+            if (serialisedParameters->find(argStr) != serialisedParameters->end() || serialisedParameters->find(nameStr) != serialisedParameters->end())
+                mParameters.set(kNumDescriptors, (long) (i + 1));
+        }
+    }
+    
+    // Read number of descriptors and setup parameters
+    
+    mNumDescriptors = mParameters.getInt(kNumDescriptors);
+    
+    for (unsigned long i = 0; i < mNumDescriptors; i++)
+    {
+        snprintf(nameStr, strBufSize, "descriptor_%02lu", i + 1);
+        mParameters.addEnum(kDescriptors + i, nameStr, i);
+        
+        for (int j = 0; j < kNumDescriptorTypes; j++)
+            mParameters.addEnumItem(j, descriptorName(static_cast<Descriptors>(j)));
+        
+        mParameters.setInstantiation();
+    }
+    
+    // Read in again to get the descriptors
+    
+    mParameters.set(serialisedParameters);
+    
+    mMode = static_cast<Modes>(mParameters.getInt(kMode));
+    
+    // Setup IO
+    
+    setIO(1, mMode == kPacked ? 1 : mNumDescriptors);
+}
+
+// Info
+
+std::string FrameLib_Descriptors::objectInfo(bool verbose)
+{
+    return formatInfo("Calculates several descriptors of the input frame at once: "
+                      "Descriptors are set by argument or by the descriptor parameters and may be any of those calculated by the individual vector objects. "
+                      "Sums shared between descriptors are accumulated together in one vectorised pass over the input (with a second pass for the moments about the centroid or mean if requested). "
+                      "In separate mode each descriptor has its own output of a single value. In packed mode there is one output with a value for each descriptor in order. "
+                      "Empty input frames produce empty output frames.",
+                      "Calculates several descriptors of the input frame at once.", verbose);
+}
+
+std::string FrameLib_Descriptors::inputInfo(unsigned long idx, bool verbose)
+{
+    return "Input";
+}
+
+std::string FrameLib_Descriptors::outputInfo(unsigned long idx, bool verbose)
+{
+    if (mMode == kPacked)
+        return "Packed Descriptors";
+    
+    return formatInfo("Descriptor #", "Descriptor #", idx, verbose);
+}
+
+// Parameter Info
+
+FrameLib_Descriptors::ParameterInfo FrameLib_Descriptors::sParamInfo;
+
+FrameLib_Descriptors::ParameterInfo::ParameterInfo()
+{
+    const int strBufSize = 512;
+    char str[strBufSize];
+    
+    add("Sets the number of descriptors.");
+    add("Sets the output mode: "
+        "separate - each descriptor has its own output. "
+        "packed - all descriptors are output in order as a single frame.");
+    
+    for (int i = 0; i < maxNumDescriptors; i++)
+    {
+        snprintf(str, strBufSize, "Sets descriptor %d: "
+                 "centroid / spread / skewness / kurtosis / flatness / rms / crest / mean / standard_deviation / geometric_mean / sum / min / max / length.", i + 1);
+        add(str);
+    }
+}
+
+// Helpers
+
+const char *FrameLib_Descriptors::descriptorName(Descriptors descriptor)
+{
+    switch (descriptor)
+    {
+        case kCentroid:             return "centroid";
+        case kSpread:               return "spread";
+        case kSkewness:             return "skewness";
+        case kKurtosis:             return "kurtosis";
+        case kFlatness:             return "flatness";
+        case kRMS:                  return "rms";
+        case kCrest:                return "crest";
+        case kMean:                 return "mean";
+        case kStandardDeviation:    return "standard_deviation";
+        case kGeometricMean:        return "geometric_mean";
+        case kSum:                  return "sum";
+        case kMin:                  return "min";
+        case kMax:                  return "max";
+        case kLength:               return "length";
+        default:                    return "";
+    }
+}
+
+bool FrameLib_Descriptors::requested(Descriptors descriptor) const
+{
+    for (unsigned long i = 0; i < mNumDescriptors; i++)
+        if (getDescriptor(i) == descriptor)
+            return true;
+    
+    return false;
+}
+
+// Accumulation of the moments about the centroid and the squared deviations from the mean
+
+template <class T>
+void accumulateMoments(T& m2, T& m3, T& m4, T& deviation, const T& x, const T& index, const T& centroid, const T& mean)
+{
+    T d = index - centroid;
+    T dx = d * d * x;
+    T e = x - mean;
+    
+    m2 += dx;
+    dx *= d;
+    m3 += dx;
+    m4 += dx * d;
+    deviation += e * e;
+}
+
+// N.B. - the sums match those in Statistics.hpp but the order of summation differs (so results may differ in the last few bits)
+
+void FrameLib_Descriptors::calculateSums(Sums& sums, const double *input, unsigned long size, bool logs, bool moments, bool deviations) const
+{
+    using VecType = FrameLib_SIMD_Ops::VecType;
+    using ScalarType = FrameLib_SIMD_Ops::ScalarType;
+    
+    const unsigned long vecSize = FrameLib_SIMD_Ops::vecSize;
+    const unsigned long vecEnd = (size / vecSize) * vecSize;
+    
+    double indices[vecSize];
+    double values[vecSize];
+    
+    auto horizontalSum = [&](const VecType& a) -> double
+    {
+        a.store(values);
+        
+        double sum = 0.0;
+        
+        for (unsigned long i = 0; i < vecSize; i++)
+            sum += values[i];
+        
+        return sum;
+    };
+    
+    for (unsigned long i = 0; i < vecSize; i++)
+        indices[i] = static_cast<double>(i);
+    
+    const VecType step(static_cast<double>(vecSize));
+    
+    // Sums, weighted sum, sum of squares and extrema
+    
+    {
+        VecType sum(0.0), weightedSum(0.0), sumSquares(0.0);
+        VecType lo(std::numeric_limits<double>::infinity());
+        VecType hi(-std::numeric_limits<double>::infinity());
+        VecType index(indices);
+        
+        for (unsigned long i = 0; i < vecEnd; i += vecSize)
+        {
+            VecType x(input + i);
+            
+            sum += x;
+            weightedSum += index * x;
+            sumSquares += x * x;
+            lo = min(lo, x);
+            hi = max(hi, x);
+            index += step;
+        }
+        
+        sums.mSum = horizontalSum(sum);
+        sums.mWeightedSum = horizontalSum(weightedSum);
+        sums.mSumSquares = horizontalSum(sumSquares);
+        
+        lo.store(values);
+        sums.mMin = *std::min_element(values, values + vecSize);
+        hi.store(values);
+        sums.mMax = *std::max_element(values, values + vecSize);
+        
+        for (unsigned long i = vecEnd; i < size; i++)
+        {
+            double x = input[i];
+            
+            sums.mSum += x;
+            sums.mWeightedSum += static_cast<double>(i) * x;
+            sums.mSumSquares += x * x;
+            sums.mMin = std::min(sums.mMin, x);
+            sums.mMax = std::max(sums.mMax, x);
+        }
+    }
+    
+    // Sum of logs (there is no exact vector log)
+    
+    sums.mSumLogs = 0.0;
+    
+    if (logs)
+    {
+        for (unsigned long i = 0; i < size; i++)
+            sums.mSumLogs += log(input[i]);
+    }
+    
+    // Moments about the centroid and the mean (these require the first pass)
+    
+    std::fill_n(sums.mCentralMoments, 3, 0.0);
+    sums.mSumSquaredDeviations = 0.0;
+    
+    if (moments || deviations)
+    {
+        const double centroid = sums.mWeightedSum / sums.mSum;
+        const double mean = sums.mSum / static_cast<double>(size);
+        
+        VecType m2(0.0), m3(0.0), m4(0.0), deviation(0.0);
+        VecType index(indices);
+        
+        for (unsigned long i = 0; i < vecEnd; i += vecSize)
+        {
+            accumulateMoments(m2, m3, m4, deviation, VecType(input + i), index, VecType(centroid), VecType(mean));
+            index += step;
+        }
+        
+        ScalarType s2(horizontalSum(m2)), s3(horizontalSum(m3)), s4(horizontalSum(m4)), sDeviation(horizontalSum(deviation));
+        
+        for (unsigned long i = vecEnd; i < size; i++)
+            accumulateMoments(s2, s3, s4, sDeviation, ScalarType(input[i]), ScalarType(static_cast<double>(i)), ScalarType(centroid), ScalarType(mean));
+        
+        sums.mCentralMoments[0] = s2.mVal;
+        sums.mCentralMoments[1] = s3.mVal;
+        sums.mCentralMoments[2] = s4.mVal;
+        sums.mSumSquaredDeviations = sDeviation.mVal;
+    }
+}
+
+double FrameLib_Descriptors::calculateDescriptor(Descriptors descriptor, const Sums& sums, unsigned long size) const
+{
+    const double length = static_cast<double>(size);
+    
+    auto spread = [&]() { return sums.mCentralMoments[0] / sums.mSum; };
+    auto rms = [&]() { return sqrt(sums.mSumSquares / length); };
+    
+    switch (descriptor)
+    {
+        case kCentroid:             return sums.mWeightedSum / sums.mSum;
+        case kSpread:               return spread();
+        case kSkewness:             return sums.mCentralMoments[1] / (pow(sqrt(spread()), 3.0) * sums.mSum);
+        case kKurtosis:             return sums.mCentralMoments[2] / (spread() * spread() * sums.mSum);
+        case kFlatness:             return exp(sums.mSumLogs / length) / (sums.mSum / length);
+        case kRMS:                  return rms();
+        case kCrest:                return sums.mMax / rms();
+        case kMean:                 return sums.mSum / length;
+        case kStandardDeviation:    return sqrt(sums.mSumSquaredDeviations / length);
+        case kGeometricMean:        return exp(sums.mSumLogs / length);
+        case kSum:                  return sums.mSum;
+        case kMin:                  return sums.mMin;
+        case kMax:                  return sums.mMax;
+        case kLength:               return length;
+        default:                    return 0.0;
+    }
+}
+
+// Process
+
+void FrameLib_Descriptors::process()
+{
+    unsigned long sizeIn, sizeOut;
+    const double *input = getInput(0, &sizeIn);
+    
+    if (mMode == kPacked)
+        requestOutputSize(0, sizeIn ? mNumDescriptors : 0);
+    else
+    {
+        for (unsigned long i = 0; i < mNumDescriptors; i++)
+            requestOutputSize(i, sizeIn ? 1 : 0);
+    }
+    
+    if (!allocateOutputs() || !sizeIn)
+        return;
+    
+    // Calculate the shared sums once for all descriptors
+    
+    Sums sums;
+    
+    bool logs = requested(kFlatness) || requested(kGeometricMean);
+    bool moments = requested(kSpread) || requested(kSkewness) || requested(kKurtosis);
+    bool deviations = requested(kStandardDeviation);
+    
+    calculateSums(sums, input, sizeIn, logs, moments, deviations);
+    
+    // Output
+    
+    for (unsigned long i = 0; i < mNumDescriptors; i++)
+    {
+        double *output = getOutput(mMode == kPacked ? 0 : i, &sizeOut);
+        output[mMode == kPacked ? i : 0] = calculateDescriptor(getDescriptor(i), sums, sizeIn);
+    }
+}
@@ -0,0 +1,70 @@
+
+#ifndef FRAMELIB_DESCRIPTORS_H
+#define FRAMELIB_DESCRIPTORS_H
+
+#include "FrameLib_DSP.h"
+
+class FrameLib_Descriptors final : public FrameLib_Processor
+{
+    const static int maxNumDescriptors = 16;
+    
+    // Parameter Enums and Info
+    
+    enum ParameterList { kNumDescriptors, kMode, kDescriptors };
+    enum Modes { kSeparate, kPacked };
+    enum Descriptors { kCentroid, kSpread, kSkewness, kKurtosis, kFlatness, kRMS, kCrest, kMean, kStandardDeviation, kGeometricMean, kSum, kMin, kMax, kLength, kNumDescriptorTypes };
+    
+    struct ParameterInfo : public FrameLib_Parameters::Info { ParameterInfo(); };
+    
+    // Accumulated Sums
+    
+    struct Sums
+    {
+        double mSum;                        /**< sum of values */
+        double mWeightedSum;                /**< sum of values weighted by index */
+        double mSumSquares;                 /**< sum of squared values */
+        double mSumLogs;                    /**< sum of the logs of values */
+        double mMin;
+        double mMax;
+        
+        double mCentralMoments[3];          /**< sums of values weighted by the 2nd to 4th powers of the distance from the centroid */
+        double mSumSquaredDeviations;       /**< sum of squared differences from the mean */
+    };
+
+public:
+    
+    // Constructor
+    
+    FrameLib_Descriptors(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy);
+    
+    // Info
+    
+    std::string objectInfo(bool verbose) override;
+    std::string inputInfo(unsigned long idx, bool verbose) override;
+    std::string outputInfo(unsigned long idx, bool verbose) override;
+
+private:
+    
+    // Helpers
+    
+    static const char *descriptorName(Descriptors descriptor);
+    
+    Descriptors getDescriptor(unsigned long idx) const  { return static_cast<Descriptors>(mParameters.getInt(kDescriptors + idx)); }
+    bool requested(Descriptors descriptor) const;
+    
+    void calculateSums(Sums& sums, const double *input, unsigned long size, bool logs, bool moments, bool deviations) const;
+    double calculateDescriptor(Descriptors descriptor, const Sums& sums, unsigned long size) const;
+    
+    // Process
+    
+    void process() override;
+    
+    // Data
+    
+    unsigned long mNumDescriptors;
+    Modes mMode;
+    
+    static ParameterInfo sParamInfo;
+};
+
+#endif
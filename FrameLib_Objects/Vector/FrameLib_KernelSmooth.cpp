@@ -3,12 +3,17 @@
 
 // Constructor
 
-FrameLib_KernelSmooth::FrameLib_KernelSmooth(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 2, 1), mSmoother(*this)
+FrameLib_KernelSmooth::FrameLib_KernelSmooth(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 2, 1), mSmoother(context, this)
 {
     mParameters.addVariableDoubleArray(kSmooth, "smooth", 0.0, 2, 0);
     mParameters.setMin(0.0);
+    addPrecisionParameter(mParameters, kPrecision);
     
     mParameters.set(serialisedParameters);
+    
+    // Use a shared setup at the default maximum size of the smoother
+    
+    mSmoother.setPrecision(static_cast<FrameLib_Precision>(mParameters.getInt(kPrecision)), 18);
 }
 
 // Info
@@ -38,11 +43,21 @@ FrameLib_KernelSmooth::ParameterInfo FrameLib_KernelSmooth::sParamInfo;
 FrameLib_KernelSmooth::ParameterInfo::ParameterInfo()
 {
     add("Set the amount of smoothing." );
+    add("Sets the precision used internally. Single precision is faster but less accurate (frames are converted at the input and output).");
 }
 
 // Process
 
 void FrameLib_KernelSmooth::process()
+{
+    if (mSmoother.getPrecision() == kPrecisionSingle)
+        smooth(mSmoother.getSingle());
+    else
+        smooth(mSmoother.getDouble());
+}
+
+template <class T>
+void FrameLib_KernelSmooth::smooth(Smoother<T>& smoother)
 {
     unsigned long sizeIn1, sizeIn2, sizeOut;
     const double *input = getInput(0, &sizeIn1);
@@ -82,6 +97,13 @@ void FrameLib_KernelSmooth::process()
             
         }
         
-        mSmoother.smooth(output, input, kernel, sizeIn1, sizeIn2, width_lo, width_hi, Smoother::kSmoothFold);
+        FrameLib_PrecisionInput<T> in(this, input, sizeIn1);
+        FrameLib_PrecisionInput<T> kernelIn(this, kernel, sizeIn2);
+        FrameLib_PrecisionOutput<T> out(this, output, sizeOut);
+        
+        if (in && kernelIn && out)
+            smoother.smooth(out.get(), in.get(), kernelIn.get(), sizeIn1, sizeIn2, width_lo, width_hi, Smoother<T>::kSmoothFold);
+        else
+            out.zero();
     }
 }
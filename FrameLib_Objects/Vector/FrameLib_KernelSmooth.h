@@ -3,13 +3,15 @@
 #define FRAMELIB_KERNELSMOOTH_H
 
 #include "FrameLib_DSP.h"
+#include "FrameLib_SpectralPrecision.h"
 #include "../../FrameLib_Dependencies/KernelSmoother.hpp"
 
 class FrameLib_KernelSmooth final : public FrameLib_Processor
 {
-    using Smoother = kernel_smoother<double, FrameLib_DSP::Allocator>;
+    template <class T>
+    using Smoother = kernel_smoother<T, FrameLib_DSP::Allocator>;
     
-    enum ParameterList { kSmooth };
+    enum ParameterList { kSmooth, kPrecision };
     
     struct ParameterInfo : public FrameLib_Parameters::Info { ParameterInfo(); };
     
@@ -31,11 +33,14 @@ private:
     
     void process() override;
     
+    template <class T>
+    void smooth(Smoother<T>& smoother);
+    
     // Data
     
     static ParameterInfo sParamInfo;
     
-    Smoother mSmoother;
+    FrameLib_SpectralPrecision<Smoother> mSmoother;
 };
 
 #endif
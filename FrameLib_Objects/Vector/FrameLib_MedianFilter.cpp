@@ -1,6 +1,6 @@
 
 #include "FrameLib_MedianFilter.h"
-#include "FrameLib_Sort_Functions.h"
+#include "FrameLib_SlidingRank.h"
 #include <algorithm>
 
 // Constructor
@@ -17,6 +17,9 @@ FrameLib_MedianFilter::FrameLib_MedianFilter(FrameLib_Context context, FrameLib_
     mParameters.addEnumItem(kWrap, "wrap");
     mParameters.addEnumItem(kFold, "fold");
     
+    mParameters.addDouble(kPercentile, "percentile", 50.0);
+    mParameters.setClip(0.0, 100.0);
+    
     mParameters.set(serialisedParameters);
     
     setParameterInput(1);
@@ -28,7 +31,8 @@ std::string FrameLib_MedianFilter::objectInfo(bool verbose)
 {
     return formatInfo("Median filter an input frame: The output is the same size as the input. "
                    "Each output value is the median of the area surrounding the input value. "
-                   "The width of the area, and the edge behaviours are controllable.",
+                   "The width of the area, and the edge behaviours are controllable. "
+                   "Other percentiles of the area may also be output in place of the median.",
                    "Median filter an input frame.", verbose);
 }
 
@@ -57,78 +61,13 @@ FrameLib_MedianFilter::ParameterInfo::ParameterInfo()
         "pad - the edges are treated as though infinitely padded with the padding value. "
         "wrap - the edges are treated as though the frame is wrapped cyclically. "
         "fold - the edges are treated as though they fold over (suitable for spectral purposes).");
+    add("Sets the percentile of the area to output [0-100]. "
+        "The output is the value at position (percentile / 100 * width) in the ordered area, so 50 gives the median. "
+        "No interpolation is performed.");
 }
 
 // Helpers
 
-double FrameLib_MedianFilter::insertMedian(double *temp, unsigned long *indices, double value, long index, long width)
-{
-    long current, insert, gap;
-    
-    // Insert actual value
-    
-    temp[index] = value;
-    
-    // Find sort position
-    
-    current = -10000000;
-    
-    for (long i = 0; i < width; i++)
-    {
-        if (indices[i] == index)
-        {
-            current = i;
-            break;
-        }
-    }
-    
-    // Search right
-    
-    for (insert = current, gap = std::max(1L, (width - current) >> 1); gap; gap >>= 1)
-    {
-        for (long i = insert + gap; i < width; i += gap)
-        {
-            if (temp[indices[i]] >= value)
-                break;
-            else
-                insert = i;
-        }
-    }
-    
-    // Swaps
-    
-    for (long i = current; i < insert; i++)
-        indices[i] = indices[i + 1];
-    indices[insert] = index;
-    
-    // Search left
-    
-    for (current = insert, gap = std::max(1L, current >> 1); gap; gap >>= 1)
-    {
-        for (long i = insert - gap; i >= 0; i -= gap)
-        {
-            if (temp[indices[i]] <= value)
-                break;
-            else
-                insert = i;
-        }
-    }
-    
-    // Swaps
-    
-    for (long i = current; i > insert; i--)
-        indices[i] = indices[i - 1];
-    indices[insert] = index;
-    
-    return temp[indices[width >> 1]];
-}
-
-double FrameLib_MedianFilter::median(double *temp, unsigned long *indices, long width)
-{
-    sortIndicesAscending(indices, temp, width);
-    return temp[indices[width >> 1]];
-}
-
 double FrameLib_MedianFilter::getPad(const double *input, long index, long sizeIn, double padValue)
 {
     return (index >= 0 && index < sizeIn) ? input[index] : padValue;
@@ -144,6 +83,9 @@ double FrameLib_MedianFilter::getWrap(const  double *input, long index, long siz
 
 double FrameLib_MedianFilter::getFold(const double *input, long index, long sizeIn)
 {
+    if (sizeIn == 1)
+        return input[0];
+    
     index = std::abs(index) % ((sizeIn - 1) * 2);
     index = index > (sizeIn - 1) ? ((sizeIn - 1) * 2) - index : index;
     
@@ -160,54 +102,43 @@ void FrameLib_MedianFilter::process()
     long width = mParameters.getInt(kWidth);
     const double *input = getInput(0, &sizeIn);
     double padValue = mParameters.getValue(kPadding);
+    double percentile = mParameters.getValue(kPercentile);
     Modes mode = static_cast<Modes>(mParameters.getInt(kMode));
     
     requestOutputSize(0, sizeIn);
     allocateOutputs();
     
-    double *output = getOutput(0, &sizeOut);    
-    double *temp = alloc<double>(width);
-    unsigned long *indices = alloc<unsigned long>(width);
-    
-    // Do filtering
+    double *output = getOutput(0, &sizeOut);
+    double *temp = alloc<double>(width * 2);
+    unsigned long *indices = alloc<unsigned long>(width * 2);
     
-    if (sizeOut)
+    auto getValue = [&](long index)
     {
         switch (mode)
         {
-            case kWrap:
-                for (long i = 0; i < width; i++)
-                    temp[i] = getWrap(input, i - (width >> 1), sizeIn);
-                output[0] = median(temp, indices, width);
-                for (long i = 1; i < static_cast<long>(sizeIn); i++)
-                {
-                    double newValue = getWrap(input, i + (width >> 1), sizeIn);
-                    output[i] = insertMedian(temp, indices, newValue, (i - 1) % width, width);
-                }
-                break;
-                
-            case kPad:
-                for (long i = 0; i < width; i++)
-                    temp[i] = getPad(input, i - (width >> 1), sizeIn, padValue);
-                output[0] = median(temp, indices, width);
-                for (long i = 1; i < static_cast<long>(sizeIn); i++)
-                {
-                    double newValue = getPad(input, i + (width >> 1), sizeIn, padValue);
-                    output[i] = insertMedian(temp, indices, newValue, (i - 1) % width, width);
-                }
-                break;
-                
-            case kFold:
-                for (long i = 0; i < width; i++)
-                    temp[i] = getFold(input, i - (width >> 1), sizeIn);
-                output[0] = median(temp, indices, width);
-                for (long i = 1; i < static_cast<long>(sizeIn); i++)
-                {
-                    double newValue = getFold(input, i + (width >> 1), sizeIn);
-                    output[i] = insertMedian(temp, indices, newValue, (i - 1) % width, width);
-                }
-                break;
+            case kWrap:     return getWrap(input, index, sizeIn);
+            case kFold:     return getFold(input, index, sizeIn);
+            default:        return getPad(input, index, sizeIn, padValue);
         }
+    };
+    
+    // Do filtering
+    
+    if (sizeOut && temp && indices)
+    {
+        FrameLib_SlidingRank window(temp + width, indices, width, truncToUInt(percentile * width / 100.0));
+        long offset = width >> 1;
+        
+        // The window for output i covers the input from i - offset to i - offset + width - 1
+        
+        for (long i = 0; i < width; i++)
+            temp[i] = getValue(i - offset);
+        
+        window.reset(temp);
+        output[0] = window.rankValue();
+        
+        for (long i = 1; i < static_cast<long>(sizeIn); i++)
+            output[i] = window.replace((i - 1) % width, getValue(i - offset + width - 1));
     }
     
     dealloc(temp);
@@ -8,7 +8,7 @@ class FrameLib_MedianFilter final : public FrameLib_Processor
 {
     // Parameter Enums and Info
 
-    enum ParameterList { kWidth, kPadding, kMode };
+    enum ParameterList { kWidth, kPadding, kMode, kPercentile };
     enum Modes { kPad, kWrap, kFold };
     
     struct ParameterInfo : public FrameLib_Parameters::Info { ParameterInfo(); };
@@ -29,9 +29,6 @@ private:
     
     // Helpers
     
-    double insertMedian(double *temp, unsigned long *indices, double value, long index, long width);
-    double median(double *temp, unsigned long *indices, long width);
-    
     double getPad(const double *input, long index, long sizeIn, double padValue);
     double getWrap(const double *input, long index, long sizeIn);
     double getFold(const double *input, long index, long sizeIn);
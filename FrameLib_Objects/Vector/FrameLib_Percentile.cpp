@@ -6,7 +6,7 @@
 
 FrameLib_Percentile::FrameLib_Percentile(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy) : FrameLib_Processor(context, proxy, &sParamInfo, 2, 1)
 {
-    mParameters.addDouble(kPercentile, "percentile", 50.0, 0);
+    mParameters.addVariableDoubleArray(kPercentile, "percentile", 50.0, 256, 1, 0);
     mParameters.setClip(0.0, 100.0);
     
     mParameters.set(serialisedParameters);
@@ -18,8 +18,11 @@ FrameLib_Percentile::FrameLib_Percentile(FrameLib_Context context, FrameLib_Para
 
 std::string FrameLib_Percentile::objectInfo(bool verbose)
 {
-    return formatInfo("Calculates any percentile (for example the median at 50%) of an input frame: The output is a single value.",
-                   "Calculates any percentile (for example the median at 50%) of an input frame.", verbose);
+    return formatInfo("Calculates one or more percentiles (for example the median at 50%) of an input frame: "
+                   "The output has one value per requested percentile, in the order requested. "
+                   "Values are found by selection rather than sorting, so several percentiles cost little more than one. "
+                   "NaNs are treated as larger than all other values.",
+                   "Calculates one or more percentiles (for example the median at 50%) of an input frame.", verbose);
 }
 
 std::string FrameLib_Percentile::inputInfo(unsigned long idx, bool verbose)
@@ -32,7 +35,7 @@ std::string FrameLib_Percentile::inputInfo(unsigned long idx, bool verbose)
 
 std::string FrameLib_Percentile::outputInfo(unsigned long idx, bool verbose)
 {
-    return "Percentile Output Value";
+    return "Percentile Output Values";
 }
 
 // Parameter Info
@@ -41,38 +44,61 @@ FrameLib_Percentile::ParameterInfo FrameLib_Percentile::sParamInfo;
 
 FrameLib_Percentile::ParameterInfo::ParameterInfo()
 {
-    add("Sets the percentile to calculate [0-100].");
+    add("Sets the percentile(s) to calculate [0-100]. "
+        "If several are given the output has one value for each.");
 }
 
 // Process
 
 void FrameLib_Percentile::process()
 {
-    unsigned long sizeIn, sizeOut;
+    unsigned long sizeIn, sizeOut, numPercentiles;
     const double *input = getInput(0, &sizeIn);
+    const double *percentiles = mParameters.getArray(kPercentile, &numPercentiles);
     
-    requestOutputSize(0, sizeIn ? 1 : 0);
+    requestOutputSize(0, sizeIn ? numPercentiles : 0);
     allocateOutputs();
     
     double *output = getOutput(0, &sizeOut);
-    double *temp = alloc<double>(sizeIn + 1);
+    double *temp = alloc<double>(sizeIn);
+    unsigned long *order = alloc<unsigned long>(sizeOut * 2);
     
-    if (sizeOut && temp)
+    if (sizeOut && temp && order)
     {
-        sortAscending(temp, input, sizeIn);
+        unsigned long *positions = order + sizeOut;
+        auto position = [&](unsigned long i) { return percentiles[order[i]] * (sizeIn - 1) / 100.0; };
         
-        // Copy last value
+        copyVector(temp, input, sizeIn);
         
-        temp[sizeIn] = temp[sizeIn - 1];
+        // Select the lower position for each percentile (in ascending order)
         
-        // Linearly interpolate output
+        sortIndicesAscending(order, percentiles, sizeOut);
         
-        double position = (mParameters.getValue(kPercentile) * (sizeIn - 1) / 100.0);
-        unsigned long idx = truncToUInt(position);
-        double fract = position - idx;
+        for (unsigned long i = 0; i < sizeOut; i++)
+            positions[i] = truncToUInt(position(i));
         
-        output[0] = temp[idx] + fract * (temp[idx + 1] - temp[idx]);
+        selectAscending(temp, sizeIn, positions, sizeOut);
+        
+        for (unsigned long i = 0; i < sizeOut; i++)
+        {
+            unsigned long idx = positions[i];
+            double fract = position(i) - idx;
+            
+            // The next value is the smallest value above the position (up to the next selected position)
+            
+            const unsigned long *above = std::upper_bound(positions + i, positions + sizeOut, idx);
+            unsigned long end = (above != positions + sizeOut) ? *above : sizeIn - 1;
+            double next = temp[std::min(idx + 1, sizeIn - 1)];
+            
+            for (unsigned long j = idx + 2; j <= end && j < sizeIn; j++)
+                next = temp[j] < next ? temp[j] : next;
+            
+            // Linearly interpolate output
+            
+            output[order[i]] = temp[idx] + fract * (next - temp[idx]);
+        }
     }
     
     dealloc(temp);
+    dealloc(order);
 }
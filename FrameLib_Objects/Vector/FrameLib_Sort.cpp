@@ -21,7 +21,9 @@ FrameLib_Sort::FrameLib_Sort(FrameLib_Context context, FrameLib_Parameters::Seri
 
 std::string FrameLib_Sort::objectInfo(bool verbose)
 {
-    return formatInfo("Sorts an input frame in ascending or descending order.",
+    return formatInfo("Sorts an input frame in ascending or descending order: "
+                   "NaNs are placed after all other values in ascending order and before them in descending order. "
+                   "When indices are output the sort is stable so that the indices of equal values remain in ascending order.",
                    "Sorts an input frame in ascending or descending order.", verbose);
 }
 
@@ -59,24 +61,30 @@ void FrameLib_Sort::process()
     
     double *output = getOutput(0, &size);
     
+    // N.B. temporary memory allows large frames to be radix sorted (the sorts fall back to introsort without it)
+    
     if (!mParameters.getBool(kOutputIndices))
     {
+        double *temp = alloc<double>(sortTempSize<double>(size));
+        
         switch (static_cast<Orders>(mParameters.getInt(kOrder)))
         {
-            case kUp:       sortAscending(output, input, size);     break;
-            case kDown:     sortDescending(output, input, size);    break;
+            case kUp:       sortAscending(output, input, size, temp);     break;
+            case kDown:     sortDescending(output, input, size, temp);    break;
         }
+        
+        dealloc(temp);
     }
     else
     {
-        unsigned long *indices = alloc<unsigned long>(size);
+        unsigned long *indices = alloc<unsigned long>(size + sortIndicesTempSize<double>(size));
         
         if (indices)
         {
             switch (static_cast<Orders>(mParameters.getInt(kOrder)))
             {
-                case kUp:       sortIndicesAscending(indices, input, size);     break;
-                case kDown:     sortIndicesDescending(indices, input, size);    break;
+                case kUp:       sortIndicesAscending(indices, input, size, indices + size);     break;
+                case kDown:     sortIndicesDescending(indices, input, size, indices + size);    break;
             }
             
             for (unsigned long i = 0; i < size; i++)
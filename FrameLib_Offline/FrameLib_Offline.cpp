@@ -0,0 +1,327 @@
+
+#include "FrameLib_OfflineGraph.h"
+#include "FrameLib_OfflineAudio.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+// Error Reporting
+
+struct OfflineNotifier : public FrameLib_ErrorReporter::HostNotifier
+{
+    OfflineNotifier() : mNumErrors(0) {}
+    
+    bool notify(const FrameLib_ErrorReporter::ErrorReport& report) override
+    {
+        FrameLib_OfflineGraph::ObjectProxy *proxy = dynamic_cast<FrameLib_OfflineGraph::ObjectProxy *>(report.getReporter());
+        std::string text;
+        
+        report.getErrorText(text);
+        
+        if (proxy)
+            fprintf(stderr, "error (object %lu): %s\n", proxy->mIndex, text.c_str());
+        else
+            fprintf(stderr, "error: %s\n", text.c_str());
+        
+        mNumErrors++;
+        return true;
+    }
+    
+    unsigned long mNumErrors;
+};
+
+// Options
+
+struct Options
+{
+    Options() : mInput("silence"), mDuration(0.0), mSamplingRate(0.0), mBlockSize(64), mNumThreads(1), mBudget(0.0), mPolicy(FrameLib_ProcessingQueue::kDeadlineDrop) {}
+    
+    std::string mGraph;
+    std::string mInput;
+    std::string mOutput;
+    std::string mProfile;
+    std::string mTrace;
+    double mDuration;
+    double mSamplingRate;
+    unsigned long mBlockSize;
+    unsigned long mNumThreads;
+    double mBudget;
+    FrameLib_ProcessingQueue::DeadlinePolicy mPolicy;
+    std::vector<unsigned long> mLowPriority;
+};
+
+void usage()
+{
+    fprintf(stderr,
+            "usage: framelib_offline <graph.flgraph> [options]\n\n"
+            "  -i <input>     a WAV file, or silence / noise / sine[:hz] / impulse[:hz] (default silence)\n"
+            "  -o <output>    write the audio outputs to a 32 bit float WAV file\n"
+            "  -d <seconds>   duration to render (default the input length, or 10 seconds)\n"
+            "  -r <hz>        sampling rate (default the input rate, or 44100)\n"
+            "  -b <samples>   block size (default 64)\n"
+            "  -t <threads>   number of processing threads (default 1)\n"
+            "  -u <us>        processing budget per block in microseconds (default 0 - no deadline)\n"
+            "  -m <policy>    action when over budget: drop / defer / degrade (default drop)\n"
+            "  -l <object>    mark a scheduler (by index) as low priority so its frames may be dropped\n"
+            "  -p <file>      write per-object profiling as JSON (requires FRAMELIB_PROFILING)\n"
+            "  -c <file>      write a Chrome trace of processing events (requires FRAMELIB_PROFILING)\n");
+}
+
+bool parseOptions(Options& options, int argc, const char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+        
+        if (arg[0] != '-')
+        {
+            if (!options.mGraph.empty())
+                return false;
+            
+            options.mGraph = arg;
+            continue;
+        }
+        
+        if (arg.size() != 2 || ++i == argc)
+            return false;
+        
+        switch (arg[1])
+        {
+            case 'i':   options.mInput = argv[i];                           break;
+            case 'o':   options.mOutput = argv[i];                          break;
+            case 'd':   options.mDuration = atof(argv[i]);                  break;
+            case 'r':   options.mSamplingRate = atof(argv[i]);              break;
+            case 'b':   options.mBlockSize = strtoul(argv[i], nullptr, 10); break;
+            case 't':   options.mNumThreads = strtoul(argv[i], nullptr, 10); break;
+            case 'u':   options.mBudget = atof(argv[i]);                    break;
+            case 'l':   options.mLowPriority.push_back(strtoul(argv[i], nullptr, 10));  break;
+            case 'm':
+                if (!strcmp(argv[i], "drop"))
+                    options.mPolicy = FrameLib_ProcessingQueue::kDeadlineDrop;
+                else if (!strcmp(argv[i], "defer"))
+                    options.mPolicy = FrameLib_ProcessingQueue::kDeadlineDefer;
+                else if (!strcmp(argv[i], "degrade"))
+                    options.mPolicy = FrameLib_ProcessingQueue::kDeadlineDegrade;
+                else
+                    return false;
+                break;
+            case 'p':   options.mProfile = argv[i];                         break;
+            case 'c':   options.mTrace = argv[i];                           break;
+            default:    return false;
+        }
+    }
+    
+    return !options.mGraph.empty() && options.mBlockSize > 0 && options.mNumThreads > 0;
+}
+
+// Profiling
+
+static const unsigned long sTraceCapacity = 1 << 20;
+
+void reportProfile(FrameLib_OfflineGraph& graph, const Options& options)
+{
+    std::vector<FrameLib_Profiler::Record> records;
+    std::vector<FrameLib_Profiler::TraceEvent> events;
+    
+    if (!FrameLib_Profiler::isEnabled())
+    {
+        if (!options.mProfile.empty() || !options.mTrace.empty())
+            fprintf(stderr, "profiling is not enabled in this build (define FRAMELIB_PROFILING)\n");
+        return;
+    }
+    
+    graph.getProfile(records);
+    graph.getProfileTrace(events);
+    
+    // Print objects in order of processing time
+    
+    std::sort(records.begin(), records.end(), [](const FrameLib_Profiler::Record& a, const FrameLib_Profiler::Record& b)
+    {
+        return a.mProcessTime + a.mUpdateTime > b.mProcessTime + b.mUpdateTime;
+    });
+    
+    printf("\nProfile               calls     frames   process ms    max us  update ms        bytes\n");
+    
+    for (auto it = records.begin(); it != records.end(); it++)
+    {
+        FrameLib_OfflineGraph::ObjectProxy *proxy = dynamic_cast<FrameLib_OfflineGraph::ObjectProxy *>(it->mProxy);
+        
+        printf("  %4ld %14llu %10llu %12.3f %9.1f %10.3f %12llu  %s\n", proxy ? static_cast<long>(proxy->mIndex) : -1L,
+               static_cast<unsigned long long>(it->mCalls), static_cast<unsigned long long>(it->mFrames), it->mProcessTime / 1e6,
+               it->mMaxProcessTime / 1e3, it->mUpdateTime / 1e6, static_cast<unsigned long long>(it->mBytesAllocated), it->mType.c_str());
+    }
+    
+    if (!options.mProfile.empty())
+    {
+        std::ofstream file(options.mProfile);
+        FrameLib_Profiler::writeJSON(file, records);
+    }
+    
+    if (!options.mTrace.empty())
+    {
+        std::ofstream file(options.mTrace);
+        FrameLib_Profiler::writeChromeTrace(file, events);
+    }
+}
+
+// Main
+
+int main(int argc, const char *argv[])
+{
+    using Clock = std::chrono::steady_clock;
+    
+    Options options;
+    OfflineNotifier notifier;
+    FrameLib_OfflineInput input;
+    FrameLib_AudioFile output;
+    std::vector<FrameLib_ObjectDescription> objects;
+    std::string error;
+    
+    if (!parseOptions(options, argc, argv))
+    {
+        usage();
+        return 1;
+    }
+    
+    // Load the graph and input
+    
+    std::ifstream graphFile(options.mGraph);
+    
+    if (!graphFile.is_open() || !readGraph(graphFile, objects))
+    {
+        fprintf(stderr, "couldn't read graph from %s\n", options.mGraph.c_str());
+        return 1;
+    }
+    
+    if (!input.set(options.mInput, error))
+    {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    
+    FrameLib_OfflineGraph graph(&notifier);
+    
+    if (!graph.build(objects, error))
+    {
+        fprintf(stderr, "couldn't build graph: %s\n", error.c_str());
+        return 1;
+    }
+    
+    // Settings
+    
+    double samplingRate = options.mSamplingRate;
+    double duration = options.mDuration;
+    
+    if (samplingRate <= 0.0)
+        samplingRate = input.isFile() ? input.getFileSamplingRate() : 44100.0;
+    if (duration <= 0.0)
+        duration = input.isFile() ? input.getLength() / samplingRate : 10.0;
+    
+    unsigned long blockSize = options.mBlockSize;
+    unsigned long length = static_cast<unsigned long>(round(duration * samplingRate));
+    unsigned long numIns = graph.getNumAudioIns();
+    unsigned long numOuts = graph.getNumAudioOuts();
+    
+    // Buffers
+    
+    std::vector<double> inputBuffer(std::max(numIns, 1UL) * blockSize);
+    std::vector<double> outputBuffer(std::max(numOuts, 1UL) * blockSize);
+    std::vector<double *> ins(std::max(numIns, 1UL));
+    std::vector<double *> outs(std::max(numOuts, 1UL));
+    
+    for (unsigned long i = 0; i < ins.size(); i++)
+        ins[i] = inputBuffer.data() + i * blockSize;
+    for (unsigned long i = 0; i < outs.size(); i++)
+        outs[i] = outputBuffer.data() + i * blockSize;
+    
+    if (!options.mOutput.empty())
+    {
+        output.mSamplingRate = samplingRate;
+        output.mChannels.assign(numOuts, std::vector<double>(length));
+    }
+    
+    // Render
+    
+    graph.setNumThreads(options.mNumThreads);
+    graph.setDeadline(options.mBudget, options.mPolicy);
+    
+    for (auto it = options.mLowPriority.begin(); it != options.mLowPriority.end(); it++)
+    {
+        if (*it < graph.getNumObjects())
+            graph.setLowPriority(*it, true);
+    }
+    
+    graph.setTraceCapacity(options.mTrace.empty() ? 0 : sTraceCapacity);
+    graph.reset(samplingRate, blockSize);
+    
+    std::clock_t cpuStart = std::clock();
+    Clock::time_point wallStart = Clock::now();
+    
+    for (unsigned long position = 0; position < length; position += blockSize)
+    {
+        unsigned long size = std::min(blockSize, length - position);
+        
+        input.read(ins.data(), numIns, size, samplingRate);
+        graph.process(ins.data(), outs.data(), size);
+        
+        for (unsigned long i = 0; i < output.getNumChans(); i++)
+            std::copy_n(outs[i], size, output.mChannels[i].data() + position);
+    }
+    
+    double cpuTime = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    double wallTime = std::chrono::duration<double>(Clock::now() - wallStart).count();
+    
+    if (!options.mOutput.empty() && !output.write(options.mOutput.c_str(), error))
+        fprintf(stderr, "%s\n", error.c_str());
+    
+    // Report
+    
+    unsigned long long numFrames = graph.getNumFrames();
+    FrameLib_LocalAllocator::Statistics localStats = graph.getLocalAllocatorStatistics();
+    FrameLib_GlobalAllocator::CacheStatistics globalStats = graph.getGlobalAllocatorStatistics();
+    FrameLib_FFTSetups::Statistics setupStats = graph.getFFTSetupStatistics();
+    FrameLib_WindowCache::Statistics windowStats = graph.getWindowCacheStatistics();
+    
+    printf("Graph               %lu objects (%lu host updated), %lu audio ins, %lu audio outs\n", graph.getNumObjects(), graph.getNumAudioObjects(), numIns, numOuts);
+    printf("Settings            %.0f Hz, block size %lu, %lu thread(s)\n", samplingRate, blockSize, options.mNumThreads);
+    printf("Rendered            %.3f s of audio\n", length / samplingRate);
+    printf("Wall time           %.3f s (%.2fx realtime)\n", wallTime, wallTime > 0.0 ? (length / samplingRate) / wallTime : 0.0);
+    printf("CPU time            %.3f s\n", cpuTime);
+    printf("Frames              %llu (%.0f frames/sec)\n", numFrames, wallTime > 0.0 ? numFrames / wallTime : 0.0);
+    
+    printf("\nHost updated objects (times include all processing triggered by the object)\n");
+    
+    for (unsigned long i = 0; i < graph.getNumAudioObjects(); i++)
+    {
+        unsigned long index = graph.getAudioObjectIndex(i);
+        double time = graph.getAudioObjectTime(i);
+        
+        printf("  %4lu  %8.3f ms  %5.1f%%  %s\n", index, time * 1000.0, wallTime > 0.0 ? 100.0 * time / wallTime : 0.0, graph.getObjectType(index).c_str());
+    }
+    
+    printf("\nLocal allocator     %llu allocs, %.1f%% local hits, %llu global allocs, %llu global deallocs, %zu bytes retained\n", localStats.mAllocs, localStats.hitRate() * 100.0, localStats.mGlobalAllocs, localStats.mGlobalDeallocs, localStats.mRetainedSize);
+    printf("Global allocator    %llu cache hits, %llu misses (%.1f%% hit rate), %llu flushes, %llu uncached\n", globalStats.mHits, globalStats.mMisses, globalStats.hitRate() * 100.0, globalStats.mFlushes, globalStats.mUncached);
+    printf("FFT setups          %lu shared setup(s), %lu reference(s), %lu created\n", setupStats.mSetups, setupStats.mReferences, setupStats.mCreated);
+    printf("Window tables       %lu shared table(s), %lu reference(s), %lu calculated, %lu hits\n", windowStats.mTables, windowStats.mReferences, windowStats.mCalculated, windowStats.mHits);
+    
+    if (options.mBudget > 0.0)
+    {
+        FrameLib_ProcessingQueue::DeadlineStatistics deadlineStats = graph.getDeadlineStatistics();
+        
+        printf("Deadline            %.1f us budget, %llu blocks, %llu overruns, max %.1f us\n", options.mBudget, deadlineStats.mBlocks, deadlineStats.mOverruns, deadlineStats.mMaxBlockTime);
+        printf("                    %llu frames dropped, %llu deferrals, %llu degraded blocks\n", deadlineStats.mDroppedFrames, deadlineStats.mDeferrals, deadlineStats.mDegradedBlocks);
+    }
+    
+    reportProfile(graph, options);
+    
+    if (notifier.mNumErrors)
+        printf("\n%lu error(s) reported\n", notifier.mNumErrors);
+    
+    return 0;
+}
@@ -0,0 +1,304 @@
+
+#include "FrameLib_OfflineAudio.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+// Byte Utilities (WAV files are little-endian)
+
+static uint32_t readLE(const unsigned char *bytes, int numBytes)
+{
+    uint32_t value = 0;
+    
+    for (int i = numBytes - 1; i >= 0; i--)
+        value = (value << 8) | bytes[i];
+    
+    return value;
+}
+
+static void writeLE(std::ofstream& file, uint32_t value, int numBytes)
+{
+    for (int i = 0; i < numBytes; i++)
+        file.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+}
+
+static double readSample(const unsigned char *bytes, int numBytes, bool isFloat)
+{
+    if (isFloat)
+    {
+        if (numBytes == 4)
+        {
+            uint32_t bits = readLE(bytes, 4);
+            float value;
+            memcpy(&value, &bits, sizeof(float));
+            return value;
+        }
+        
+        uint64_t bits = (static_cast<uint64_t>(readLE(bytes + 4, 4)) << 32) | readLE(bytes, 4);
+        double value;
+        memcpy(&value, &bits, sizeof(double));
+        return value;
+    }
+    
+    // Sign extend integers from the top of a 32 bit word
+    
+    int32_t value = static_cast<int32_t>(readLE(bytes, numBytes) << (32 - numBytes * 8));
+    
+    return value / 2147483648.0;
+}
+
+// Audio File
+
+bool FrameLib_AudioFile::read(const char *path, std::string& error)
+{
+    const uint16_t kFormatPCM = 1;
+    const uint16_t kFormatFloat = 3;
+    const uint16_t kFormatExtensible = 0xFFFE;
+    
+    std::ifstream file(path, std::ios::binary);
+    std::vector<unsigned char> data;
+    unsigned char header[12];
+    unsigned char chunkHeader[8];
+    bool foundFormat = false;
+    
+    uint16_t format = 0;
+    uint16_t numChans = 0;
+    uint16_t bitDepth = 0;
+    uint32_t samplingRate = 0;
+    
+    if (!file.is_open())
+    {
+        error = std::string("couldn't open ") + path;
+        return false;
+    }
+    
+    if (!file.read(reinterpret_cast<char *>(header), 12) || memcmp(header, "RIFF", 4) || memcmp(header + 8, "WAVE", 4))
+    {
+        error = std::string(path) + " is not a WAV file";
+        return false;
+    }
+    
+    // Find the format and data chunks (chunks are padded to even sizes)
+    
+    while (file.read(reinterpret_cast<char *>(chunkHeader), 8))
+    {
+        uint32_t chunkSize = readLE(chunkHeader + 4, 4);
+        
+        if (!memcmp(chunkHeader, "fmt ", 4))
+        {
+            std::vector<unsigned char> chunk(chunkSize + (chunkSize & 1));
+            
+            if (chunkSize < 16 || !file.read(reinterpret_cast<char *>(chunk.data()), chunk.size()))
+                break;
+            
+            format = static_cast<uint16_t>(readLE(&chunk[0], 2));
+            numChans = static_cast<uint16_t>(readLE(&chunk[2], 2));
+            samplingRate = readLE(&chunk[4], 4);
+            bitDepth = static_cast<uint16_t>(readLE(&chunk[14], 2));
+            
+            // The sub-format of extensible files starts with the format code
+            
+            if (format == kFormatExtensible && chunkSize >= 26)
+                format = static_cast<uint16_t>(readLE(&chunk[24], 2));
+            
+            foundFormat = true;
+        }
+        else if (!memcmp(chunkHeader, "data", 4) && foundFormat)
+        {
+            data.resize(chunkSize);
+            file.read(reinterpret_cast<char *>(data.data()), chunkSize);
+            data.resize(static_cast<size_t>(file.gcount()));
+            break;
+        }
+        else
+            file.seekg(chunkSize + (chunkSize & 1), std::ios::cur);
+    }
+    
+    bool isFloat = format == kFormatFloat;
+    bool validPCM = format == kFormatPCM && (bitDepth == 16 || bitDepth == 24 || bitDepth == 32);
+    bool validFloat = isFloat && (bitDepth == 32 || bitDepth == 64);
+    
+    if (!foundFormat || !numChans || !(validPCM || validFloat))
+    {
+        error = std::string(path) + " has an unsupported format";
+        return false;
+    }
+    
+    // Deinterleave
+    
+    int numBytes = bitDepth / 8;
+    size_t length = data.size() / (numBytes * numChans);
+    
+    mSamplingRate = samplingRate;
+    mChannels.assign(numChans, std::vector<double>(length));
+    
+    for (size_t i = 0; i < length; i++)
+        for (uint16_t j = 0; j < numChans; j++)
+            mChannels[j][i] = readSample(&data[(i * numChans + j) * numBytes], numBytes, isFloat);
+    
+    return true;
+}
+
+bool FrameLib_AudioFile::write(const char *path, std::string& error) const
+{
+    const uint16_t kFormatFloat = 3;
+    
+    std::ofstream file(path, std::ios::binary);
+    uint32_t numChans = getNumChans();
+    uint32_t length = getLength();
+    uint32_t dataSize = numChans * length * 4;
+    
+    if (!file.is_open())
+    {
+        error = std::string("couldn't open ") + path + " for writing";
+        return false;
+    }
+    
+    // Header and format chunk
+    
+    file.write("RIFF", 4);
+    writeLE(file, 36 + dataSize, 4);
+    file.write("WAVE", 4);
+    file.write("fmt ", 4);
+    writeLE(file, 16, 4);
+    writeLE(file, kFormatFloat, 2);
+    writeLE(file, numChans, 2);
+    writeLE(file, static_cast<uint32_t>(mSamplingRate), 4);
+    writeLE(file, static_cast<uint32_t>(mSamplingRate) * numChans * 4, 4);
+    writeLE(file, numChans * 4, 2);
+    writeLE(file, 32, 2);
+    
+    // Interleaved data
+    
+    file.write("data", 4);
+    writeLE(file, dataSize, 4);
+    
+    for (uint32_t i = 0; i < length; i++)
+    {
+        for (uint32_t j = 0; j < numChans; j++)
+        {
+            float value = static_cast<float>(mChannels[j][i]);
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(float));
+            writeLE(file, bits, 4);
+        }
+    }
+    
+    file.close();
+    
+    if (file.fail())
+    {
+        error = std::string("couldn't write ") + path;
+        return false;
+    }
+    
+    return true;
+}
+
+// Offline Input
+
+FrameLib_OfflineInput::FrameLib_OfflineInput() : mType(kSilence), mFrequency(0.0), mPhase(0.0), mPosition(0)
+{
+    // Seed the noise identically for every run
+    
+    uint32_t seed[32];
+    uint32_t state = 0x2545F491;
+    
+    for (int i = 0; i < 32; i++)
+        seed[i] = (state = state * 1664525 + 1013904223);
+    
+    mRandom.initSeed(seed);
+}
+
+bool FrameLib_OfflineInput::set(const std::string& input, std::string& error)
+{
+    size_t colon = input.find(':');
+    std::string name = input.substr(0, colon);
+    double frequency = colon == std::string::npos ? 0.0 : strtod(input.c_str() + colon + 1, nullptr);
+    
+    mPhase = 0.0;
+    mPosition = 0;
+    
+    if (name == "silence")
+        mType = kSilence;
+    else if (name == "noise")
+        mType = kNoise;
+    else if (name == "sine")
+    {
+        mType = kSine;
+        mFrequency = frequency > 0.0 ? frequency : 440.0;
+    }
+    else if (name == "impulse")
+    {
+        mType = kImpulse;
+        mFrequency = frequency > 0.0 ? frequency : 1.0;
+    }
+    else
+    {
+        mType = kFile;
+        return mFile.read(input.c_str(), error);
+    }
+    
+    return true;
+}
+
+void FrameLib_OfflineInput::read(double * const *outs, unsigned long numChans, unsigned long blockSize, double samplingRate)
+{
+    if (!numChans)
+        return;
+    
+    double *out = outs[0];
+    
+    switch (mType)
+    {
+        case kSilence:
+            std::fill_n(out, blockSize, 0.0);
+            break;
+        
+        case kNoise:
+            for (unsigned long i = 0; i < blockSize; i++)
+                out[i] = mRandom.randDouble(-1.0, 1.0);
+            break;
+        
+        case kSine:
+            for (unsigned long i = 0; i < blockSize; i++)
+            {
+                out[i] = sin(2.0 * M_PI * mPhase);
+                mPhase += mFrequency / samplingRate;
+                mPhase -= floor(mPhase);
+            }
+            break;
+        
+        case kImpulse:
+            for (unsigned long i = 0; i < blockSize; i++)
+            {
+                out[i] = mPhase < mFrequency / samplingRate ? 1.0 : 0.0;
+                mPhase += mFrequency / samplingRate;
+                mPhase -= floor(mPhase);
+            }
+            break;
+        
+        case kFile:
+            // Each channel reads from the corresponding file channel (wrapping if there are more inputs than file channels)
+            
+            for (unsigned long i = 0; i < numChans; i++)
+            {
+                const std::vector<double>& channel = mFile.mChannels[i % mFile.getNumChans()];
+                unsigned long available = mPosition < channel.size() ? std::min(blockSize, static_cast<unsigned long>(channel.size()) - mPosition) : 0;
+                
+                std::copy_n(channel.data() + mPosition, available, outs[i]);
+                std::fill_n(outs[i] + available, blockSize - available, 0.0);
+            }
+            
+            mPosition += blockSize;
+            return;
+    }
+    
+    // Synthetic signals are identical in all channels
+    
+    for (unsigned long i = 1; i < numChans; i++)
+        std::copy_n(out, blockSize, outs[i]);
+}
@@ -0,0 +1,82 @@
+
+#ifndef FRAMELIB_OFFLINEAUDIO_H
+#define FRAMELIB_OFFLINEAUDIO_H
+
+#include "FrameLib_RandGen.h"
+
+#include <string>
+#include <vector>
+
+/**
+ 
+ @struct FrameLib_AudioFile
+ 
+ @ingroup Hosting
+ 
+ @brief multichannel audio held in memory, with reading and writing of WAV files.
+ 
+ Reading supports 16, 24 and 32 bit integer and 32 and 64 bit floating point data (including WAVE_FORMAT_EXTENSIBLE files). Writing is always as 32 bit floating point.
+ 
+ */
+
+struct FrameLib_AudioFile
+{
+    FrameLib_AudioFile() : mSamplingRate(44100.0) {}
+    
+    unsigned long getNumChans() const   { return static_cast<unsigned long>(mChannels.size()); }
+    unsigned long getLength() const     { return mChannels.size() ? static_cast<unsigned long>(mChannels[0].size()) : 0; }
+    
+    // File IO (returns false and sets the error string on failure)
+    
+    bool read(const char *path, std::string& error);
+    bool write(const char *path, std::string& error) const;
+    
+    double mSamplingRate;
+    std::vector<std::vector<double>> mChannels;
+};
+
+/**
+ 
+ @class FrameLib_OfflineInput
+ 
+ @ingroup Hosting
+ 
+ @brief a source of input audio for offline processing (either a file or a synthetic signal).
+ 
+ Synthetic signals are specified by name, optionally followed by a colon and a frequency in Hz (for instance "sine:1000" or "impulse:10"). Noise is seeded identically on every run so that renders are reproducible.
+ 
+ */
+
+class FrameLib_OfflineInput
+{
+    enum SignalType { kSilence, kNoise, kSine, kImpulse, kFile };
+
+public:
+    
+    FrameLib_OfflineInput();
+    
+    // Set the input (a WAV file path or a synthetic signal name)
+    
+    bool set(const std::string& input, std::string& error);
+    
+    // Info (files have a fixed length and sampling rate, whereas synthetic signals are unlimited)
+    
+    bool isFile() const                 { return mType == kFile; }
+    unsigned long getLength() const     { return mFile.getLength(); }
+    double getFileSamplingRate() const  { return mFile.mSamplingRate; }
+    
+    // Read the next block into all the given channels (files are zero padded after their end)
+    
+    void read(double * const *outs, unsigned long numChans, unsigned long blockSize, double samplingRate);
+
+private:
+    
+    SignalType mType;
+    double mFrequency;
+    double mPhase;
+    unsigned long mPosition;
+    FrameLib_AudioFile mFile;
+    FrameLib_RandGen mRandom;
+};
+
+#endif
@@ -0,0 +1,272 @@
+
+#include "FrameLib_OfflineGraph.h"
+#include "FrameLib_TypeList.h"
+
+#include <chrono>
+#include <cctype>
+
+// Object Creation
+
+template <class T>
+FrameLib_Multistream *createObject(FrameLib_Context context, FrameLib_Parameters::Serial *serialisedParameters, FrameLib_Proxy *proxy, unsigned long nStreams)
+{
+    return new T(context, serialisedParameters, proxy, nStreams);
+}
+
+template <class T>
+void addCreator(std::map<std::string, FrameLib_OfflineGraph::Creator> *creators)
+{
+    std::string type;
+    
+    getTypeString(type, typeid(T));
+    (*creators)[FrameLib_OfflineGraph::normaliseType(type)] = &createObject<T>;
+}
+
+template <class T>
+struct FrameLib_OfflineGraph::AddCreator
+{
+    void operator()(std::map<std::string, Creator> *creators) { addCreator<FrameLib_Expand<T>>(creators); }
+};
+
+const std::map<std::string, FrameLib_OfflineGraph::Creator>& FrameLib_OfflineGraph::getCreators()
+{
+    static std::map<std::string, Creator> creators;
+    
+    if (creators.empty())
+    {
+        FrameLib_ObjectList::execute<AddCreator>(&creators);
+        
+        // Multistream objects that are not expanded from a block
+        
+        addCreator<FrameLib_Pack>(&creators);
+        addCreator<FrameLib_Unpack>(&creators);
+    }
+    
+    return creators;
+}
+
+std::string FrameLib_OfflineGraph::normaliseType(const std::string& type)
+{
+    std::string normalised;
+    
+    for (auto it = type.begin(); it != type.end(); it++)
+        if (!isspace(static_cast<unsigned char>(*it)))
+            normalised.push_back(*it);
+    
+    return normalised;
+}
+
+// Constructor / Destructor
+
+FrameLib_OfflineGraph::FrameLib_OfflineGraph(FrameLib_ErrorReporter::HostNotifier *notifier)
+: mGlobal(nullptr), mContext(FrameLib_Global::get(&mGlobal, notifier), this), mNumAudioIns(0), mNumAudioOuts(0), mNumThreads(1)
+, mBudget(0.0), mPolicy(FrameLib_ProcessingQueue::kDeadlineDrop)
+{}
+
+FrameLib_OfflineGraph::~FrameLib_OfflineGraph()
+{
+    clear();
+    FrameLib_Global::release(&mGlobal);
+}
+
+void FrameLib_OfflineGraph::clear()
+{
+    // N.B. objects are deleted before their proxies
+    
+    mAudioObjects.clear();
+    mObjects.clear();
+    mProxies.clear();
+    mTypes.clear();
+    mNumAudioIns = 0;
+    mNumAudioOuts = 0;
+}
+
+// Build
+
+bool FrameLib_OfflineGraph::build(const std::vector<FrameLib_ObjectDescription>& objects, std::string& error)
+{
+    using Connection = FrameLib_Object<FrameLib_Multistream>::Connection;
+    
+    const unsigned long kOrdering = -1;
+    const std::map<std::string, Creator>& creators = getCreators();
+    
+    clear();
+    
+    for (auto it = objects.begin(); it != objects.end(); it++)
+    {
+        unsigned long index = static_cast<unsigned long>(it - objects.begin());
+        std::string objectName = "object " + std::to_string(index) + " (" + it->mObjectType + ")";
+        auto creator = creators.find(normaliseType(it->mObjectType));
+        
+        if (creator == creators.end())
+        {
+            error = objectName + " - unknown type";
+            clear();
+            return false;
+        }
+        
+        // Parameters
+        
+        FrameLib_Parameters::AutoSerial parameters;
+        
+        for (auto jt = it->mParameters.begin(); jt != it->mParameters.end(); jt++)
+        {
+            if (jt->mType == kVector)
+                parameters.write(jt->mTag.c_str(), jt->mVector.data(), static_cast<unsigned long>(jt->mVector.size()));
+            else
+                parameters.write(jt->mTag.c_str(), jt->mString.c_str());
+        }
+        
+        // Create
+        
+        mProxies.add(new ObjectProxy(index));
+        mObjects.add(creator->second(mContext, &parameters, mProxies.back().get(), std::max(it->mNumStreams, 1UL)));
+        mTypes.push_back(it->mObjectType);
+        
+        FrameLib_Multistream *object = mObjects.back().get();
+        
+        // Fixed Inputs
+        
+        for (auto jt = it->mInputs.begin(); jt != it->mInputs.end(); jt++)
+        {
+            unsigned long idx = static_cast<unsigned long>(jt - it->mInputs.begin());
+            
+            if (jt->size() && idx < object->getNumIns())
+                object->setFixedInput(idx, jt->data(), static_cast<unsigned long>(jt->size()));
+        }
+        
+        // Connections (which always refer to earlier objects)
+        
+        for (auto jt = it->mConnections.begin(); jt != it->mConnections.end(); jt++)
+        {
+            ConnectionResult result = kConnectSuccess;
+            
+            if (jt->mObjectIndex >= index || jt->mOutputIndex >= mObjects[jt->mObjectIndex]->getNumOuts() || (jt->mInputIndex != kOrdering && jt->mInputIndex >= object->getNumIns()))
+            {
+                error = objectName + " - invalid connection";
+                clear();
+                return false;
+            }
+            
+            Connection connection(mObjects[jt->mObjectIndex].get(), jt->mOutputIndex);
+            
+            if (jt->mInputIndex == kOrdering)
+                result = object->addOrderingConnection(connection);
+            else
+                result = object->addConnection(connection, jt->mInputIndex);
+            
+            if (result != kConnectSuccess)
+            {
+                error = objectName + " - connection failed";
+                clear();
+                return false;
+            }
+        }
+    }
+    
+    // Find objects that must be updated by the host
+    
+    for (auto it = mObjects.begin(); it != mObjects.end(); it++)
+    {
+        if ((*it)->getType() == kScheduler || (*it)->getNumAudioChans())
+            mAudioObjects.push_back(AudioObject(it->get(), static_cast<unsigned long>(it - mObjects.begin())));
+        
+        mNumAudioIns += (*it)->getNumAudioIns();
+        mNumAudioOuts += (*it)->getNumAudioOuts();
+    }
+    
+    return true;
+}
+
+// Audio Processing
+
+void FrameLib_OfflineGraph::reset(double samplingRate, unsigned long maxBlockSize)
+{
+    FrameLib_Context::ProcessingQueue queue(mContext);
+    
+    queue->setNumThreads(mNumThreads);
+    queue->setBudget(mBudget);
+    queue->setDeadlinePolicy(mPolicy);
+    
+    for (auto it = mObjects.begin(); it != mObjects.end(); it++)
+        (*it)->reset(samplingRate, maxBlockSize);
+    
+    resetStatistics();
+}
+
+void FrameLib_OfflineGraph::process(const double * const *ins, double **outs, unsigned long blockSize)
+{
+    using Clock = std::chrono::steady_clock;
+    
+    for (auto it = mAudioObjects.begin(); it != mAudioObjects.end(); it++)
+    {
+        Clock::time_point start = Clock::now();
+        
+        it->mObject->blockUpdate(ins, outs, blockSize);
+        it->mTime += std::chrono::duration<double>(Clock::now() - start).count();
+        
+        ins += it->mObject->getNumAudioIns();
+        outs += it->mObject->getNumAudioOuts();
+    }
+}
+
+// Statistics
+
+unsigned long long FrameLib_OfflineGraph::getNumFrames()
+{
+    FrameLib_Context::ProcessingQueue queue(mContext);
+    
+    return queue->getNumFrames();
+}
+
+FrameLib_ProcessingQueue::DeadlineStatistics FrameLib_OfflineGraph::getDeadlineStatistics()
+{
+    FrameLib_Context::ProcessingQueue queue(mContext);
+    
+    return queue->getDeadlineStatistics();
+}
+
+FrameLib_LocalAllocator::Statistics FrameLib_OfflineGraph::getLocalAllocatorStatistics()
+{
+    FrameLib_Context::Allocator allocator(mContext);
+    
+    return allocator->getStatistics();
+}
+
+void FrameLib_OfflineGraph::resetStatistics()
+{
+    FrameLib_Context::ProcessingQueue queue(mContext);
+    FrameLib_Context::Allocator allocator(mContext);
+    FrameLib_Context::Profiler profiler(mContext);
+    
+    queue->resetNumFrames();
+    queue->resetDeadlineStatistics();
+    allocator->resetStatistics();
+    profiler->reset();
+    
+    for (auto it = mAudioObjects.begin(); it != mAudioObjects.end(); it++)
+        it->mTime = 0.0;
+}
+
+// Profiling
+
+void FrameLib_OfflineGraph::setTraceCapacity(unsigned long capacity)
+{
+    FrameLib_Context::Profiler profiler(mContext);
+    
+    profiler->setTraceCapacity(capacity);
+}
+
+void FrameLib_OfflineGraph::getProfile(std::vector<FrameLib_Profiler::Record>& records)
+{
+    FrameLib_Context::Profiler profiler(mContext);
+    
+    profiler->getRecords(records);
+}
+
+void FrameLib_OfflineGraph::getProfileTrace(std::vector<FrameLib_Profiler::TraceEvent>& events)
+{
+    FrameLib_Context::Profiler profiler(mContext);
+    
+    profiler->getTrace(events);
+}
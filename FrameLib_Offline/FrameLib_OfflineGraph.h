@@ -0,0 +1,154 @@
+
+#ifndef FRAMELIB_OFFLINEGRAPH_H
+#define FRAMELIB_OFFLINEGRAPH_H
+
+#include "FrameLib_Global.h"
+#include "FrameLib_Context.h"
+#include "FrameLib_Multistream.h"
+#include "FrameLib_SerialiseGraph.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ 
+ @class FrameLib_OfflineGraph
+ 
+ @ingroup Hosting
+ 
+ @brief a host for running a serialised graph without an audio environment (for offline rendering and benchmarking).
+ 
+ The graph is built from a std::vector of FrameLib_ObjectDescription structs (as produced by serialiseGraph() or readGraph()) by looking up object types by name. Audio is processed as in exported code, by calling blockUpdate() on each object that handles audio (or is a scheduler) in order, with the time spent in each of these calls accumulated per object. Note that these calls process all frames triggered by the object, so the times include the work of any downstream objects.
+ 
+ */
+
+class FrameLib_OfflineGraph
+{
+    template <class T>
+    struct AddCreator;
+
+public:
+    
+    using Creator = FrameLib_Multistream *(*)(FrameLib_Context, FrameLib_Parameters::Serial *, FrameLib_Proxy *, unsigned long);
+    
+    /**
+     
+     @struct ObjectProxy
+     
+     @brief a proxy identifying the index of an object in the graph (for error reporting).
+     
+     */
+    
+    struct ObjectProxy : public virtual FrameLib_Proxy
+    {
+        ObjectProxy(unsigned long index) : mIndex(index) {}
+        
+        unsigned long mIndex;
+    };
+    
+    // Constructor / Destructor
+    
+    FrameLib_OfflineGraph(FrameLib_ErrorReporter::HostNotifier *notifier = nullptr);
+    ~FrameLib_OfflineGraph();
+    
+    // Non-copyable
+    
+    FrameLib_OfflineGraph(const FrameLib_OfflineGraph&) = delete;
+    FrameLib_OfflineGraph& operator=(const FrameLib_OfflineGraph&) = delete;
+    
+    // Build the graph (returns false and sets the error string on failure)
+    
+    bool build(const std::vector<FrameLib_ObjectDescription>& objects, std::string& error);
+    
+    // Threading (N.B. this takes effect on the next reset)
+    
+    void setNumThreads(unsigned long numThreads) { mNumThreads = numThreads; }
+    
+    // Soft Deadline (N.B. this takes effect on the next reset - the budget is in microseconds per block, and zero disables the deadline)
+    
+    void setDeadline(double budget, FrameLib_ProcessingQueue::DeadlinePolicy policy)   { mBudget = budget; mPolicy = policy; }
+    void setLowPriority(unsigned long idx, bool lowPriority)                            { mObjects[idx]->setLowPriority(lowPriority); }
+    
+    // Audio Processing
+    
+    void reset(double samplingRate, unsigned long maxBlockSize);
+    void process(const double * const *ins, double **outs, unsigned long blockSize);
+    
+    // IO Info
+    
+    unsigned long getNumAudioIns() const    { return mNumAudioIns; }
+    unsigned long getNumAudioOuts() const   { return mNumAudioOuts; }
+    
+    // Object Info
+    
+    unsigned long getNumObjects() const                     { return static_cast<unsigned long>(mObjects.size()); }
+    unsigned long getNumAudioObjects() const                { return static_cast<unsigned long>(mAudioObjects.size()); }
+    unsigned long getAudioObjectIndex(unsigned long idx) const  { return mAudioObjects[idx].mIndex; }
+    const std::string& getObjectType(unsigned long idx) const   { return mTypes[idx]; }
+    
+    // Statistics (times are in seconds)
+    
+    double getAudioObjectTime(unsigned long idx) const      { return mAudioObjects[idx].mTime; }
+    unsigned long long getNumFrames();
+    FrameLib_LocalAllocator::Statistics getLocalAllocatorStatistics();
+    FrameLib_GlobalAllocator::CacheStatistics getGlobalAllocatorStatistics()    { return mGlobal->getCacheStatistics(); }
+    FrameLib_FFTSetups::Statistics getFFTSetupStatistics()                  { return mGlobal->getFFTSetupStatistics(); }
+    FrameLib_WindowCache::Statistics getWindowCacheStatistics()             { return mGlobal->getWindowCacheStatistics(); }
+    FrameLib_ProcessingQueue::DeadlineStatistics getDeadlineStatistics();
+    
+    void resetStatistics();
+    
+    // Profiling (records and traces are only collected if FRAMELIB_PROFILING is defined)
+    
+    void setTraceCapacity(unsigned long capacity);
+    void getProfile(std::vector<FrameLib_Profiler::Record>& records);
+    void getProfileTrace(std::vector<FrameLib_Profiler::TraceEvent>& events);
+    
+    // Type Matching (type strings are compared with whitespace removed)
+    
+    static std::string normaliseType(const std::string& type);
+
+private:
+    
+    // Object Creation
+    
+    static const std::map<std::string, Creator>& getCreators();
+    void clear();
+    
+    /**
+     
+     @struct AudioObject
+     
+     @brief an object that is updated by the host along with its accumulated processing time.
+     
+     */
+    
+    struct AudioObject
+    {
+        AudioObject(FrameLib_Multistream *object, unsigned long index) : mObject(object), mIndex(index), mTime(0.0) {}
+        
+        FrameLib_Multistream *mObject;
+        unsigned long mIndex;
+        double mTime;
+    };
+    
+    // Member Variables (N.B. context resources are only retained by the objects, so they are accessed via temporary pointers)
+    
+    FrameLib_Global *mGlobal;
+    FrameLib_Context mContext;
+    
+    FrameLib_OwnedList<ObjectProxy> mProxies;
+    FrameLib_OwnedList<FrameLib_Multistream> mObjects;
+    std::vector<std::string> mTypes;
+    std::vector<AudioObject> mAudioObjects;
+    
+    unsigned long mNumAudioIns;
+    unsigned long mNumAudioOuts;
+    unsigned long mNumThreads;
+    
+    double mBudget;
+    FrameLib_ProcessingQueue::DeadlinePolicy mPolicy;
+};
+
+#endif
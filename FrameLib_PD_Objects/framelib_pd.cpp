@@ -61,6 +61,8 @@
 
 #include "FrameLib_FFT.h"
 #include "FrameLib_iFFT.h"
+#include "FrameLib_STFT.h"
+#include "FrameLib_ISTFT.h"
 #include "FrameLib_Correlate.h"
 #include "FrameLib_Convolve.h"
 #include "FrameLib_Multitaper.h"
@@ -99,6 +101,7 @@
 
 #include "FrameLib_AccumPoint.h"
 #include "FrameLib_Chop.h"
+#include "FrameLib_Descriptors.h"
 #include "FrameLib_Join.h"
 #include "FrameLib_MedianFilter.h"
 #include "FrameLib_NanFilter.h"
@@ -367,6 +370,8 @@ extern "C" void framelib_pd_setup(void)
     
     FrameLib_PDClass_Expand<FrameLib_FFT>::makeClass("fl.fft~");
     FrameLib_PDClass_Expand<FrameLib_iFFT>::makeClass("fl.ifft~");
+    FrameLib_PDClass_Expand<FrameLib_STFT>::makeClass("fl.stft~");
+    FrameLib_PDClass_Expand<FrameLib_ISTFT>::makeClass("fl.istft~");
     FrameLib_PDClass_Expand<FrameLib_Correlate>::makeClass("fl.correlate~");
     FrameLib_PDClass_Expand<FrameLib_Convolve>::makeClass("fl.convolve~");
     FrameLib_PDClass_Expand<FrameLib_Multitaper>::makeClass("fl.multitaper~");
@@ -403,6 +408,7 @@ extern "C" void framelib_pd_setup(void)
     
     FrameLib_PDClass_Expand<FrameLib_AccumPoint>::makeClass("fl.accumpoint~");
     FrameLib_PDClass_Expand<FrameLib_Chop>::makeClass("fl.chop~");
+    FrameLib_PDClass_Expand<FrameLib_Descriptors>::makeClass("fl.descriptors~");
     FrameLib_PDClass_Expand<FrameLib_Join>::makeClass("fl.join~");
     FrameLib_PDClass_Expand<FrameLib_MedianFilter>::makeClass("fl.medianfilter~");
     FrameLib_PDClass_Expand<FrameLib_NonZero>::makeClass("fl.nonzero~");
@@ -0,0 +1,576 @@
+
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <complex>
+#include <vector>
+#include "FrameLib_RandGen.h"
+#include "../FrameLib_Dependencies/SpectralProcessor.hpp"
+#include "../FrameLib_Dependencies/PartitionedConvolver.hpp"
+#include "../FrameLib_Dependencies/KernelSmoother.hpp"
+#include "../FrameLib_Dependencies/MultitaperEstimator.hpp"
+
+// ************************************************************************************** //
+
+// Random Numbers
+
+FrameLib_RandGen gen;
+
+// ************************************************************************************** //
+
+// Output
+
+void tabbedOut(const std::string& name, const std::string& text, int tab = 25)
+{
+    std::cout << std::setw(tab) << std::setfill(' ');
+    std::cout.setf(std::ios::left);
+    std::cout.unsetf(std::ios::right);
+    std::cout << name;
+    std::cout.unsetf(std::ios::left);
+    std::cout << text << "\n";
+}
+
+template <typename T>
+std::string to_string_with_precision(const T a_value, const int n = 4, bool fixed = true)
+{
+    std::ostringstream out;
+    if (fixed)
+        out << std::setprecision(n) << std::fixed << a_value;
+    else
+        out << std::setprecision(n) << a_value;
+    return out.str();
+}
+
+// ************************************************************************************** //
+
+// Correctness
+
+static int numTests = 0;
+static int numPassedTests = 0;
+
+void testResult(const std::string& name, bool passed)
+{
+    numTests++;
+    
+    if (passed)
+        numPassedTests++;
+    else
+        std::cout << name << " : - TEST FAILED\n";
+}
+
+void testsCompleted()
+{
+    if (numTests == numPassedTests)
+        std::cout << " ***** ALL TESTS PASSED *****\n";
+    else
+    {
+        std::cout << " ***** TESTS FAILED *****\n";
+        std::cout << numPassedTests << " out of " << numTests << " passed" << "\n";
+    }
+}
+
+// Naive DFT for reference (computed in long double)
+
+std::vector<std::complex<long double>> naiveDFT(const std::vector<double>& real, const std::vector<double>& imag)
+{
+    const long double pi = 3.14159265358979323846264338327950288L;
+    
+    unsigned long size = static_cast<unsigned long>(real.size());
+    std::vector<std::complex<long double>> output(size);
+    
+    for (unsigned long i = 0; i < size; i++)
+    {
+        std::complex<long double> sum = 0.0L;
+        
+        for (unsigned long j = 0; j < size; j++)
+        {
+            long double phase = -2.0L * pi * static_cast<long double>((i * j) % size) / static_cast<long double>(size);
+            sum += std::complex<long double>(real[j], imag[j]) * std::polar(1.0L, phase);
+        }
+        
+        output[i] = sum;
+    }
+    
+    return output;
+}
+
+// Compare complex and real transforms (and their inverses) against the naive DFT (the error is relative to the input size)
+
+void arbitraryCorrectness(unsigned long size)
+{
+    spectral_processor<double> processor(0);
+    
+    std::vector<double> real(size), imag(size), zeros(size, 0.0);
+    std::vector<double> spectrumR(size), spectrumI(size), output(size);
+    
+    for (unsigned long i = 0; i < size; i++)
+    {
+        real[i] = gen.randDouble(-1.0, 1.0);
+        imag[i] = gen.randDouble(-1.0, 1.0);
+    }
+    
+    std::vector<std::complex<long double>> complexRef = naiveDFT(real, imag);
+    std::vector<std::complex<long double>> realRef = naiveDFT(real, zeros);
+    
+    FFT_SPLIT_COMPLEX_D spectrum { spectrumR.data(), spectrumI.data() };
+    double error = 0.0;
+    double scale = 1.0 / static_cast<double>(size);
+    
+    // Complex
+    
+    std::copy(real.begin(), real.end(), spectrumR.begin());
+    std::copy(imag.begin(), imag.end(), spectrumI.begin());
+    processor.fft_arbitrary(spectrum, size);
+    
+    for (unsigned long i = 0; i < size; i++)
+        error = std::max(error, static_cast<double>(std::abs(complexRef[i] - std::complex<long double>(spectrumR[i], spectrumI[i]))) * scale);
+    
+    processor.ifft_arbitrary(spectrum, size);
+    
+    for (unsigned long i = 0; i < size; i++)
+        error = std::max(error, std::max(std::abs(spectrumR[i] * scale - real[i]), std::abs(spectrumI[i] * scale - imag[i])));
+    
+    // Real
+    
+    processor.rfft_arbitrary(spectrum, real.data(), size, size);
+    
+    for (unsigned long i = 0; i < (size >> 1) + 1; i++)
+        error = std::max(error, static_cast<double>(std::abs(realRef[i] - std::complex<long double>(spectrumR[i], spectrumI[i]))) * scale);
+    
+    processor.rifft_arbitrary(output.data(), spectrum, size);
+    
+    for (unsigned long i = 0; i < size; i++)
+        error = std::max(error, std::abs(output[i] * scale - real[i]));
+    
+    testResult("Arbitrary FFT Size " + std::to_string(size), error < 1e-13);
+}
+
+// Single precision accuracy (the maximum error relative to the peak of the double precision result)
+
+double relativeError(const std::vector<double>& reference, const std::vector<float>& result)
+{
+    double error = 0.0;
+    double peak = 0.0;
+    
+    for (size_t i = 0; i < reference.size(); i++)
+    {
+        peak = std::max(peak, std::abs(reference[i]));
+        error = std::max(error, std::abs(reference[i] - static_cast<double>(result[i])));
+    }
+    
+    return peak ? error / peak : error;
+}
+
+void precisionAccuracy(unsigned long size)
+{
+    spectral_processor<double> processorD(65536);
+    spectral_processor<float> processorF(65536);
+    kernel_smoother<double> smootherD;
+    kernel_smoother<float> smootherF;
+    
+    unsigned long FFTSizeLog2 = processorD.calc_fft_size_log2(size);
+    unsigned long FFTSize = 1UL << FFTSizeLog2;
+    unsigned long kernelSize = 64;
+    
+    std::vector<double> input1(size), input2(size), kernel(kernelSize);
+    std::vector<float> input1F(size), input2F(size), kernelF(kernelSize);
+    
+    for (unsigned long i = 0; i < size; i++)
+    {
+        input1F[i] = static_cast<float>(input1[i] = gen.randDouble(-1.0, 1.0));
+        input2F[i] = static_cast<float>(input2[i] = gen.randDouble(-1.0, 1.0));
+    }
+    
+    for (unsigned long i = 0; i < kernelSize; i++)
+        kernelF[i] = static_cast<float>(kernel[i] = 0.5 - 0.5 * cos(2.0 * M_PI * (i + 0.5) / kernelSize));
+    
+    // FFT
+    
+    std::vector<double> spectrumD(FFTSize);
+    std::vector<float> spectrumF(FFTSize);
+    FFT_SPLIT_COMPLEX_D splitD { spectrumD.data(), spectrumD.data() + (FFTSize >> 1) };
+    FFT_SPLIT_COMPLEX_F splitF { spectrumF.data(), spectrumF.data() + (FFTSize >> 1) };
+    
+    processorD.rfft(splitD, input1.data(), size, FFTSizeLog2);
+    processorF.rfft(splitF, input1F.data(), size, FFTSizeLog2);
+    
+    double FFTError = relativeError(spectrumD, spectrumF);
+    
+    // Convolution and correlation
+    
+    using EdgeD = spectral_processor<double>::EdgeMode;
+    using EdgeF = spectral_processor<float>::EdgeMode;
+    
+    unsigned long sizeOut = processorD.convolved_size(size, size, EdgeD::kEdgeLinear);
+    
+    std::vector<double> outputD(sizeOut);
+    std::vector<float> outputF(sizeOut);
+    
+    processorD.convolve(outputD.data(), { input1.data(), size }, { input2.data(), size }, EdgeD::kEdgeLinear);
+    processorF.convolve(outputF.data(), { input1F.data(), size }, { input2F.data(), size }, EdgeF::kEdgeLinear);
+    
+    double convolveError = relativeError(outputD, outputF);
+    
+    processorD.correlate(outputD.data(), { input1.data(), size }, { input2.data(), size }, EdgeD::kEdgeLinear);
+    processorF.correlate(outputF.data(), { input1F.data(), size }, { input2F.data(), size }, EdgeF::kEdgeLinear);
+    
+    double correlateError = relativeError(outputD, outputF);
+    
+    // Smoothing
+    
+    outputD.resize(size);
+    outputF.resize(size);
+    
+    smootherD.smooth(outputD.data(), input1.data(), kernel.data(), size, kernelSize, 16.0, 256.0, kernel_smoother<double>::kSmoothFold);
+    smootherF.smooth(outputF.data(), input1F.data(), kernelF.data(), size, kernelSize, 16.0, 256.0, kernel_smoother<float>::kSmoothFold);
+    
+    double smoothError = relativeError(outputD, outputF);
+    
+    tabbedOut("  Size " + std::to_string(size), "fft " + to_string_with_precision(FFTError, 2, false) + " convolve " + to_string_with_precision(convolveError, 2, false) + " correlate " + to_string_with_precision(correlateError, 2, false) + " smooth " + to_string_with_precision(smoothError, 2, false), 15);
+    
+    testResult("Single Precision Size " + std::to_string(size), std::max(std::max(FFTError, convolveError), std::max(correlateError, smoothError)) < 1e-5);
+}
+
+// Compare partitioned convolution against a single transform (with a changed kernel to check the cache is updated)
+
+void partitionedCorrectness(unsigned long size, unsigned long kernelSize)
+{
+    using Convolver = partitioned_convolver<double>;
+    
+    Convolver convolver(1 << 20);
+    
+    std::vector<double> input(size), kernel(kernelSize), reference(size + kernelSize - 1), output(size + kernelSize - 1);
+    
+    for (unsigned long i = 0; i < size; i++)
+        input[i] = gen.randDouble(-1.0, 1.0);
+    
+    for (unsigned long i = 0; i < kernelSize; i++)
+        kernel[i] = gen.randDouble(-1.0, 1.0);
+    
+    double error = 0.0;
+    
+    for (int i = 0; i < 4; i++)
+    {
+        Convolver::PartitionMode mode = (i & 1) ? Convolver::kPartitionNonUniform : Convolver::kPartitionUniform;
+        
+        if (i == 2)
+            kernel[kernelSize / 2] += 1.0;
+        
+        convolver.convolve(reference.data(), { input.data(), size }, { kernel.data(), kernelSize }, Convolver::kEdgeLinear);
+        convolver.convolve_partitioned(output.data(), { input.data(), size }, { kernel.data(), kernelSize }, mode);
+        
+        for (unsigned long j = 0; j < output.size(); j++)
+            error = std::max(error, std::abs(output[j] - reference[j]));
+    }
+    
+    testResult("Partitioned Convolution " + std::to_string(size) + " x " + std::to_string(kernelSize), error < 1e-12);
+}
+
+// Reference multitaper power spectrum (wrapping each bin individually, as in the original implementation)
+
+void multitaperReference(spectral_processor<double>& processor, double *output, const double *input, unsigned long size, unsigned long numTapers)
+{
+    unsigned long FFTSizeLog2 = processor.calc_fft_size_log2(size);
+    unsigned long FFTSize = 1UL << FFTSizeLog2;
+    
+    std::vector<double> spectrumR(FFTSize + 1), spectrumI(FFTSize + 1);
+    FFT_SPLIT_COMPLEX_D spectrum { spectrumR.data(), spectrumI.data() };
+    
+    processor.rfft(spectrum, input, size, FFTSizeLog2 + 1);
+    
+    spectrum.realp[FFTSize] = spectrum.imagp[0];
+    spectrum.imagp[FFTSize] = 0.0;
+    spectrum.imagp[0] = 0.0;
+    
+    auto getWrapped = [&](std::complex<double>& value, long pos)
+    {
+        pos &= ((FFTSize << 1) - 1);
+        
+        if (pos <= (long) FFTSize)
+            value = std::complex<double>(spectrum.realp[pos], spectrum.imagp[pos]) * 0.5;
+        else
+            value = std::complex<double>(spectrum.realp[(FFTSize << 1) - pos], -spectrum.imagp[(FFTSize << 1) - pos]) * 0.5;
+    };
+    
+    double weightSum = numTapers - (((1.0 / (double) numTapers) - 3.0 + 2.0 * numTapers) / 6.0);
+    double normFactor = 1.0 / (4.0 * weightSum);
+    
+    std::fill_n(output, (FFTSize >> 1) + 1, 0.0);
+    
+    for (unsigned long i = 1; i <= numTapers; i++)
+    {
+        double taperScale = (1.0 - ((i - 1) * (i - 1)) / (double) (numTapers * numTapers)) * normFactor;
+        
+        for (unsigned long j = 0; j <= (FFTSize >> 1); j++)
+        {
+            std::complex<double> a, b;
+            
+            getWrapped(a, (long) ((j << 1) + i));
+            getWrapped(b, (long) (j << 1) - (long) i);
+            
+            output[j] += std::norm(a - b) * taperScale;
+        }
+    }
+}
+
+// Compare the multitaper estimator against the reference (and check that adaptive weighting gives a valid spectrum)
+
+void multitaperCorrectness(unsigned long size, unsigned long numTapers)
+{
+    using Estimator = multitaper_estimator<double>;
+    
+    Estimator estimator(1 << 16);
+    
+    unsigned long sizeOut = (1UL << estimator.calc_fft_size_log2(size) >> 1) + 1;
+    
+    std::vector<double> input(size), reference(sizeOut), output(sizeOut);
+    
+    for (unsigned long i = 0; i < size; i++)
+        input[i] = gen.randDouble(-1.0, 1.0);
+    
+    multitaperReference(estimator, reference.data(), input.data(), size, numTapers);
+    
+    bool success = estimator.power_spectrum(output.data(), input.data(), size, numTapers, Estimator::kWeightingParabolic);
+    
+    double error = 0.0;
+    double peak = 0.0;
+    
+    for (unsigned long j = 0; j < sizeOut; j++)
+    {
+        error = std::max(error, std::abs(output[j] - reference[j]));
+        peak = std::max(peak, std::abs(reference[j]));
+    }
+    
+    success = success && estimator.power_spectrum(output.data(), input.data(), size, numTapers, Estimator::kWeightingAdaptive);
+    
+    for (unsigned long j = 0; j < sizeOut; j++)
+        success = success && std::isfinite(output[j]) && output[j] >= 0.0;
+    
+    testResult("Multitaper " + std::to_string(size) + " x " + std::to_string(numTapers), success && error <= peak * 1e-12);
+}
+
+// ************************************************************************************** //
+
+// Timing
+
+class Timer
+{
+
+public:
+    
+    Timer() : mStart(0) {}
+    
+    void start()
+    {
+        mStart = mach_absolute_time();
+    };
+    
+    uint64_t stop()
+    {
+        uint64_t end = mach_absolute_time();
+        
+        mach_timebase_info_data_t info;
+        mach_timebase_info(&info);
+        
+        uint64_t elapsed = ((end - mStart) * info.numer) / info.denom;
+        mStart = mach_absolute_time();
+        
+        return elapsed;
+    };
+
+private:
+    
+    uint64_t        mStart;
+};
+
+// Each size processes the same total number of input samples so that the times are comparable
+
+static const unsigned long totalSamples = 1 << 24;
+
+// Compare a power of two transform (zero-padding the input) with an exact length transform
+
+void realTiming(unsigned long size)
+{
+    spectral_processor<double> processor(65536);
+    
+    unsigned long FFTSizeLog2 = processor.calc_fft_size_log2(size);
+    unsigned long paddedSize = 1UL << FFTSizeLog2;
+    
+    std::vector<double> input(size), spectrumR(paddedSize), spectrumI(paddedSize);
+    FFT_SPLIT_COMPLEX_D spectrum { spectrumR.data(), spectrumI.data() };
+    Timer timer;
+    
+    for (auto it = input.begin(); it != input.end(); it++)
+        *it = gen.randDouble(-1.0, 1.0);
+    
+    timer.start();
+    for (unsigned long i = 0; i < totalSamples / size; i++)
+        processor.rfft(spectrum, input.data(), size, FFTSizeLog2);
+    uint64_t padded = timer.stop();
+    for (unsigned long i = 0; i < totalSamples / size; i++)
+        processor.rfft_arbitrary(spectrum, input.data(), size, size);
+    uint64_t exact = timer.stop();
+    
+    tabbedOut("  Size " + std::to_string(size), to_string_with_precision(padded / 1000000.0, 2) + " ms padded (" + std::to_string(paddedSize) + ") " + to_string_with_precision(exact / 1000000.0, 2) + " ms exact " + to_string_with_precision((double) padded / (double) exact, 2) + "x", 15);
+}
+
+// Compare double and single precision convolution
+
+void precisionTiming(unsigned long size)
+{
+    spectral_processor<double> processorD(65536);
+    spectral_processor<float> processorF(65536);
+    
+    using EdgeD = spectral_processor<double>::EdgeMode;
+    using EdgeF = spectral_processor<float>::EdgeMode;
+    
+    unsigned long sizeOut = processorD.convolved_size(size, size, EdgeD::kEdgeLinear);
+    
+    std::vector<double> input(size), outputD(sizeOut);
+    std::vector<float> inputF(size), outputF(sizeOut);
+    Timer timer;
+    
+    for (unsigned long i = 0; i < size; i++)
+        inputF[i] = static_cast<float>(input[i] = gen.randDouble(-1.0, 1.0));
+    
+    timer.start();
+    for (unsigned long i = 0; i < totalSamples / size; i++)
+        processorD.convolve(outputD.data(), { input.data(), size }, { input.data(), size }, EdgeD::kEdgeLinear);
+    uint64_t timeD = timer.stop();
+    for (unsigned long i = 0; i < totalSamples / size; i++)
+        processorF.convolve(outputF.data(), { inputF.data(), size }, { inputF.data(), size }, EdgeF::kEdgeLinear);
+    uint64_t timeF = timer.stop();
+    
+    tabbedOut("  Size " + std::to_string(size), to_string_with_precision(timeD / 1000000.0, 2) + " ms double " + to_string_with_precision(timeF / 1000000.0, 2) + " ms single " + to_string_with_precision((double) timeD / (double) timeF, 2) + "x", 15);
+}
+
+// Compare a single transform with partitioned convolution (for a static kernel)
+
+void partitionedTiming(unsigned long size, unsigned long kernelSize)
+{
+    using Convolver = partitioned_convolver<double>;
+    
+    Convolver convolver(1 << 20);
+    
+    std::vector<double> input(size), kernel(kernelSize), output(size + kernelSize - 1);
+    Timer timer;
+    
+    for (unsigned long i = 0; i < size; i++)
+        input[i] = gen.randDouble(-1.0, 1.0);
+    
+    for (unsigned long i = 0; i < kernelSize; i++)
+        kernel[i] = gen.randDouble(-1.0, 1.0);
+    
+    unsigned long iterations = totalSamples / (kernelSize * 4);
+    
+    timer.start();
+    for (unsigned long i = 0; i < iterations; i++)
+        convolver.convolve(output.data(), { input.data(), size }, { kernel.data(), kernelSize }, Convolver::kEdgeLinear);
+    uint64_t single = timer.stop();
+    for (unsigned long i = 0; i < iterations; i++)
+        convolver.convolve_partitioned(output.data(), { input.data(), size }, { kernel.data(), kernelSize }, Convolver::kPartitionUniform);
+    uint64_t uniform = timer.stop();
+    for (unsigned long i = 0; i < iterations; i++)
+        convolver.convolve_partitioned(output.data(), { input.data(), size }, { kernel.data(), kernelSize }, Convolver::kPartitionNonUniform);
+    uint64_t nonUniform = timer.stop();
+    
+    tabbedOut("  Size " + std::to_string(size) + " x " + std::to_string(kernelSize), to_string_with_precision(single / 1000000.0, 2) + " ms single " + to_string_with_precision(uniform / 1000000.0, 2) + " ms uniform " + to_string_with_precision((double) single / (double) uniform, 2) + "x " + to_string_with_precision(nonUniform / 1000000.0, 2) + " ms non-uniform " + to_string_with_precision((double) single / (double) nonUniform, 2) + "x", 25);
+}
+
+// Compare the reference multitaper implementation with the estimator (for both weightings)
+
+void multitaperTiming(unsigned long size, unsigned long numTapers)
+{
+    using Estimator = multitaper_estimator<double>;
+    
+    Estimator estimator(1 << 16);
+    
+    std::vector<double> input(size), output(size + 1);
+    Timer timer;
+    
+    for (unsigned long i = 0; i < size; i++)
+        input[i] = gen.randDouble(-1.0, 1.0);
+    
+    unsigned long iterations = totalSamples / (size * 4);
+    
+    timer.start();
+    for (unsigned long i = 0; i < iterations; i++)
+        multitaperReference(estimator, output.data(), input.data(), size, numTapers);
+    uint64_t reference = timer.stop();
+    for (unsigned long i = 0; i < iterations; i++)
+        estimator.power_spectrum(output.data(), input.data(), size, numTapers, Estimator::kWeightingParabolic);
+    uint64_t parabolic = timer.stop();
+    for (unsigned long i = 0; i < iterations; i++)
+        estimator.power_spectrum(output.data(), input.data(), size, numTapers, Estimator::kWeightingAdaptive);
+    uint64_t adaptive = timer.stop();
+    
+    tabbedOut("  Size " + std::to_string(size) + " x " + std::to_string(numTapers), to_string_with_precision(reference / 1000000.0, 2) + " ms reference " + to_string_with_precision(parabolic / 1000000.0, 2) + " ms parabolic " + to_string_with_precision((double) reference / (double) parabolic, 2) + "x " + to_string_with_precision(adaptive / 1000000.0, 2) + " ms adaptive", 25);
+}
+
+// ************************************************************************************** //
+
+int main(int argc, const char * argv[]) {
+    
+    const unsigned long sizes[] = { 1000, 1009, 1024, 1025, 1536, 3000, 3072, 4096, 4100 };
+    
+    std::cout << "CORRECTNESS TESTS\n\n";
+    
+    for (unsigned long size = 1; size <= 64; size++)
+        arbitraryCorrectness(size);
+    
+    for (unsigned long i = 0; i < sizeof(sizes) / sizeof(unsigned long); i++)
+        arbitraryCorrectness(sizes[i]);
+    
+    const unsigned long kernelSizes[] = { 1, 63, 64, 65, 1000, 4097, 20000 };
+    
+    for (unsigned long i = 0; i < sizeof(kernelSizes) / sizeof(unsigned long); i++)
+    {
+        partitionedCorrectness(1, kernelSizes[i]);
+        partitionedCorrectness(100, kernelSizes[i]);
+        partitionedCorrectness(1024, kernelSizes[i]);
+    }
+    
+    const unsigned long taperCounts[] = { 1, 3, 8, 16, 32 };
+    
+    for (unsigned long i = 0; i < sizeof(taperCounts) / sizeof(unsigned long); i++)
+    {
+        multitaperCorrectness(7, taperCounts[i]);
+        multitaperCorrectness(1000, taperCounts[i]);
+        multitaperCorrectness(4096, taperCounts[i]);
+    }
+    
+    std::cout << "\nSingle Precision Error\n";
+    
+    for (unsigned long size = 64; size <= 16384; size *= 4)
+        precisionAccuracy(size);
+    
+    std::cout << "\nTIMING TESTS\n\n";
+    
+    std::cout << "Real FFT\n";
+    
+    for (unsigned long i = 0; i < sizeof(sizes) / sizeof(unsigned long); i++)
+        realTiming(sizes[i]);
+    
+    std::cout << "Convolution Precision\n";
+    
+    for (unsigned long size = 64; size <= 16384; size *= 4)
+        precisionTiming(size);
+    
+    std::cout << "Partitioned Convolution\n";
+    
+    for (unsigned long size = 64; size <= 4096; size *= 8)
+        partitionedTiming(size, 262144);
+    
+    std::cout << "Multitaper\n";
+    
+    for (unsigned long numTapers = 8; numTapers <= 32; numTapers *= 2)
+        multitaperTiming(4096, numTapers);
+    
+    std::cout << "\n";
+    
+    testsCompleted();
+    
+    return 0;
+}
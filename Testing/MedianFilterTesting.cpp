@@ -0,0 +1,307 @@
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "FrameLib_RandGen.h"
+#include "FrameLib_SlidingRank.h"
+
+// ************************************************************************************** //
+
+// Random Numbers
+
+FrameLib_RandGen gen;
+
+// ************************************************************************************** //
+
+// Output
+
+void tabbedOut(const std::string& name, const std::string& text, int tab = 25)
+{
+    std::cout << std::setw(tab) << std::setfill(' ');
+    std::cout.setf(std::ios::left);
+    std::cout.unsetf(std::ios::right);
+    std::cout << name;
+    std::cout.unsetf(std::ios::left);
+    std::cout << text << "\n";
+}
+
+template <typename T>
+std::string to_string_with_precision(const T a_value, const int n = 4, bool fixed = true)
+{
+    std::ostringstream out;
+    if (fixed)
+        out << std::setprecision(n) << std::fixed << a_value;
+    else
+        out << std::setprecision(n) << a_value;
+    return out.str();
+}
+
+// ************************************************************************************** //
+
+// Input
+
+std::vector<double> makeInput(unsigned long size, bool specials)
+{
+    const double values[] = { std::numeric_limits<double>::quiet_NaN(), 0.0, -0.0, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() };
+    
+    std::vector<double> input(size);
+    
+    for (unsigned long i = 0; i < size; i++)
+        input[i] = (specials && !gen.randInt(4)) ? values[gen.randInt(5)] : static_cast<double>(gen.randInt(64));
+    
+    return input;
+}
+
+// Windowed input (padded with zeros) for output i covering i - (width >> 1) to i - (width >> 1) + width - 1
+
+double getValue(const std::vector<double>& input, long index)
+{
+    return (index >= 0 && index < static_cast<long>(input.size())) ? input[index] : 0.0;
+}
+
+// ************************************************************************************** //
+
+// Insertion based median filtering (the previous implementation) for timing comparisons
+
+double insertMedian(double *temp, unsigned long *indices, double value, long index, long width)
+{
+    long current, insert, gap;
+    
+    temp[index] = value;
+    current = -10000000;
+    
+    for (long i = 0; i < width; i++)
+    {
+        if (indices[i] == static_cast<unsigned long>(index))
+        {
+            current = i;
+            break;
+        }
+    }
+    
+    for (insert = current, gap = std::max(1L, (width - current) >> 1); gap; gap >>= 1)
+    {
+        for (long i = insert + gap; i < width; i += gap)
+        {
+            if (temp[indices[i]] >= value)
+                break;
+            else
+                insert = i;
+        }
+    }
+    
+    for (long i = current; i < insert; i++)
+        indices[i] = indices[i + 1];
+    indices[insert] = index;
+    
+    for (current = insert, gap = std::max(1L, current >> 1); gap; gap >>= 1)
+    {
+        for (long i = insert - gap; i >= 0; i -= gap)
+        {
+            if (temp[indices[i]] <= value)
+                break;
+            else
+                insert = i;
+        }
+    }
+    
+    for (long i = current; i > insert; i--)
+        indices[i] = indices[i - 1];
+    indices[insert] = index;
+    
+    return temp[indices[width >> 1]];
+}
+
+void insertionFilter(double *output, const std::vector<double>& input, long width)
+{
+    std::vector<double> temp(width);
+    std::vector<unsigned long> indices(width);
+    long offset = width >> 1;
+    
+    for (long i = 0; i < width; i++)
+        temp[i] = getValue(input, i - offset);
+    
+    sortIndicesAscending(indices.data(), temp.data(), width);
+    output[0] = temp[indices[offset]];
+    
+    for (long i = 1; i < static_cast<long>(input.size()); i++)
+        output[i] = insertMedian(temp.data(), indices.data(), getValue(input, i - offset + width - 1), (i - 1) % width, width);
+}
+
+// Sliding rank filtering
+
+void slidingRankFilter(double *output, const std::vector<double>& input, long width, unsigned long rank)
+{
+    std::vector<double> temp(width * 2);
+    std::vector<unsigned long> indices(width * 2);
+    FrameLib_SlidingRank window(temp.data() + width, indices.data(), width, rank);
+    long offset = width >> 1;
+    
+    for (long i = 0; i < width; i++)
+        temp[i] = getValue(input, i - offset);
+    
+    window.reset(temp.data());
+    output[0] = window.rankValue();
+    
+    for (long i = 1; i < static_cast<long>(input.size()); i++)
+        output[i] = window.replace((i - 1) % width, getValue(input, i - offset + width - 1));
+}
+
+// ************************************************************************************** //
+
+// Correctness
+
+static int numTests = 0;
+static int numPassedTests = 0;
+
+void testResult(const std::string& name, bool passed)
+{
+    numTests++;
+    
+    if (passed)
+        numPassedTests++;
+    else
+        std::cout << name << " : - TEST FAILED\n";
+}
+
+void testsCompleted()
+{
+    if (numTests == numPassedTests)
+        std::cout << " ***** ALL TESTS PASSED *****\n";
+    else
+    {
+        std::cout << " ***** TESTS FAILED *****\n";
+        std::cout << numPassedTests << " out of " << numTests << " passed" << "\n";
+    }
+}
+
+bool sameValue(double a, double b)
+{
+    return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+// Compare with sorting each window in full
+
+void filterCorrectness(unsigned long size, long width, unsigned long rank, bool specials)
+{
+    std::vector<double> input = makeInput(size, specials);
+    std::vector<double> output(size), window(width);
+    long offset = width >> 1;
+    bool passed = true;
+    
+    std::string name = " Size " + std::to_string(size) + " width " + std::to_string(width) + " rank " + std::to_string(rank) + (specials ? " specials" : "");
+    
+    slidingRankFilter(output.data(), input, width, rank);
+    
+    for (long i = 0; i < static_cast<long>(size); i++)
+    {
+        for (long j = 0; j < width; j++)
+            window[j] = getValue(input, i - offset + j);
+        
+        sortAscending(window.data(), width);
+        passed = passed && sameValue(output[i], window[rank]);
+    }
+    
+    testResult("Sliding Rank" + name, passed);
+}
+
+// ************************************************************************************** //
+
+// Timing
+
+class Timer
+{
+
+public:
+    
+    Timer() : mStart(0) {}
+    
+    void start()
+    {
+        mStart = mach_absolute_time();
+    };
+    
+    uint64_t stop()
+    {
+        uint64_t end = mach_absolute_time();
+        
+        mach_timebase_info_data_t info;
+        mach_timebase_info(&info);
+        
+        uint64_t elapsed = ((end - mStart) * info.numer) / info.denom;
+        mStart = mach_absolute_time();
+        
+        return elapsed;
+    };
+
+private:
+    
+    uint64_t        mStart;
+};
+
+// Compare the insertion and sliding rank median filters over a spectrum sized frame
+
+void filterTiming(long width)
+{
+    const unsigned long size = 8192;
+    const unsigned long iterations = 32;
+    
+    std::vector<double> input(size), output(size);
+    Timer timer;
+    
+    for (unsigned long i = 0; i < size; i++)
+        input[i] = gen.randDouble();
+    
+    timer.start();
+    for (unsigned long i = 0; i < iterations; i++)
+        insertionFilter(output.data(), input, width);
+    uint64_t insertion = timer.stop();
+    for (unsigned long i = 0; i < iterations; i++)
+        slidingRankFilter(output.data(), input, width, width >> 1);
+    uint64_t sliding = timer.stop();
+    
+    tabbedOut("  Width " + std::to_string(width), to_string_with_precision(insertion / 1000000.0, 2) + " ms insertion " + to_string_with_precision(sliding / 1000000.0, 2) + " ms sliding rank", 20);
+}
+
+// ************************************************************************************** //
+
+int main(int argc, const char * argv[]) {
+    
+    const unsigned long sizes[] = { 1, 2, 7, 100, 1000 };
+    const long widths[] = { 1, 2, 3, 4, 5, 16, 101 };
+    
+    std::cout << "CORRECTNESS TESTS\n\n";
+    
+    for (unsigned long i = 0; i < sizeof(sizes) / sizeof(unsigned long); i++)
+    {
+        for (unsigned long j = 0; j < sizeof(widths) / sizeof(long); j++)
+        {
+            const long width = widths[j];
+            const unsigned long ranks[] = { 0, static_cast<unsigned long>(width >> 2), static_cast<unsigned long>(width >> 1), static_cast<unsigned long>(width - 1) };
+            
+            for (unsigned long k = 0; k < sizeof(ranks) / sizeof(unsigned long); k++)
+            {
+                filterCorrectness(sizes[i], width, ranks[k], false);
+                filterCorrectness(sizes[i], width, ranks[k], true);
+            }
+        }
+    }
+    
+    std::cout << "TIMING TESTS\n\n";
+    std::cout << "Median filter (8192 values x 32)\n";
+    
+    const long timingWidths[] = { 5, 11, 21, 51, 101, 201, 501 };
+    
+    for (unsigned long i = 0; i < sizeof(timingWidths) / sizeof(long); i++)
+        filterTiming(timingWidths[i]);
+    
+    std::cout << "\n";
+    
+    testsCompleted();
+    
+    return 0;
+}
@@ -294,7 +294,67 @@ uintptr_t localAllocTest3(uintptr_t count)
     return count;
 }
 
+// Simulates a block of a spectral patch (chop -> window -> fft -> cartopol -> poltocar -> ifft -> ola)
 
+void spectralPatchFrame(FrameLib_LocalAllocator& allocator, size_t frameSize)
+{
+    size_t fftSize = 1;
+    
+    while (fftSize < frameSize)
+        fftSize <<= 1;
+    
+    size_t specSize = (fftSize >> 1) + 1;
+    
+    void *chop = allocator.alloc(frameSize * sizeof(double));
+    void *window = allocator.alloc(frameSize * sizeof(double));
+    allocator.dealloc(chop);
+    void *fft = allocator.alloc(specSize * sizeof(double) * 2);
+    allocator.dealloc(window);
+    void *polar = allocator.alloc(specSize * sizeof(double) * 2);
+    allocator.dealloc(fft);
+    void *cartesian = allocator.alloc(specSize * sizeof(double) * 2);
+    allocator.dealloc(polar);
+    void *ifft = allocator.alloc(fftSize * sizeof(double));
+    allocator.dealloc(cartesian);
+    allocator.dealloc(ifft);
+}
+
+void spectralPatchBlock(FrameLib_LocalAllocator& allocator, unsigned long numFrames)
+{
+    // Variable length frames from chop
+    
+    for (unsigned long i = 0; i < numFrames; i++)
+        spectralPatchFrame(allocator, 64 + (randu32() % 4032));
+    
+    allocator.prune();
+}
+
+uintptr_t localAllocTest4(uintptr_t count)
+{
+    FrameLib_GlobalAllocator gAllocator(reporter);
+    FrameLib_LocalAllocator allocator(gAllocator);
+    
+    // Warm up with every frame size (so that all the size classes needed are populated) and then check that there is no global allocator traffic in steady state
+    
+    for (size_t i = 64; i < 4096; i++)
+        spectralPatchFrame(allocator, i);
+    
+    allocator.prune();
+    
+    allocator.resetStatistics();
+    
+    for (uintptr_t i = 0; i < count; i++)
+    {
+        spectralPatchBlock(allocator, 8);
+        
+        FrameLib_LocalAllocator::Statistics statistics = allocator.getStatistics();
+        
+        if (statistics.mGlobalAllocs || statistics.mGlobalDeallocs)
+            return i;
+    }
+    
+    return count;
+}
 
 // ************************************************************************************** //
 
@@ -373,6 +433,24 @@ void frameLibLocalAllocTest2(uintptr_t count)
     localallocator.clear();
 }
 
+void frameLibSpectralPatchTest(uintptr_t count)
+{
+    FrameLib_GlobalAllocator gAllocator(reporter);
+    FrameLib_LocalAllocator allocator(gAllocator);
+    
+    for (uintptr_t i = 0; i < count; i++)
+        spectralPatchBlock(allocator, 8);
+    
+    FrameLib_LocalAllocator::Statistics statistics = allocator.getStatistics();
+    FrameLib_GlobalAllocator::CacheStatistics cacheStatistics = gAllocator.getCacheStatistics();
+    
+    tabbedOut("Allocations Per Block ", to_string_with_precision(statistics.mAllocs / (double) count, 2), 35);
+    tabbedOut("Global Allocs Per Block ", to_string_with_precision(statistics.mGlobalAllocs / (double) count, 4), 35);
+    tabbedOut("Global Deallocs Per Block ", to_string_with_precision(statistics.mGlobalDeallocs / (double) count, 4), 35);
+    tabbedOut("Local Hit Rate ", getPercentage(statistics.mHits, statistics.mAllocs), 35);
+    tabbedOut("Global Cache Hit Rate ", to_string_with_precision(100.0 * cacheStatistics.hitRate(), 4, false) + "%", 35);
+    tabbedOut("Retained Memory (KB) ", to_string_with_precision(statistics.mRetainedSize / 1024.0, 1), 35);
+}
 
 // ************************************************************************************** //
 
@@ -389,6 +467,7 @@ int main(int argc, const char * argv[]) {
     runTest("Local Allocator 1", &localAllocTest1, 500);
     runTest("Local Allocator 2", &localAllocTest2, 2000);
     runTest("Local Allocator 3", &localAllocTest3, 2000);
+    runTest("Local Allocator 4", &localAllocTest4, 2000);
     
     std::cout << "TIMING TESTS\n\n";
     
@@ -397,6 +476,10 @@ int main(int argc, const char * argv[]) {
     runTimeCompareTest("Comparison Speed", "malloc 2", "global 2", &mallocAllocTest2, &frameLibGlobalAllocTest2, 200000);
     runTimeCompareTest("Comparison Speed", "malloc 2", "local 2", &mallocAllocTest2, &frameLibLocalAllocTest2, 200000);
     
+    std::cout << "SPECTRAL PATCH\n\n";
+    
+    frameLibSpectralPatchTest(10000);
+    std::cout << "\n";
 
     testsCompleted();
     
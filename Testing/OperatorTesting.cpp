@@ -0,0 +1,349 @@
+
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <vector>
+#include "FrameLib_Unary_Objects.h"
+#include "FrameLib_Binary_Objects.h"
+#include "FrameLib_RandGen.h"
+
+// ************************************************************************************** //
+
+// Random Numbers
+
+FrameLib_RandGen gen;
+
+// Values are mostly random, with a proportion of special values (for checking NaN / infinity / signed zero handling)
+
+double randValue()
+{
+    const double specials[] = { 0.0, -0.0, 1.0, -1.0, 0.5, -0.5, std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN() };
+
+    if (gen.randInt(16) == 0)
+        return specials[gen.randInt(static_cast<uint32_t>(sizeof(specials) / sizeof(double)) - 1)];
+
+    return gen.randDouble(-8.0, 8.0);
+}
+
+// ************************************************************************************** //
+
+// Output
+
+void tabbedOut(const std::string& name, const std::string& text, int tab = 25)
+{
+    std::cout << std::setw(tab) << std::setfill(' ');
+    std::cout.setf(std::ios::left);
+    std::cout.unsetf(std::ios::right);
+    std::cout << name;
+    std::cout.unsetf(std::ios::left);
+    std::cout << text << "\n";
+}
+
+template <typename T>
+std::string to_string_with_precision(const T a_value, const int n = 4, bool fixed = true)
+{
+    std::ostringstream out;
+    if (fixed)
+        out << std::setprecision(n) << std::fixed << a_value;
+    else
+        out << std::setprecision(n) << a_value;
+    return out.str();
+}
+
+// ************************************************************************************** //
+
+// Correctness
+
+static int numTests = 0;
+static int numPassedTests = 0;
+
+void testResult(const std::string& name, bool passed)
+{
+    numTests++;
+
+    if (passed)
+        numPassedTests++;
+    else
+        std::cout << name << " : - TEST FAILED\n";
+}
+
+void testsCompleted()
+{
+    if (numTests == numPassedTests)
+        std::cout << " ***** ALL TESTS PASSED *****\n";
+    else
+    {
+        std::cout << " ***** TESTS FAILED *****\n";
+        std::cout << numPassedTests << " out of " << numTests << " passed" << "\n";
+    }
+}
+
+// N.B. signed zeros are treated as equal (the vector min / max may differ in sign from fmin / fmax for zeros)
+
+bool identical(const std::vector<double>& a, const std::vector<double>& b)
+{
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        if (a[i] != b[i] && !(std::isnan(a[i]) && std::isnan(b[i])))
+            return false;
+    }
+
+    return true;
+}
+
+double ulpError(double a, double b)
+{
+    if (a == b || (std::isnan(a) && std::isnan(b)))
+        return 0.0;
+
+    if (std::isnan(a) || std::isnan(b) || std::isinf(a) || std::isinf(b))
+        return std::numeric_limits<double>::infinity();
+
+    double ulp = std::nextafter(std::fabs(b), std::numeric_limits<double>::infinity()) - std::fabs(b);
+
+    return std::fabs(a - b) / ulp;
+}
+
+// Compare the vector kernels against the scalar loops for all sizes up to 67 (covering all remainders)
+
+template <typename Op>
+void unaryCorrectness(const std::string& name)
+{
+    bool passed = true;
+
+    for (unsigned long size = 0; size < 68; size++)
+    {
+        std::vector<double> input(size), output1(size), output2(size);
+
+        for (auto it = input.begin(); it != input.end(); it++)
+            *it = randValue();
+
+        FrameLib_SIMD_Ops::Kernels<Op, false>::unary(output1.data(), input.data(), size);
+        FrameLib_SIMD_Ops::unary<Op>(output2.data(), input.data(), size);
+
+        // In place
+
+        FrameLib_SIMD_Ops::unary<Op>(input.data(), input.data(), size);
+
+        passed = passed && identical(output1, output2) && identical(output1, input);
+    }
+
+    testResult(name, passed);
+}
+
+template <typename Op>
+void binaryCorrectness(const std::string& name)
+{
+    bool passed = true;
+
+    for (unsigned long size = 0; size < 68; size++)
+    {
+        std::vector<double> input1(size), input2(size), output1(size), output2(size);
+        double value = randValue();
+
+        for (unsigned long i = 0; i < size; i++)
+        {
+            input1[i] = randValue();
+            input2[i] = randValue();
+        }
+
+        FrameLib_SIMD_Ops::Kernels<Op, false>::binary(output1.data(), input1.data(), input2.data(), size);
+        FrameLib_SIMD_Ops::binary<Op>(output2.data(), input1.data(), input2.data(), size);
+        passed = passed && identical(output1, output2);
+
+        FrameLib_SIMD_Ops::Kernels<Op, false>::binary(output1.data(), input1.data(), value, size);
+        FrameLib_SIMD_Ops::binary<Op>(output2.data(), input1.data(), value, size);
+        passed = passed && identical(output1, output2);
+
+        FrameLib_SIMD_Ops::Kernels<Op, false>::binary(output1.data(), value, input2.data(), size);
+        FrameLib_SIMD_Ops::binary<Op>(output2.data(), value, input2.data(), size);
+        passed = passed && identical(output1, output2);
+    }
+
+    testResult(name, passed);
+}
+
+// Approximations are checked for their maximum error (in ulps) against the standard library
+
+template <double func(double)>
+void approximationAccuracy(const std::string& name, double lo, double hi, double maxUlps)
+{
+    typedef Unary_Functor<func> Op;
+
+    const unsigned long size = 100000;
+    std::vector<double> input(size), output1(size), output2(size);
+    double error = 0.0;
+
+    for (unsigned long i = 0; i < size; i++)
+        input[i] = gen.randDouble(lo, hi);
+
+    FrameLib_SIMD_Ops::Kernels<Op, false>::unary(output1.data(), input.data(), size);
+    FrameLib_SIMD_Ops::unary<Op>(output2.data(), input.data(), size);
+
+    for (unsigned long i = 0; i < size; i++)
+        error = std::max(error, ulpError(output2[i], output1[i]));
+
+    tabbedOut(name + " Max Error ", to_string_with_precision(error, 2) + " ulps", 35);
+    testResult(name, error <= maxUlps);
+}
+
+// ************************************************************************************** //
+
+// Timing
+
+class Timer
+{
+
+public:
+
+    Timer() : mStart(0) {}
+
+    void start()
+    {
+        mStart = mach_absolute_time();
+    };
+
+    uint64_t stop()
+    {
+        uint64_t end = mach_absolute_time();
+
+        mach_timebase_info_data_t info;
+        mach_timebase_info(&info);
+
+        uint64_t elapsed = ((end - mStart) * info.numer) / info.denom;
+        mStart = mach_absolute_time();
+
+        return elapsed;
+    };
+
+private:
+
+    uint64_t        mStart;
+};
+
+// Each size processes the same total number of elements so that the times are comparable
+
+static const unsigned long totalElements = 1 << 24;
+
+template <typename Op>
+void unaryTiming(const std::string& name)
+{
+    std::cout << name << "\n";
+
+    for (unsigned long size = 64; size <= 16384; size *= 4)
+    {
+        std::vector<double> input(size), output(size);
+        Timer timer;
+
+        for (auto it = input.begin(); it != input.end(); it++)
+            *it = gen.randDouble(0.1, 8.0);
+
+        timer.start();
+        for (unsigned long i = 0; i < totalElements / size; i++)
+            FrameLib_SIMD_Ops::Kernels<Op, false>::unary(output.data(), input.data(), size);
+        uint64_t scalar = timer.stop();
+        for (unsigned long i = 0; i < totalElements / size; i++)
+            FrameLib_SIMD_Ops::unary<Op>(output.data(), input.data(), size);
+        uint64_t vector = timer.stop();
+
+        tabbedOut("  Size " + std::to_string(size), to_string_with_precision(scalar / 1000000.0, 2) + " ms scalar " + to_string_with_precision(vector / 1000000.0, 2) + " ms vector " + to_string_with_precision((double) scalar / (double) vector, 2) + "x", 15);
+    }
+}
+
+template <typename Op>
+void binaryTiming(const std::string& name)
+{
+    std::cout << name << "\n";
+
+    for (unsigned long size = 64; size <= 16384; size *= 4)
+    {
+        std::vector<double> input1(size), input2(size), output(size);
+        Timer timer;
+
+        for (unsigned long i = 0; i < size; i++)
+        {
+            input1[i] = gen.randDouble(0.1, 8.0);
+            input2[i] = gen.randDouble(0.1, 8.0);
+        }
+
+        timer.start();
+        for (unsigned long i = 0; i < totalElements / size; i++)
+            FrameLib_SIMD_Ops::Kernels<Op, false>::binary(output.data(), input1.data(), input2.data(), size);
+        uint64_t scalar = timer.stop();
+        for (unsigned long i = 0; i < totalElements / size; i++)
+            FrameLib_SIMD_Ops::binary<Op>(output.data(), input1.data(), input2.data(), size);
+        uint64_t vector = timer.stop();
+
+        tabbedOut("  Size " + std::to_string(size), to_string_with_precision(scalar / 1000000.0, 2) + " ms scalar " + to_string_with_precision(vector / 1000000.0, 2) + " ms vector " + to_string_with_precision((double) scalar / (double) vector, 2) + "x", 15);
+    }
+}
+
+// ************************************************************************************** //
+
+int main(int argc, const char * argv[]) {
+
+    std::cout << "CORRECTNESS TESTS\n\n";
+
+    binaryCorrectness<std::plus<double>>("Plus");
+    binaryCorrectness<std::minus<double>>("Minus");
+    binaryCorrectness<std::multiplies<double>>("Multiply");
+    binaryCorrectness<std::divides<double>>("Divide");
+    binaryCorrectness<std::equal_to<double>>("Equal");
+    binaryCorrectness<std::not_equal_to<double>>("Not Equal");
+    binaryCorrectness<std::greater<double>>("Greater Than");
+    binaryCorrectness<std::less<double>>("Less Than");
+    binaryCorrectness<std::greater_equal<double>>("Greater Than Equal");
+    binaryCorrectness<std::less_equal<double>>("Less Than Equal");
+    binaryCorrectness<std::logical_and<double>>("Logical And");
+    binaryCorrectness<std::logical_or<double>>("Logical Or");
+    binaryCorrectness<FrameLib_Binary_Ops::absDiff>("Diff");
+    binaryCorrectness<Binary_Functor<fmin>>("Min");
+    binaryCorrectness<Binary_Functor<fmax>>("Max");
+
+    unaryCorrectness<std::logical_not<double>>("Logical Not");
+    unaryCorrectness<Unary_Functor<fabs>>("Abs");
+    unaryCorrectness<Unary_Functor<sqrt>>("Sqrt");
+    unaryCorrectness<Unary_Functor<trunc>>("Trunc");
+    unaryCorrectness<Unary_Functor<floor>>("Floor");
+    unaryCorrectness<Unary_Functor<ceil>>("Ceil");
+
+#ifdef FRAMELIB_SIMD_APPROXIMATIONS
+    approximationAccuracy<exp>("Exp", -745.0, 709.0, 4.0);
+    approximationAccuracy<exp2>("Exp2", -1074.0, 1023.0, 4.0);
+    approximationAccuracy<log>("Log", 1e-320, 1e300, 4.0);
+    approximationAccuracy<log>("Log (Near One)", 0.5, 2.0, 4.0);
+    approximationAccuracy<log2>("Log2", 1e-300, 1e300, 4.0);
+    approximationAccuracy<log10>("Log10", 1e-300, 1e300, 4.0);
+    approximationAccuracy<sin>("Sin", -1000.0, 1000.0, 4.0);
+    approximationAccuracy<cos>("Cos", -1000.0, 1000.0, 4.0);
+#endif
+
+    std::cout << "\nTIMING TESTS\n\n";
+
+    binaryTiming<std::plus<double>>("Plus");
+    binaryTiming<std::multiplies<double>>("Multiply");
+    binaryTiming<std::divides<double>>("Divide");
+    binaryTiming<std::greater<double>>("Greater Than");
+    binaryTiming<std::logical_and<double>>("Logical And");
+    binaryTiming<FrameLib_Binary_Ops::absDiff>("Diff");
+    binaryTiming<Binary_Functor<fmin>>("Min");
+    binaryTiming<Binary_Functor<pow>>("Pow (scalar only)");
+
+    unaryTiming<Unary_Functor<fabs>>("Abs");
+    unaryTiming<Unary_Functor<sqrt>>("Sqrt");
+    unaryTiming<Unary_Functor<floor>>("Floor");
+    unaryTiming<Unary_Functor<exp>>("Exp");
+    unaryTiming<Unary_Functor<log>>("Log");
+    unaryTiming<Unary_Functor<sin>>("Sin");
+    unaryTiming<Unary_Functor<cos>>("Cos");
+
+    std::cout << "\n";
+
+    testsCompleted();
+
+    return 0;
+}
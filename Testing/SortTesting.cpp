@@ -0,0 +1,409 @@
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "FrameLib_RandGen.h"
+#include "FrameLib_Sort_Functions.h"
+
+// ************************************************************************************** //
+
+// Random Numbers
+
+FrameLib_RandGen gen;
+
+// ************************************************************************************** //
+
+// Output
+
+void tabbedOut(const std::string& name, const std::string& text, int tab = 25)
+{
+    std::cout << std::setw(tab) << std::setfill(' ');
+    std::cout.setf(std::ios::left);
+    std::cout.unsetf(std::ios::right);
+    std::cout << name;
+    std::cout.unsetf(std::ios::left);
+    std::cout << text << "\n";
+}
+
+template <typename T>
+std::string to_string_with_precision(const T a_value, const int n = 4, bool fixed = true)
+{
+    std::ostringstream out;
+    if (fixed)
+        out << std::setprecision(n) << std::fixed << a_value;
+    else
+        out << std::setprecision(n) << a_value;
+    return out.str();
+}
+
+// ************************************************************************************** //
+
+// Input Distributions
+
+enum Distribution { kRandom, kNearlySorted, kDuplicates, kReversed, kSpecial };
+
+std::string distributionName(Distribution distribution)
+{
+    switch (distribution)
+    {
+        case kRandom:           return "random";
+        case kNearlySorted:     return "nearly sorted";
+        case kDuplicates:       return "duplicates";
+        case kReversed:         return "reversed";
+        case kSpecial:          return "nans / zeros";
+    }
+    
+    return "";
+}
+
+std::vector<double> makeInput(unsigned long size, Distribution distribution)
+{
+    std::vector<double> input(size);
+    
+    for (unsigned long i = 0; i < size; i++)
+    {
+        switch (distribution)
+        {
+            case kRandom:           input[i] = gen.randDouble(-1.0, 1.0);                               break;
+            case kNearlySorted:     input[i] = static_cast<double>(i) + gen.randDouble(-4.0, 4.0);      break;
+            case kDuplicates:       input[i] = static_cast<double>(gen.randInt(16));                    break;
+            case kReversed:         input[i] = -static_cast<double>(i);                                 break;
+            
+            case kSpecial:
+            {
+                const double specials[] = { std::numeric_limits<double>::quiet_NaN(), -std::numeric_limits<double>::quiet_NaN(), 0.0, -0.0, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() };
+                
+                input[i] = gen.randInt(4) ? gen.randDouble(-1.0, 1.0) : specials[gen.randInt(5)];
+                break;
+            }
+        }
+    }
+    
+    return input;
+}
+
+// ************************************************************************************** //
+
+// Comb sort (the previous implementation) for timing comparisons
+
+template <typename Compare, class T> void combSort(T *data, unsigned long size)
+{
+    bool swaps = true;
+    unsigned long gap = size;
+    unsigned long i;
+    
+    while (gap > 1 || swaps)
+    {
+        gap = (gap > 1) ? (gap * 10) / 13 : gap;
+        gap = (gap == 9 || gap == 10) ? 11 : gap;
+        gap = !gap ? 1 : gap;
+        
+        for (i = 0, swaps = false; i + gap < size; i++)
+        {
+            if (Compare()(data[i], data[i + gap]))
+            {
+                std::swap(data[i], data[i + gap]);
+                swaps = true;
+            }
+        }
+    }
+}
+
+// ************************************************************************************** //
+
+// Correctness
+
+static int numTests = 0;
+static int numPassedTests = 0;
+
+void testResult(const std::string& name, bool passed)
+{
+    numTests++;
+    
+    if (passed)
+        numPassedTests++;
+    else
+        std::cout << name << " : - TEST FAILED\n";
+}
+
+void testsCompleted()
+{
+    if (numTests == numPassedTests)
+        std::cout << " ***** ALL TESTS PASSED *****\n";
+    else
+    {
+        std::cout << " ***** TESTS FAILED *****\n";
+        std::cout << numPassedTests << " out of " << numTests << " passed" << "\n";
+    }
+}
+
+// Reference orderings (NaNs above all other values and -0.0 equal to 0.0)
+
+bool referenceLess(double a, double b)
+{
+    return (a < b || (std::isnan(b) && !std::isnan(a)));
+}
+
+bool sameValue(double a, double b)
+{
+    return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+bool matchesReference(const std::vector<double>& result, const std::vector<double>& reference)
+{
+    for (unsigned long i = 0; i < reference.size(); i++)
+        if (!sameValue(result[i], reference[i]))
+            return false;
+    
+    return true;
+}
+
+// Compare all sorts with a stable sort using the reference ordering (index sorts must match exactly)
+
+void sortCorrectness(unsigned long size, Distribution distribution)
+{
+    std::vector<double> input = makeInput(size, distribution);
+    std::vector<double> ascending(input), descending(input), output(size), temp(sortTempSize<double>(size));
+    std::vector<unsigned long> ascendingIndices(size), descendingIndices(size), indices(size), tempIndices(sortIndicesTempSize<double>(size));
+    
+    std::string name = " Size " + std::to_string(size) + " " + distributionName(distribution);
+    
+    for (unsigned long i = 0; i < size; i++)
+        ascendingIndices[i] = descendingIndices[i] = i;
+    
+    std::stable_sort(ascending.begin(), ascending.end(), referenceLess);
+    std::stable_sort(descending.begin(), descending.end(), [](double a, double b) { return referenceLess(b, a); });
+    std::stable_sort(ascendingIndices.begin(), ascendingIndices.end(), [&](unsigned long a, unsigned long b) { return referenceLess(input[a], input[b]); });
+    std::stable_sort(descendingIndices.begin(), descendingIndices.end(), [&](unsigned long a, unsigned long b) { return referenceLess(input[b], input[a]); });
+    
+    // Values
+    
+    output = input;
+    sortAscending(output.data(), size);
+    testResult("Sort Ascending In Place" + name, matchesReference(output, ascending));
+    
+    output = input;
+    sortDescending(output.data(), size);
+    testResult("Sort Descending In Place" + name, matchesReference(output, descending));
+    
+    sortAscending(output.data(), input.data(), size, temp.data());
+    testResult("Sort Ascending" + name, matchesReference(output, ascending));
+    
+    sortDescending(output.data(), input.data(), size, temp.data());
+    testResult("Sort Descending" + name, matchesReference(output, descending));
+    
+    output = input;
+    sortAscending(output.data(), output.data(), size, temp.data());
+    testResult("Sort Ascending Aliased" + name, matchesReference(output, ascending));
+    
+    // Indices
+    
+    sortIndicesAscending(indices.data(), input.data(), size);
+    testResult("Sort Indices Ascending" + name, indices == ascendingIndices);
+    
+    sortIndicesDescending(indices.data(), input.data(), size);
+    testResult("Sort Indices Descending" + name, indices == descendingIndices);
+    
+    sortIndicesAscending(indices.data(), input.data(), size, tempIndices.data());
+    testResult("Sort Indices Ascending Radix" + name, indices == ascendingIndices);
+    
+    sortIndicesDescending(indices.data(), input.data(), size, tempIndices.data());
+    testResult("Sort Indices Descending Radix" + name, indices == descendingIndices);
+}
+
+// Compare selection at several positions with the reference sort
+
+void selectCorrectness(unsigned long size, Distribution distribution)
+{
+    std::vector<double> input = makeInput(size, distribution);
+    std::vector<double> ascending(input), output(input);
+    std::vector<unsigned long> positions;
+    
+    std::string name = " Size " + std::to_string(size) + " " + distributionName(distribution);
+    
+    std::stable_sort(ascending.begin(), ascending.end(), referenceLess);
+    
+    for (unsigned long i = 0; i < 5 && size; i++)
+        positions.push_back(((size - 1) * i) / 4);
+    
+    selectAscending(output.data(), size, positions.data(), static_cast<unsigned long>(positions.size()));
+    
+    bool passed = true;
+    
+    for (unsigned long i = 0; i < positions.size(); i++)
+    {
+        unsigned long position = positions[i];
+        passed = passed && sameValue(output[position], ascending[position]);
+        
+        // Values either side must be correctly partitioned
+        
+        for (unsigned long j = 0; j < position; j++)
+            passed = passed && !referenceLess(output[position], output[j]);
+        for (unsigned long j = position + 1; j < size; j++)
+            passed = passed && !referenceLess(output[j], output[position]);
+    }
+    
+    testResult("Select Ascending" + name, passed);
+}
+
+// ************************************************************************************** //
+
+// Timing
+
+class Timer
+{
+
+public:
+    
+    Timer() : mStart(0) {}
+    
+    void start()
+    {
+        mStart = mach_absolute_time();
+    };
+    
+    uint64_t stop()
+    {
+        uint64_t end = mach_absolute_time();
+        
+        mach_timebase_info_data_t info;
+        mach_timebase_info(&info);
+        
+        uint64_t elapsed = ((end - mStart) * info.numer) / info.denom;
+        mStart = mach_absolute_time();
+        
+        return elapsed;
+    };
+
+private:
+    
+    uint64_t        mStart;
+};
+
+// Each size sorts the same total number of values so that the times are comparable
+
+static const unsigned long totalValues = 1 << 22;
+
+// Inputs are cycled so that the branch predictor cannot learn the data (which flatters comparison sorts at small sizes)
+
+static const unsigned long numInputs = 32;
+
+// Compare comb sort, introsort and radix sort for values and the index sorts
+
+void sortTiming(unsigned long size, Distribution distribution)
+{
+    std::vector<double> inputs[numInputs];
+    std::vector<double> output(size), temp(FrameLib_Sorting::radixTempSize<double, double>(size));
+    std::vector<unsigned long> indices(size), tempIndices(FrameLib_Sorting::radixTempSize<double, unsigned long>(size));
+    Timer timer;
+    
+    unsigned long iterations = totalValues / size;
+    
+    for (unsigned long i = 0; i < numInputs; i++)
+        inputs[i] = makeInput(size, distribution);
+    
+    auto input = [&](unsigned long i) { return inputs[i % numInputs].data(); };
+    
+    timer.start();
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        std::copy(input(i), input(i) + size, output.begin());
+        combSort<std::greater<double>>(output.data(), size);
+    }
+    uint64_t comb = timer.stop();
+    for (unsigned long i = 0; i < iterations; i++)
+        sortAscending(output.data(), input(i), size);
+    uint64_t intro = timer.stop();
+    for (unsigned long i = 0; i < iterations; i++)
+        FrameLib_Sorting::radixSort(output.data(), input(i), temp.data(), size, false);
+    uint64_t radix = timer.stop();
+    for (unsigned long i = 0; i < iterations; i++)
+        sortIndicesAscending(indices.data(), input(i), size);
+    uint64_t introIndices = timer.stop();
+    for (unsigned long i = 0; i < iterations; i++)
+        FrameLib_Sorting::radixSortIndices(indices.data(), input(i), tempIndices.data(), size, false);
+    uint64_t radixIndices = timer.stop();
+    
+    tabbedOut("  Size " + std::to_string(size) + " " + distributionName(distribution), to_string_with_precision(comb / 1000000.0, 2) + " ms comb " + to_string_with_precision(intro / 1000000.0, 2) + " ms intro " + to_string_with_precision(radix / 1000000.0, 2) + " ms radix | indices " + to_string_with_precision(introIndices / 1000000.0, 2) + " ms intro " + to_string_with_precision(radixIndices / 1000000.0, 2) + " ms radix", 30);
+}
+
+// Compare selection of the median and quartiles with a full sort
+
+void selectTiming(unsigned long size, Distribution distribution)
+{
+    std::vector<double> inputs[numInputs];
+    std::vector<double> output(size);
+    const unsigned long positions[] = { (size - 1) / 4, (size - 1) / 2, (3 * (size - 1)) / 4 };
+    Timer timer;
+    
+    unsigned long iterations = totalValues / size;
+    
+    for (unsigned long i = 0; i < numInputs; i++)
+        inputs[i] = makeInput(size, distribution);
+    
+    auto input = [&](unsigned long i) { return inputs[i % numInputs].data(); };
+    
+    timer.start();
+    for (unsigned long i = 0; i < iterations; i++)
+        sortAscending(output.data(), input(i), size);
+    uint64_t sort = timer.stop();
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        std::copy(input(i), input(i) + size, output.begin());
+        selectAscending(output.data(), size, positions[1]);
+    }
+    uint64_t median = timer.stop();
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        std::copy(input(i), input(i) + size, output.begin());
+        selectAscending(output.data(), size, positions, 3);
+    }
+    uint64_t quartiles = timer.stop();
+    
+    tabbedOut("  Size " + std::to_string(size) + " " + distributionName(distribution), to_string_with_precision(sort / 1000000.0, 2) + " ms sort " + to_string_with_precision(median / 1000000.0, 2) + " ms select median " + to_string_with_precision(quartiles / 1000000.0, 2) + " ms select quartiles", 30);
+}
+
+// ************************************************************************************** //
+
+int main(int argc, const char * argv[]) {
+    
+    const unsigned long sizes[] = { 0, 1, 2, 3, 15, 16, 17, 100, 511, 512, 513, 1023, 1024, 4096, 65536 };
+    const Distribution distributions[] = { kRandom, kNearlySorted, kDuplicates, kReversed, kSpecial };
+    
+    std::cout << "CORRECTNESS TESTS\n\n";
+    
+    for (unsigned long i = 0; i < sizeof(sizes) / sizeof(unsigned long); i++)
+        for (unsigned long j = 0; j < sizeof(distributions) / sizeof(Distribution); j++)
+        {
+            sortCorrectness(sizes[i], distributions[j]);
+            selectCorrectness(sizes[i], distributions[j]);
+        }
+    
+    std::cout << "TIMING TESTS\n\n";
+    
+    for (unsigned long j = 0; j < sizeof(distributions) / sizeof(Distribution); j++)
+    {
+        std::cout << "Sort (" << distributionName(distributions[j]) << ")\n";
+        
+        for (unsigned long size = 64; size <= 65536; size *= 4)
+            sortTiming(size, distributions[j]);
+    }
+    
+    for (unsigned long j = 0; j < sizeof(distributions) / sizeof(Distribution); j++)
+    {
+        std::cout << "Select (" << distributionName(distributions[j]) << ")\n";
+        
+        for (unsigned long size = 64; size <= 65536; size *= 4)
+            selectTiming(size, distributions[j]);
+    }
+    
+    std::cout << "\n";
+    
+    testsCompleted();
+    
+    return 0;
+}